@@ -20,6 +20,113 @@ along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/Data.h>
 #include <core/Util.h>
 #include <core/BlasExtra.h>
+#include <map>
+#include <set>
+#include <mutex>
+
+//-------- Memory pool to reduce system alloc/free calls ---------
+
+namespace MemPool
+{
+	//Pool memory allocations (falls back to fftw_malloc/fftw_free when the pool is disabled or exhausted)
+	class MemPool
+	{	uint8_t* pool; //pointer to entire pool of memory (allocated once)
+		std::mutex lock; //for thread safety
+		//Allocated memory
+		std::map<size_t,size_t> used; //start -> stop
+		//Available 'holes' in memory:
+		std::map<size_t,size_t> holes; //start -> stop
+		std::map<size_t,std::set<size_t>> holesBySize; //size -> set of starts
+		//--- helper functions for managing holes
+		typedef std::map<size_t,size_t>::iterator MapIter;
+		typedef std::map<size_t,std::set<size_t>>::iterator MapSetIter;
+		inline void addHole(size_t start, size_t size)
+		{	size_t startEff = start;
+			size_t stopEff = start+size;
+			MapIter ubound = holes.upper_bound(start); //iterator to hole after start
+			MapIter lbound = ubound; if(lbound!=holes.begin()) lbound--; //iterator to hole before start
+			//Check for contiguous hole before:
+			if((lbound!=holes.end()) && (lbound->second==startEff))
+			{	startEff = lbound->first; //absorb into new hole
+				removeHole(lbound->first, &lbound); //remove old hole
+			}
+			//Check for contiguous hole after:
+			if((ubound!=holes.end()) && (ubound->first==stopEff))
+			{	stopEff = ubound->second; //absorb into new hole
+				removeHole(ubound->first, &ubound); //remove old hole
+			}
+			//Add new hole:
+			holes[startEff] = stopEff;
+			holesBySize[stopEff-startEff].insert(startEff);
+		}
+		inline void removeHole(size_t start, MapIter* holesPtr=0, MapSetIter* holesBySizePtr=0)
+		{	//Remove from holes:
+			MapIter holesIter = holesPtr ? *holesPtr : holes.find(start);
+			assert((holesIter!=holes.end()) && (holesIter->first==start));
+			size_t size = holesIter->second - start;
+			holes.erase(holesIter);
+			//Remove from holesBySize:
+			MapSetIter holesBySizeIter = holesBySizePtr ? *holesBySizePtr : holesBySize.find(size);
+			assert((holesBySizeIter!=holesBySize.end()) && (holesBySizeIter->first==size));
+			holesBySizeIter->second.erase(start);
+			if(!holesBySizeIter->second.size()) //no more holes of this size
+				holesBySize.erase(holesBySizeIter);
+		}
+		static void* allocExternal(size_t size)
+		{	void* ptr = fftw_malloc(size);
+			if(!ptr) die("Memory allocation failed (out of memory)\n");
+			return ptr;
+		}
+	public:
+		MemPool() : pool(0)
+		{	if(mempoolSize)
+			{	pool = (uint8_t*)allocExternal(mempoolSize);
+				addHole(0, mempoolSize);
+			}
+		}
+		~MemPool()
+		{	if(pool) fftw_free(pool);
+		}
+		void* alloc(size_t sizeRequested)
+		{	if(!pool) return allocExternal(sizeRequested); //pool not in use
+			std::lock_guard<std::mutex> guard(lock);
+			//Find size adjusted to chunk size:
+			const size_t chunkSize = 64; //cache line (grids are small in 1D, so page granularity would waste the pool)
+			const size_t chunkMask = chunkSize - 1;
+			size_t size = (sizeRequested + chunkMask) & (~chunkMask); //round up to multiple of chunkSize
+			//Find hole just big enough to fit it:
+			MapSetIter ubound = holesBySize.lower_bound(size);
+			if(ubound == holesBySize.end())
+				return allocExternal(sizeRequested); //No hole big enough left, so allocate externally
+			//Hole found, so allocate from it:
+			size_t start = *(ubound->second.begin());
+			size_t holeSize = ubound->first;
+			used[start] = start+size; //mark allocated range
+			removeHole(start, 0, &ubound); //remove old hole
+			if(holeSize > size) addHole(start+size, holeSize-size); //add hole left behind (if any)
+			return (void*)(pool+start);
+		}
+		void free(void* ptr)
+		{	if(!pool) return fftw_free(ptr); //pool not in use
+			std::lock_guard<std::mutex> guard(lock);
+			//Find in used map:
+			MapIter usedIter = (ptr>=pool && ptr<pool+mempoolSize) ? used.find(((uint8_t*)ptr) - pool) : used.end();
+			if(usedIter == used.end())
+				fftw_free(ptr); //Not found in used => allocated externally
+			else
+			{	//Found in used => allocated in pool
+				size_t start = usedIter->first;
+				size_t size = usedIter->second - start;
+				used.erase(usedIter); //remove from used
+				addHole(start, size); //add corresponding hole
+			}
+		}
+	};
+	
+	//Pool accessor function (to avoid file-level static variables):
+	MemPool& CPU() { static MemPool pool; return pool; }
+}
+
 
 //-------- class ManagedMemory --------------
 
@@ -69,7 +176,7 @@ ManagedMemory::~ManagedMemory()
 }
 void ManagedMemory::memFree()
 {	if(!nElements) return; //nothing to free
-	fftw_free(pData);
+	MemPool::CPU().free(pData);
 	pData = 0;
 	nElements = 0;
 }
@@ -78,9 +185,7 @@ void ManagedMemory::memInit(size_t nElem)
 	memFree();
 	nElements = nElem;
 	if(nElements)
-	{	pData = (double*)fftw_malloc(sizeof(double)*nElements);
-		if(!pData) assert(!"Memory allocation failed (out of memory)\n");
-	}
+		pData = (double*)MemPool::CPU().alloc(sizeof(double)*nElements);
 }
 void ManagedMemory::memMove(ManagedMemory&& other)
 {	std::swap(nElements, other.nElements);
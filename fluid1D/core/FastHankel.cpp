@@ -0,0 +1,186 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of Fluid1D.
+
+Fluid1D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fluid1D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <core/FastHankel.h>
+#include <core/BlasExtra.h>
+#include <core/Util.h>
+#include <gsl/gsl_sf.h>
+
+//Element of matI, matID or matIDD (see GridInfo)
+inline double besselKernel(int nDeriv, double G, double r)
+{	double Gr = G * r;
+	switch(nDeriv)
+	{	case 0: return gsl_sf_bessel_j0(Gr);
+		case 1: return -G * gsl_sf_bessel_j1(Gr);
+		default: return pow(G,2) * gsl_sf_bessel_j2(Gr);
+	}
+}
+
+//Oversampled grid size for the non-uniform FFTs (at least twice the 2(S+1) modes, with small prime factors)
+inline int nufftGridSize(int S)
+{	int M = 4*(S+1);
+	while(!fftSuitable(M)) M++;
+	return M;
+}
+
+//Gaussian spreading half-width required for relative tolerance tol at oversampling ratio R (Greengard and Lee, 2004)
+inline int nufftSpreadWidth(double tol, double R)
+{	return std::max(2, int(ceil(-log(tol) * (R-0.5) / (M_PI*(R-1)))));
+}
+
+FastHankel::FastHankel(const std::vector<double>& r, const std::vector<double>& G, double tol)
+: S(r.size()), M(nufftGridSize(S)), nSpread(nufftSpreadWidth(tol, M/(2.*(S+1)))),
+	nNear(std::min(S, int(ceil(sqrt(S/M_PI))))), r(r), G(G), theta(S)
+{
+	assert(G.size() == r.size());
+	//Phases of the basis functions on the uniform radial grid:
+	double h = r[0];
+	for(int j=0; j<S; j++) assert(fabs(r[j] - (j+1)*h) < 1e-8*r[j]); //grid must be uniform
+	for(int i=0; i<S; i++) theta[i] = G[i] * h;
+	
+	//Gaussian spreading weights:
+	int N = 2*(S+1); //number of modes
+	double R = M/double(N); //oversampling ratio
+	tau = M_PI*nSpread / (N*N*R*(R-0.5));
+	spreadStart.resize(S);
+	spreadWeight.resize(S*2*nSpread);
+	for(int i=0; i<S; i++)
+	{	spreadStart[i] = int(floor(theta[i]*M/(2*M_PI))) - nSpread + 1;
+		double* w = spreadWeight.data() + i*2*nSpread;
+		for(int l=0; l<2*nSpread; l++)
+			w[l] = exp(-pow(theta[i] - (2*M_PI/M)*(spreadStart[i]+l), 2) / (4*tau));
+	}
+	deconvolve.resize(S);
+	for(int j=0; j<S; j++)
+		deconvolve[j] = sqrt(M_PI/tau) * exp(pow(j+1,2)*tau) / M;
+	
+	//Dense strips for the smallest r and G:
+	for(int nDeriv=0; nDeriv<3; nDeriv++)
+	{	rowStrip[nDeriv].resize(nNear*S);
+		colStrip[nDeriv].resize(nNear*S);
+		for(int j=0; j<nNear; j++) for(int i=0; i<S; i++)
+			rowStrip[nDeriv][j*S+i] = besselKernel(nDeriv, G[i], r[j]);
+		for(int i=0; i<nNear; i++) for(int j=0; j<S; j++)
+			colStrip[nDeriv][i*S+j] = besselKernel(nDeriv, G[i], r[j]);
+	}
+	
+	//FFT plan:
+	fftw_complex* buf = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*M);
+	plan = fftw_plan_dft_1d(M, buf, buf, FFTW_BACKWARD, FFTW_MEASURE);
+	fftw_free(buf);
+}
+
+FastHankel::~FastHankel()
+{	fftw_destroy_plan(plan);
+}
+
+void FastHankel::nufft1(const double* z, complex* F) const
+{	complex* buf = (complex*)fftw_malloc(sizeof(complex)*M);
+	for(int m=0; m<M; m++) buf[m] = 0.;
+	//Spread onto oversampled grid:
+	for(int i=nNear; i<S; i++)
+	{	const double* w = spreadWeight.data() + i*2*nSpread;
+		for(int l=0; l<2*nSpread; l++)
+			buf[(spreadStart[i]+l+M) % M] += z[i] * w[l];
+	}
+	fftw_execute_dft(plan, (fftw_complex*)buf, (fftw_complex*)buf);
+	//Deconvolve:
+	for(int j=0; j<S; j++)
+		F[j] = buf[j+1] * deconvolve[j];
+	fftw_free(buf);
+}
+
+void FastHankel::nufft2(const double* u, complex* T) const
+{	complex* buf = (complex*)fftw_malloc(sizeof(complex)*M);
+	for(int m=0; m<M; m++) buf[m] = 0.;
+	//Pre-deconvolve:
+	for(int j=nNear; j<S; j++)
+		buf[j+1] = u[j] * deconvolve[j];
+	fftw_execute_dft(plan, (fftw_complex*)buf, (fftw_complex*)buf);
+	//Interpolate from oversampled grid:
+	for(int i=nNear; i<S; i++)
+	{	const double* w = spreadWeight.data() + i*2*nSpread;
+		complex Ti = 0.;
+		for(int l=0; l<2*nSpread; l++)
+			Ti += buf[(spreadStart[i]+l+M) % M] * w[l];
+		T[i] = Ti;
+	}
+	fftw_free(buf);
+}
+
+void FastHankel::apply(int nDeriv, const double* in, double* out) const
+{	assert(nDeriv>=0 && nDeriv<=2);
+	//Non-uniform FFTs of the coefficient combinations required for this kernel:
+	std::vector<double> z(S);
+	std::vector<complex> FbyG(S), F, FG;
+	for(int i=nNear; i<S; i++) z[i] = in[i] / G[i];
+	nufft1(z.data(), FbyG.data());
+	if(nDeriv >= 1)
+	{	F.resize(S);
+		nufft1(in, F.data());
+	}
+	if(nDeriv == 2)
+	{	for(int i=nNear; i<S; i++) z[i] = in[i] * G[i];
+		FG.resize(S);
+		nufft1(z.data(), FG.data());
+	}
+	//Combine into the closed forms of the kernels for all but the smallest r:
+	for(int j=nNear; j<S; j++)
+	{	double rInv = 1./r[j];
+		switch(nDeriv)
+		{	case 0: out[j] = rInv * FbyG[j].y; break; //sin(Gr)/(Gr)
+			case 1: out[j] = rInv * (F[j].x - rInv*FbyG[j].y); break; //cos(Gr)/r - sin(Gr)/(Gr^2)
+			case 2: out[j] = rInv * (rInv*(3.*rInv*FbyG[j].y - 3.*F[j].x) - FG[j].y); break; //3sin(Gr)/(Gr^3) - 3cos(Gr)/r^2 - G sin(Gr)/r
+		}
+	}
+	//Dense contributions from the smallest G, and all contributions for the smallest r:
+	cblas_dgemv(CblasRowMajor, CblasTrans, nNear, S-nNear, 1., colStrip[nDeriv].data()+nNear, S, in,1, 1., out+nNear,1);
+	cblas_dgemv(CblasRowMajor, CblasNoTrans, nNear, S, 1., rowStrip[nDeriv].data(), S, in,1, 0., out,1);
+}
+
+void FastHankel::applyTranspose(int nDeriv, const double* in, double* out) const
+{	assert(nDeriv>=0 && nDeriv<=2);
+	//Non-uniform FFTs of the input combinations required for this kernel:
+	std::vector<double> u(S);
+	std::vector<complex> TbyR(S), TbyR2, TbyR3;
+	for(int j=nNear; j<S; j++) u[j] = in[j] / r[j];
+	nufft2(u.data(), TbyR.data());
+	if(nDeriv >= 1)
+	{	for(int j=nNear; j<S; j++) u[j] = in[j] / pow(r[j],2);
+		TbyR2.resize(S);
+		nufft2(u.data(), TbyR2.data());
+	}
+	if(nDeriv == 2)
+	{	for(int j=nNear; j<S; j++) u[j] = in[j] / pow(r[j],3);
+		TbyR3.resize(S);
+		nufft2(u.data(), TbyR3.data());
+	}
+	//Combine into the closed forms of the kernels for all but the smallest G:
+	for(int i=nNear; i<S; i++)
+	{	double GInv = 1./G[i];
+		switch(nDeriv)
+		{	case 0: out[i] = GInv * TbyR[i].y; break;
+			case 1: out[i] = TbyR[i].x - GInv*TbyR2[i].y; break;
+			case 2: out[i] = 3.*GInv*TbyR3[i].y - 3.*TbyR2[i].x - G[i]*TbyR[i].y; break;
+		}
+	}
+	//Dense contributions from the smallest r, and all contributions for the smallest G:
+	cblas_dgemv(CblasRowMajor, CblasTrans, nNear, S-nNear, 1., rowStrip[nDeriv].data()+nNear, S, in,1, 1., out+nNear,1);
+	cblas_dgemv(CblasRowMajor, CblasNoTrans, nNear, S, 1., colStrip[nDeriv].data(), S, in,1, 0., out,1);
+}
@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of Fluid1D.
+
+Fluid1D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fluid1D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#ifndef FLUID1D_CORE1D_FASTHANKEL_H
+#define FLUID1D_CORE1D_FASTHANKEL_H
+
+/** @file FastHankel.h
+@brief Fast spherical Bessel transforms on the Spherical grid
+*/
+
+#include <core/scalar.h>
+#include <fftw3.h>
+#include <vector>
+
+/** @brief Fast alternative to the dense spherical Bessel transform matrices of GridInfo
+//! @ingroup griddata
+
+The nodes of the Spherical grid are uniformly spaced (roots of j0), r_j = (j+1) h,
+so every element of matI, matID and matIDD reduces to sines and cosines of (j+1) theta_i
+with theta_i = G_i h, divided by powers of G_i and r_j. The transforms are therefore
+evaluated exactly (to the requested tolerance) using non-uniform FFTs with Gaussian
+gridding on an oversampled uniform grid, in O(S log S) instead of O(S^2).
+The closed forms suffer from cancellation when G_i r_j is small, so the first few rows
+(small r) and columns (small G) are handled with stored dense strips of the matrices instead.
+*/
+class FastHankel
+{
+public:
+	//! Initialize for a Spherical grid with nodes r and momenta G
+	//! @param tol Relative tolerance of the non-uniform FFTs (controls the Gaussian spreading width)
+	FastHankel(const std::vector<double>& r, const std::vector<double>& G, double tol);
+	~FastHankel();
+	
+	//! Compute out = K.in, where K = matI, matID or matIDD for nDeriv = 0, 1 or 2 respectively
+	void apply(int nDeriv, const double* in, double* out) const;
+	
+	//! Compute out = transpose(K).in, where K = matI, matID or matIDD for nDeriv = 0, 1 or 2 respectively
+	void applyTranspose(int nDeriv, const double* in, double* out) const;
+	
+	const int S; //!< Number of grid points / basis functions
+	const int M; //!< Size of oversampled uniform grid used in the non-uniform FFTs
+	const int nSpread; //!< Half-width (in grid points) of the Gaussian spreading kernel
+	const int nNear; //!< Number of rows (smallest r) and columns (smallest G) evaluated using dense strips
+	
+private:
+	std::vector<double> r, G, theta; //grid nodes, momenta and phases G*h
+	double tau; //Gaussian spreading parameter
+	std::vector<int> spreadStart; //first oversampled grid point for each phase
+	std::vector<double> spreadWeight; //Gaussian weights (2*nSpread for each phase)
+	std::vector<double> deconvolve; //Gaussian deconvolution and normalization factor for each mode
+	std::vector<double> rowStrip[3], colStrip[3]; //dense strips of matI, matID and matIDD (row-major nNear x S and column-major S x nNear)
+	fftw_plan plan; //in-place backward transform of length M
+	
+	//Type-1 non-uniform FFT: F_n = sum_i z_i exp(i n theta_i) for n = 1 to S (with z_i = 0 for i < nNear)
+	void nufft1(const double* z, complex* F) const;
+	
+	//Type-2 non-uniform FFT: T_i = sum_n u_n exp(i n theta_i) for i >= nNear (with u_n = 0 for n <= nNear)
+	void nufft2(const double* u, complex* T) const;
+};
+
+#endif // FLUID1D_CORE1D_FASTHANKEL_H
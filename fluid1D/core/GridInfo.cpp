@@ -19,12 +19,16 @@ along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <core/GridInfo.h>
 #include <core/Data.h>
+#include <core/FastHankel.h>
+#include <core/Util.h>
 #include <cmath>
 #include <gsl/gsl_sf.h>
 
-GridInfo::GridInfo(GridInfo::CoordinateSystem coord, int S, double hMean)
+GridInfo::GridInfo(GridInfo::CoordinateSystem coord, int S, double hMean, TransformMethod transformMethod, double transformTol)
 : coord(coord), S(S), rMax(S*hMean), r(S), G(S), w(S), wTilde(S)
 {
+	if(transformMethod==FastTransform && coord!=Spherical)
+		logPrintf("WARNING: fast transforms are only available for Spherical grids; using dense transforms instead.\n");
 	switch(coord)
 	{
 		case Spherical:
@@ -42,6 +46,11 @@ GridInfo::GridInfo(GridInfo::CoordinateSystem coord, int S, double hMean)
 				w[i] =  4 * pow(M_PI/gsl_sf_bessel_j1(x[i+1]),2) * pow(rMax/y[S],3);
 				wTilde[i] = 1. / ((i ? 2 : 4.0/3) * M_PI * pow(rMax,3) * pow(gsl_sf_bessel_j0(y[i]),2));
 			}
+			if(transformMethod==FastTransform)
+			{	//Setup non-uniform FFTs instead of transform matrices
+				fastHankel = std::make_shared<FastHankel>(r, G, transformTol);
+				break;
+			}
 			//Setup transform matrices
 			matI.resize(S*S); auto elemI = matI.begin();
 			matID.resize(S*S); auto elemID = matID.begin();
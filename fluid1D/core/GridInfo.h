@@ -26,6 +26,9 @@ along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <fftw3.h>
 #include <vector>
+#include <memory>
+
+class FastHankel;
 
 /** @brief Simulation grid descriptor
 //! @ingroup griddata
@@ -42,11 +45,19 @@ public:
 	const int S; //!< Sample count
 	const double rMax; //!< Length or maximum radius of simulation grid
 	
+	//! Method for the spherical / cylindrical Bessel transforms
+	enum TransformMethod
+	{	DenseTransform, //!< Dense SxS matrix products
+		FastTransform //!< O(S log S) non-uniform FFTs (see FastHankel; Spherical only, other coordinate systems fall back to DenseTransform)
+	};
+	
 	//! Setup simulation grid
 	//! @param coord Coordinate system
 	//! @param S Sample count (equal to basis function count for all implemented bases)
 	//! @param hMean Mean grid spacing, defined by rMax/S
-	GridInfo(CoordinateSystem coord, int S, double hMean);
+	//! @param transformMethod Method for the spherical / cylindrical transforms (planar transforms always use FFTs)
+	//! @param transformTol Relative tolerance of the fast transforms (ignored for DenseTransform)
+	GridInfo(CoordinateSystem coord, int S, double hMean, TransformMethod transformMethod=DenseTransform, double transformTol=1e-12);
 	~GridInfo();
 	
 	std::vector<double> r; //!< Nodes of quadrature grid
@@ -57,7 +68,8 @@ public:
 	double Volume() const; //!< Simulation cell volume (per unit length for cylindrical, or unit area for planar)
 	
 	fftw_plan planPlanarI, planPlanarIdag, planPlanarID, planPlanarIDdag; //!< FFTW plans for planar transforms
-	std::vector<double> matI, matID, matIDD; //!< Dense SxS row-major matrices for spherical/cylindrical transforms
+	std::vector<double> matI, matID, matIDD; //!< Dense SxS row-major matrices for spherical/cylindrical transforms (not allocated if fastHankel is set)
+	std::shared_ptr<FastHankel> fastHankel; //!< Fast spherical transforms (only if FastTransform was selected and is available)
 };
 
 #endif // FLUID1D_CORE1D_DATA_H
@@ -20,6 +20,7 @@ along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/Operators.h>
 #include <core/BlasExtra.h>
 #include <core/Random.h>
+#include <core/FastHankel.h>
 
 //------------------------------ Linear Unary operators ------------------------------
 
@@ -48,6 +49,17 @@ inline void dgemv(bool transpose, const std::vector<double>& A, const ManagedMem
 		M, N, 1., A.data(), M,  X.data(),1, 0., Y.data(),1);
 }
 
+//Spherical/cylindrical transform (Y = K.X or transpose(K).X, with K = matI, matID or matIDD for nDeriv = 0, 1 or 2)
+inline void besselTransform(const GridInfo& gInfo, bool transpose, int nDeriv, const ManagedMemory& X, ManagedMemory& Y)
+{	if(gInfo.fastHankel)
+	{	assert(X);
+		assert(Y);
+		if(transpose) gInfo.fastHankel->applyTranspose(nDeriv, X.data(), Y.data());
+		else gInfo.fastHankel->apply(nDeriv, X.data(), Y.data());
+	}
+	else dgemv(transpose, (nDeriv==0 ? gInfo.matI : (nDeriv==1 ? gInfo.matID : gInfo.matIDD)), X, Y);
+}
+
 ScalarFieldTilde O(const ScalarFieldTilde& Y)
 {	ScalarFieldTilde tmp(Y);
 	return O((ScalarFieldTilde&&)tmp);
@@ -75,7 +87,7 @@ ScalarField I(const ScalarFieldTilde& Xtilde)
 		case GridInfo::Cylindrical:
 		{	ScalarFieldTilde tmp(Xtilde);
 			dmul(gInfo.wTilde, tmp); //premultiply by basis weights
-			dgemv(false, gInfo.matI, tmp, X); //multiply by matI
+			besselTransform(gInfo, false, 0, tmp, X); //multiply by matI
 			break;
 		}
 		case GridInfo::Planar:
@@ -97,7 +109,7 @@ ScalarField ID(const ScalarFieldTilde& Xtilde)
 		case GridInfo::Cylindrical:
 		{	ScalarFieldTilde tmp(Xtilde);
 			dmul(gInfo.wTilde, tmp); //premultiply by basis weights
-			dgemv(false, gInfo.matID, tmp, X); //multiply by matID
+			besselTransform(gInfo, false, 1, tmp, X); //multiply by matID
 			break;
 		}
 		case GridInfo::Planar:
@@ -126,7 +138,7 @@ ScalarField IDD(const ScalarFieldTilde& Xtilde)
 		case GridInfo::Cylindrical:
 		{	ScalarFieldTilde tmp(Xtilde);
 			dmul(gInfo.wTilde, tmp); //premultiply by basis weights
-			dgemv(false, gInfo.matIDD, tmp, X); //multiply by matIDD
+			besselTransform(gInfo, false, 2, tmp, X); //multiply by matIDD
 			break;
 		}
 		case GridInfo::Planar:
@@ -149,7 +161,7 @@ ScalarField Jdag(const ScalarFieldTilde& Xtilde)
 	{
 		case GridInfo::Spherical:
 		case GridInfo::Cylindrical:
-		{	dgemv(false, gInfo.matI, Xtilde, X); //multiply by matI
+		{	besselTransform(gInfo, false, 0, Xtilde, X); //multiply by matI
 			dmul(gInfo.w, X); //postmultiply by quadrature weights
 			break;
 		}
@@ -176,7 +188,7 @@ ScalarFieldTilde J(const ScalarField& X)
 		case GridInfo::Cylindrical:
 		{	ScalarField tmp(X);
 			dmul(gInfo.w, tmp); //premultiply by quadrature weights
-			dgemv(true, gInfo.matI, tmp, Xtilde); //multiply by transpose(matI)
+			besselTransform(gInfo, true, 0, tmp, Xtilde); //multiply by transpose(matI)
 			break;
 		}
 		case GridInfo::Planar:
@@ -196,7 +208,7 @@ ScalarFieldTilde Idag(const ScalarField& X)
 	{
 		case GridInfo::Spherical:
 		case GridInfo::Cylindrical:
-		{	dgemv(true, gInfo.matI, X, Xtilde); //multiply by transpose(matI)
+		{	besselTransform(gInfo, true, 0, X, Xtilde); //multiply by transpose(matI)
 			dmul(gInfo.wTilde, Xtilde); //postmultiply by basis weights
 			break;
 		}
@@ -218,7 +230,7 @@ ScalarFieldTilde IDdag(const ScalarField& X)
 	{
 		case GridInfo::Spherical:
 		case GridInfo::Cylindrical:
-		{	dgemv(true, gInfo.matID, X, Xtilde); //multiply by transpose(matID)
+		{	besselTransform(gInfo, true, 1, X, Xtilde); //multiply by transpose(matID)
 			dmul(gInfo.wTilde, Xtilde); //postmultiply by basis weights
 			break;
 		}
@@ -245,7 +257,7 @@ ScalarFieldTilde IDDdag(const ScalarField& X)
 	{
 		case GridInfo::Spherical:
 		case GridInfo::Cylindrical:
-		{	dgemv(true, gInfo.matIDD, X, Xtilde); //multiply by transpose(matIDD)
+		{	besselTransform(gInfo, true, 2, X, Xtilde); //multiply by transpose(matIDD)
 			dmul(gInfo.wTilde, Xtilde); //postmultiply by basis weights
 			break;
 		}
@@ -322,49 +334,39 @@ ScalarFieldTilde Linv(ScalarFieldTilde&& Y)
 
 //------------------------------ Nonlinear Unary operators ------------------------------
 
+inline void exp_calc(size_t i, const double* Ydata, double* retData) { retData[i] = exp(Ydata[i]); }
 ScalarField exp(const ScalarField& Y)
 {	assert(Y);
 	ScalarField ret(Y.gInfo);
-	double* retData = ret.data();
-	const double* Ydata = Y.data();
-	for(unsigned i=0; i<Y.nData(); i++)
-		retData[i] = exp(Ydata[i]);
+	gridLoop(exp_calc, Y.nData(), Y.data(), ret.data());
 	return ret;
 }
+inline void log_calc(size_t i, const double* Ydata, double* retData) { retData[i] = log(Ydata[i]); }
 ScalarField log(const ScalarField& Y)
 {	assert(Y);
 	ScalarField ret(Y.gInfo);
-	double* retData = ret.data();
-	const double* Ydata = Y.data();
-	for(unsigned i=0; i<Y.nData(); i++)
-		retData[i] = log(Ydata[i]);
+	gridLoop(log_calc, Y.nData(), Y.data(), ret.data());
 	return ret;
 }
+inline void sqrt_calc(size_t i, const double* Ydata, double* retData) { retData[i] = sqrt(Ydata[i]); }
 ScalarField sqrt(const ScalarField& Y)
 {	assert(Y);
 	ScalarField ret(Y.gInfo);
-	double* retData = ret.data();
-	const double* Ydata = Y.data();
-	for(unsigned i=0; i<Y.nData(); i++)
-		retData[i] = sqrt(Ydata[i]);
+	gridLoop(sqrt_calc, Y.nData(), Y.data(), ret.data());
 	return ret;
 }
+inline void inv_calc(size_t i, const double* Ydata, double* retData) { retData[i] = 1./Ydata[i]; }
 ScalarField inv(const ScalarField& Y)
 {	assert(Y);
 	ScalarField ret(Y.gInfo);
-	double* retData = ret.data();
-	const double* Ydata = Y.data();
-	for(unsigned i=0; i<Y.nData(); i++)
-		retData[i] = 1./Ydata[i];
+	gridLoop(inv_calc, Y.nData(), Y.data(), ret.data());
 	return ret;
 }
+inline void pow_calc(size_t i, const double* Ydata, double* retData, double alpha) { retData[i] = pow(Ydata[i], alpha); }
 ScalarField pow(const ScalarField& Y, double alpha)
 {	assert(Y);
 	ScalarField ret(Y.gInfo);
-	double* retData = ret.data();
-	const double* Ydata = Y.data();
-	for(unsigned i=0; i<Y.nData(); i++)
-		retData[i] = pow(Ydata[i], alpha);
+	gridLoop(pow_calc, Y.nData(), Y.data(), ret.data(), alpha);
 	return ret;
 }
 
@@ -22,6 +22,7 @@ along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <core/Data.h>
 #include <core/scaled.h>
+#include <core/Thread.h>
 
 
 //------------------------------ Linear Unary operators ------------------------------
@@ -159,4 +160,35 @@ double serialAccumulate(Callable* func, size_t nIter, Args... args)
 	return result;
 }
 
+//! Minimum number of iterations for which gridLoop and gridAccumulate use threads.
+//! Calibrated from ~15 us to launch and join each thread versus ~9 ns per point for exp()
+//! and ~40 ns per point for a typical functional kernel (several pow/exp/log per point):
+//! threading pays off above ~3000-6000 points for the cheap kernels on 2-4 threads,
+//! and above ~800-3000 points for the functional kernels (tests/Benchmark reports both paths).
+const size_t gridThreadMin = 4096;
+
+/**
+@brief A loop over grid points that is threaded for large grids
+
+Same as threadedLoop for nIter >= gridThreadMin, and serialLoop otherwise.
+func must be thread safe, i.e. each call may only write to outputs at index i.
+*/
+template<typename Callable,typename ... Args>
+void gridLoop(Callable* func, size_t nIter, Args... args)
+{	if(nIter < gridThreadMin) serialLoop(func, nIter, args...);
+	else threadedLoop(func, nIter, args...);
+}
+
+/**
+@brief An accumulator over grid points that is threaded for large grids
+
+Same as threadedAccumulate for nIter >= gridThreadMin, and serialAccumulate otherwise.
+func must be thread safe, i.e. each call may only write to outputs at index i.
+*/
+template<typename Callable,typename ... Args>
+double gridAccumulate(Callable* func, size_t nIter, Args... args)
+{	if(nIter < gridThreadMin) return serialAccumulate(func, nIter, args...);
+	else return threadedAccumulate(func, nIter, args...);
+}
+
 #endif // FLUID1D_CORE1D_OPERATORS_H
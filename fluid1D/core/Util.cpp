@@ -117,6 +117,7 @@ void logResume()
 
 
 static double startTime_us; //Time at which system was initialized in microseconds
+size_t mempoolSize = 0;
 
 void initSystem(int argc, char** argv)
 {
@@ -155,6 +156,18 @@ void initSystem(int argc, char** argv)
 	}
 	logPrintf("Will run with a maximum of %d cpu threads.\n", nProcsAvailable);
 	
+	//Memory pool size:
+	const char* mempoolSizeStr = getenv("FLUID1D_MEMPOOL_SIZE");
+	if(mempoolSizeStr)
+	{	int mempoolSizeMB;
+		if(sscanf(mempoolSizeStr, "%d", &mempoolSizeMB)==1 && mempoolSizeMB>=0)
+		{	mempoolSize = ((size_t)mempoolSizeMB) << 20; //convert to bytes
+			logPrintf("Memory pool size: %d MB\n", mempoolSizeMB);
+		}
+		else
+			logPrintf("Could not determine memory pool size from FLUID1D_MEMPOOL_SIZE=\"%s\".\n", mempoolSizeStr);
+	}
+	
 	//Add citations to the code and general framework:
 	Citations::add("Software package", "R. Sundararaman, K. Letchworth-Weaver and T.A. Arias, JDFTx, available from http://jdftx.sourceforge.net (2012)");
 	Citations::add("Algebraic framework", "S. Ismail-Beigi and T.A. Arias, Computer Physics Communications 128, 1 (2000)");
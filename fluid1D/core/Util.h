@@ -38,6 +38,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 //------------- Common Initialization -----------------
 
 extern bool killFlag; //!< Flag set by signal handlers - all compute loops should quit cleanly when this is set
+extern size_t mempoolSize; //!< If non-zero, size of memory pool managed internally by Fluid1D (set from environment variable FLUID1D_MEMPOOL_SIZE in MB)
 void printVersionBanner(); //!< Print package name, version, revision etc. to log
 void initSystem(int argc, char** argv); //!< Print banner, set up threads (play nice with job schedulers), GPU and signal handlers
 void finalizeSystem(bool successful=true); //!< Clean-up corresponding to initSystem() and final messages (depending on successful)
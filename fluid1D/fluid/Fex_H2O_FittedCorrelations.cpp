@@ -76,7 +76,7 @@ molecule("H2O",
 		die("The FittedCorrelations functional is only valid at T=298K.\n")
 	
 	//Initialize the kernels:
-	serialLoop(setKernels, gInfo.S, gInfo.G.data(),
+	gridLoop(setKernels, gInfo.S, gInfo.G.data(),
 		COO.data(), COH.data(), CHH.data(), fex_gauss.data(), siteChargeKernel.data());
 }
 
@@ -104,7 +104,7 @@ double Fex_H2O_FittedCorrelations::compute(const ScalarFieldTilde* Ntilde, Scala
 	ScalarField NObar = I(fex_gauss*Ntilde[0]), grad_NObar; nullToZero(grad_NObar, gInfo);
 	ScalarField NHbar = I(fex_gauss*Ntilde[1]), grad_NHbar; nullToZero(grad_NHbar, gInfo);
 	//Evaluated weighted density functional:
-	PhiEx += serialAccumulate(Fex_H2O_FittedCorrelations_calc1D, gInfo.S, gInfo.w.data(),
+	PhiEx += gridAccumulate(Fex_H2O_FittedCorrelations_calc1D, gInfo.S, gInfo.w.data(),
 		 NObar.data(), NHbar.data(), grad_NObar.data(), grad_NHbar.data());
 	//Convert gradients:
 	grad_Ntilde[0] += fex_gauss*Idag(grad_NObar);
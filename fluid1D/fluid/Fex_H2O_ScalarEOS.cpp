@@ -63,7 +63,7 @@ double Fex_H2O_ScalarEOS::compute(const ScalarFieldTilde* Ntilde, ScalarFieldTil
 	ScalarField Nbar = I(fex_LJatt * NavgTilde);
 	//Evaluated weighted density functional:
 	ScalarField Aex(&gInfo), AexPrime(&gInfo);
-	serialLoop(eval, gInfo.S, Nbar.data(), Aex.data(), AexPrime.data());
+	gridLoop(eval, gInfo.S, Nbar.data(), Aex.data(), AexPrime.data());
 	//Convert gradients:
 	ScalarFieldTilde OJAex = O(J(Aex));
 	for(unsigned i=0; i<ljWeights.size(); i++)
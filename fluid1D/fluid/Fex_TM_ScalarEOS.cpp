@@ -45,7 +45,7 @@ double Fex_TM_ScalarEOS::compute(const ScalarFieldTilde* Ntilde, ScalarFieldTild
 	ScalarField Nbar = I(fex_LJatt * NavgTilde);
 	//Evaluated weighted density functional:
 	ScalarField Aex(&gInfo), AexPrime(&gInfo);
-	serialLoop(eval, gInfo.S, Nbar.data(), Aex.data(), AexPrime.data());
+	gridLoop(eval, gInfo.S, Nbar.data(), Aex.data(), AexPrime.data());
 	//Convert gradients:
 	ScalarFieldTilde OJAex = O(J(Aex));
 	for(unsigned i=0; i<ljWeights.size(); i++)
@@ -91,7 +91,7 @@ double PhiFMT(const ScalarField& n0, const ScalarField& n1, const ScalarField& n
 	nullToZero(grad_n0, gInfo); nullToZero(grad_n1, gInfo); nullToZero(grad_n2, gInfo); nullToZero(grad_n3, gInfo);
 	nullToZero(grad_n1v, gInfo); nullToZero(grad_n2v, gInfo); nullToZero(grad_n2m, gInfo);
 
-	double Phi = serialAccumulate(phiFMT_calc, gInfo.S, gInfo.w.data(),
+	double Phi = gridAccumulate(phiFMT_calc, gInfo.S, gInfo.w.data(),
 			n0.data(), n1.data(), n2.data(), n3.data(), n1v.data(), n2v.data(), n2m.data(),
 			grad_n0.data(), grad_n1.data(), grad_n2.data(), grad_n3.data(),
 			grad_n1v.data(), grad_n2v.data(), grad_n2m.data());
@@ -158,7 +158,7 @@ double PhiBond(double Rhm, double scale, const ScalarField& n0mol, const ScalarF
 	nullToZero(grad_n3, gInfo);
 	nullToZero(grad_n2v, gInfo);
 	
-	double Phi = serialAccumulate(phiBond_calc, gInfo.S, Rhm, scale, gInfo.w.data(),
+	double Phi = gridAccumulate(phiBond_calc, gInfo.S, Rhm, scale, gInfo.w.data(),
 			n0mol.data(), n2.data(), n3.data(), n2v.data(),
 			grad_n0mol.data(), grad_n2.data(), grad_n3.data(), grad_n2v.data());
 	n3=0; n2v=0; //no longer need these weighted densities (clean up)
@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of Fluid1D.
+
+Fluid1D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fluid1D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <core/Minimize.h>
+#include <fluid/FluidMixture.h>
+#include <fluid/IdealGasPomega.h>
+#include <fluid/Fex_H2O_ScalarEOS.h>
+
+//Time a callable in microseconds per call
+template<typename Func> double timeCall(int nRepeat, const Func& func)
+{	func(); //warm-up (plans, caches and memory pool)
+	double tStart = clock_us();
+	for(int iRepeat=0; iRepeat<nRepeat; iRepeat++) func();
+	return (clock_us() - tStart) / nRepeat;
+}
+
+void benchmarkTransforms(const GridInfo& gInfo, int nRepeat)
+{	ScalarField r(&gInfo); initRandom(r);
+	ScalarFieldTilde g = J(r);
+	#define TIME_OP(op, in) \
+		logPrintf("\t%-8s %12.3lf us\n", #op, timeCall(nRepeat, [&](){ op(in); }));
+	TIME_OP(I, g)
+	TIME_OP(ID, g)
+	TIME_OP(IDD, g)
+	TIME_OP(Jdag, g)
+	TIME_OP(J, r)
+	TIME_OP(Idag, r)
+	TIME_OP(IDdag, r)
+	TIME_OP(IDDdag, r)
+	TIME_OP(exp, r)
+	TIME_OP(log, exp(r))
+	#undef TIME_OP
+}
+
+void benchmarkFluid(const GridInfo& gInfo, int nRepeat, int nIterations)
+{	//Water with the ScalarEOS functional (same setup as SigmaVsRadius):
+	SO3quad quad(QuadEuler, 2, 20, 1);
+	TranslationOperatorLspline trans(gInfo);
+	FluidMixture fluidMixture(gInfo, 298*Kelvin);
+	Fex_H2O_ScalarEOS fex(fluidMixture);
+	IdealGasPomega idgas(&fex, 1.0, quad, trans);
+	fluidMixture.setPressure(1.01325*Bar);
+	//Hard-wall cavity:
+	nullToZero(idgas.V, gInfo);
+	double* Vdata = idgas.V[0].data();
+	for(int i=0; i<gInfo.S; i++)
+		Vdata[i] = gInfo.r[i]<0.1*gInfo.rMax ? 1. : 0.;
+	fluidMixture.initState(0.15);
+	
+	//Free energy and gradient:
+	ScalarFieldCollection grad;
+	logPrintf("\t%-8s %12.3lf us\n", "Phi+grad", timeCall(nRepeat, [&](){ fluidMixture.compute(&grad); }));
+	
+	//Minimizer:
+	MinimizeParams mp;
+	mp.alphaTstart = 3e4;
+	mp.nDim = gInfo.S * fluidMixture.get_nIndep();
+	mp.energyLabel = "Phi";
+	mp.nIterations = nIterations;
+	mp.energyDiffThreshold = 0.; //always run nIterations
+	mp.fpLog = nullLog;
+	double tStart = clock_us();
+	fluidMixture.minimize(mp);
+	logPrintf("\t%-8s %12.3lf us per iteration (%d iterations)\n", "minimize", (clock_us()-tStart)/nIterations, nIterations);
+}
+
+void benchmarkSize(int S, int nRepeat, int nIterations)
+{	double h = 0.125; //grid spacing
+	logPrintf("\nBenchmarking with S = %d, h = %lg bohr, %d threads (grid loops %s)\n", S, h, nProcsAvailable,
+		size_t(S) < gridThreadMin ? "serial" : "threaded");
+	
+	struct Case { const char* name; GridInfo::CoordinateSystem coord; GridInfo::TransformMethod method; };
+	const Case cases[] = {
+		{ "Spherical (dense transforms)", GridInfo::Spherical, GridInfo::DenseTransform },
+		{ "Spherical (fast transforms)", GridInfo::Spherical, GridInfo::FastTransform },
+		{ "Cylindrical", GridInfo::Cylindrical, GridInfo::DenseTransform },
+		{ "Planar", GridInfo::Planar, GridInfo::DenseTransform }
+	};
+	for(const Case& c: cases)
+	{	double tStart = clock_us();
+		GridInfo gInfo(c.coord, S, h, c.method);
+		logPrintf("\n%s: setup %.3lf ms\n", c.name, 1e-3*(clock_us()-tStart));
+		benchmarkTransforms(gInfo, nRepeat);
+		benchmarkFluid(gInfo, nRepeat, nIterations);
+	}
+}
+
+int main(int argc, char** argv)
+{	initSystem(argc, argv);
+	int S = argc>1 ? atoi(argv[1]) : 0; //number of grid points (default: one size on each side of gridThreadMin)
+	int nRepeat = argc>2 ? atoi(argv[2]) : 20; //number of timed calls per operation
+	int nIterations = argc>3 ? atoi(argv[3]) : 20; //number of timed minimizer iterations
+	if(S) benchmarkSize(S, nRepeat, nIterations);
+	else
+	{	benchmarkSize(gridThreadMin/4, nRepeat, nIterations); //serial grid loops
+		benchmarkSize(gridThreadMin*2, nRepeat, nIterations); //threaded grid loops
+	}
+	
+	finalizeSystem();
+}
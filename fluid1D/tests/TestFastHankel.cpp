@@ -0,0 +1,86 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of Fluid1D.
+
+Fluid1D is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fluid1D is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fluid1D.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <core/Operators.h>
+#include <core/Util.h>
+#include <cmath>
+
+//Relative error between results of the fast and dense transforms (which live on different grids)
+double relErr(const ManagedMemory& fast, const ManagedMemory& dense)
+{	double errSq = 0.;
+	for(size_t i=0; i<dense.nData(); i++)
+		errSq += pow(fast.data()[i] - dense.data()[i], 2);
+	return sqrt(errSq) / nrm2(dense);
+}
+
+int main(int argc, char** argv)
+{	initSystem(argc, argv);
+	int S = argc>1 ? atoi(argv[1]) : 1024;
+	double tol = argc>2 ? atof(argv[2]) : 1e-12;
+	
+	double tStart = clock_us();
+	GridInfo gInfo(GridInfo::Spherical, S, 0.25);
+	double tDense = clock_us();
+	GridInfo gInfoFast(GridInfo::Spherical, S, 0.25, GridInfo::FastTransform, tol);
+	double tFast = clock_us();
+	printf("Grid setup with S = %d: dense %.2lf s, fast %.2lf s (tolerance %le)\n", S, 1e-6*(tDense-tStart), 1e-6*(tFast-tDense), tol);
+	
+	{	puts("\nTest 1: Fast vs dense transforms");
+		ScalarField r(&gInfo), rFast(&gInfoFast);
+		initRandom(r); memcpy(rFast, r);
+		ScalarFieldTilde g = J(r), gFast = J(rFast);
+		printf("\tRelative error in J: %le\n", relErr(gFast, g));
+		#define COMPARE(op, in, inFast) \
+			printf("\tRelative error in " #op ": %le\n", relErr(op(inFast), op(in)));
+		COMPARE(I, g, gFast)
+		COMPARE(ID, g, gFast)
+		COMPARE(IDD, g, gFast)
+		COMPARE(Jdag, g, gFast)
+		COMPARE(Idag, r, rFast)
+		COMPARE(IDdag, r, rFast)
+		COMPARE(IDDdag, r, rFast)
+		#undef COMPARE
+	}
+	
+	{	puts("\nTest 2: Round trips and adjoints with fast transforms");
+		ScalarField r1(&gInfoFast), r2(&gInfoFast);
+		initRandom(r1); initRandom(r2);
+		ScalarFieldTilde g1 = J(r1);
+		printf("\tTransform inverse relative error: %le\n", nrm2(I(g1)-r1) / nrm2(r1));
+		printf("\tRelative error between A.Idag(B) and I(A).B: %le\n", dot(g1,Idag(r2))/dot(r2,I(g1))-1.);
+		printf("\tRelative error between A.IDdag(B) and ID(A).B: %le\n", dot(g1,IDdag(r2))/dot(r2,ID(g1))-1.);
+		printf("\tRelative error between A.IDDdag(B) and IDD(A).B: %le\n", dot(g1,IDDdag(r2))/dot(r2,IDD(g1))-1.);
+		printf("\tRelative error between A.Jdag(B) and J(A).B: %le\n", dot(g1,J(r2))/dot(r2,Jdag(g1))-1.);
+	}
+	
+	{	puts("\nTest 3: Timing");
+		ScalarField r(&gInfo), rFast(&gInfoFast);
+		initRandom(r); memcpy(rFast, r);
+		ScalarFieldTilde g = J(r), gFast = J(rFast);
+		int nRepeat = 10;
+		double t0 = clock_us();
+		for(int iRepeat=0; iRepeat<nRepeat; iRepeat++) IDD(g);
+		double t1 = clock_us();
+		for(int iRepeat=0; iRepeat<nRepeat; iRepeat++) IDD(gFast);
+		double t2 = clock_us();
+		printf("\tIDD: dense %.3lf ms, fast %.3lf ms per transform\n", 1e-3*(t1-t0)/nRepeat, 1e-3*(t2-t1)/nRepeat);
+	}
+	
+	finalizeSystem();
+}
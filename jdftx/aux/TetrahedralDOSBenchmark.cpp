@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <electronic/TetrahedralDOS.h>
+#include <core/MPIUtil.h>
+#include <core/Util.h>
+
+//Time tetrahedron DOS evaluation for a tight-binding model on an N x N x N k-mesh
+//and check the sum rule (integral of each weighted DOS over energy)
+void benchmark(int N, int nBands, int nWeights)
+{	//Uniform k-mesh on a simple cubic lattice:
+	std::vector<vector3<>> kmesh; kmesh.reserve(N*N*N);
+	vector3<int> ik;
+	for(ik[0]=0; ik[0]<N; ik[0]++)
+	for(ik[1]=0; ik[1]<N; ik[1]++)
+	for(ik[2]=0; ik[2]<N; ik[2]++)
+		kmesh.push_back(ik * (1./N));
+	double tStart = clock_sec();
+	TetrahedralDOS eval(kmesh, std::vector<int>(), matrix3<>(1,1,1)*5., Diag(vector3<int>(N,N,N)), 1, nBands, nWeights);
+	double tSetup = clock_sec() - tStart;
+	
+	//Tight-binding bands with weights that vary with k (weight 0 is the total DOS):
+	for(int q=0; q<eval.nReduced; q++)
+	{	vector3<> c; for(int k=0; k<3; k++) c[k] = cos(2*M_PI*kmesh[q][k]);
+		for(int b=0; b<nBands; b++)
+		{	eval.e(q,b) = 0.1*b + (0.02+0.01*b)*(c[0] + c[1] + c[2]) + 0.005*c[0]*c[1];
+			for(int i=1; i<nWeights; i++)
+				eval.w(i,q,b) = 0.5*(1. + c[i%3]);
+		}
+	}
+	tStart = clock_sec();
+	TetrahedralDOS::Lspline dos = eval.getDOS(0, 1e-6, mpiWorld);
+	double tDOS = clock_sec() - tStart;
+	
+	//Sum rule: trapezoidal integral of linear spline = nBands * mean weight:
+	std::vector<double> integral(nWeights, 0.);
+	for(size_t j=0; j+1<dos.size(); j++)
+		for(int i=0; i<nWeights; i++)
+			integral[i] += 0.5*(dos[j+1].first-dos[j].first) * (dos[j].second[i] + dos[j+1].second[i]);
+	logPrintf("N = %3d (%8d k-points): setup %8.3lf s, getDOS %8.3lf s, %9lu nodes, total DOS integral error %le\n",
+		N, int(kmesh.size()), tSetup, tDOS, dos.size(), integral[0]/nBands - 1.);
+}
+
+//Regression check for a dispersionless band, whose coalesced spline has a single node
+//(fewer nodes than threads): the delta function must be counted exactly once.
+//Returns true if the sum rule is satisfied.
+bool checkSingleNode(int N, int nWeights)
+{	std::vector<vector3<>> kmesh; kmesh.reserve(N*N*N);
+	vector3<int> ik;
+	for(ik[0]=0; ik[0]<N; ik[0]++)
+	for(ik[1]=0; ik[1]<N; ik[1]++)
+	for(ik[2]=0; ik[2]<N; ik[2]++)
+		kmesh.push_back(ik * (1./N));
+	TetrahedralDOS eval(kmesh, std::vector<int>(), matrix3<>(1,1,1)*5., Diag(vector3<int>(N,N,N)), 1, 1, nWeights);
+	for(int q=0; q<eval.nReduced; q++)
+	{	eval.e(q,0) = 0.25;
+		for(int i=1; i<nWeights; i++)
+			eval.w(i,q,0) = 0.5;
+	}
+	TetrahedralDOS::Lspline dos = eval.getDOS(0, 1e-6, mpiWorld);
+	double errMax = 0.;
+	for(int i=0; i<nWeights; i++)
+	{	double integral = 0.;
+		for(size_t j=0; j+1<dos.size(); j++)
+			integral += 0.5*(dos[j+1].first-dos[j].first) * (dos[j].second[i] + dos[j+1].second[i]);
+		errMax = std::max(errMax, fabs(integral - (i ? 0.5 : 1.)));
+	}
+	bool passed = (errMax < 1e-12);
+	logPrintf("Single-node band (N = %d): weighted DOS integral error %le: %s\n", N, errMax, passed ? "passed" : "FAILED");
+	return passed;
+}
+
+int main(int argc, char** argv)
+{	initSystem(argc, argv);
+	int nBands = 8, nWeights = 4;
+	bool passed = checkSingleNode(2, nWeights);
+	for(int N: {10, 20, 50, 100}) //up to 10^6 k-points
+		benchmark(N, nBands, nWeights);
+	finalizeSystem();
+	return passed ? 0 : 1;
+}
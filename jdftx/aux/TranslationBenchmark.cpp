@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <fluid/TranslationOperator.h>
+#include <core/ScalarFieldArray.h>
+#include <core/Random.h>
+#include <core/Util.h>
+
+//Compare per-shift and batched spline translations (timing and agreement),
+//for a set of shifts representative of a multi-site solvent molecule
+void benchmark(const GridInfo& gInfo, TranslationOperatorSpline::SplineType splineType, int nShifts, int nRepeat)
+{	TranslationOperatorSpline trans(gInfo, splineType);
+	std::vector< vector3<> > t(nShifts);
+	std::vector<double> alpha(nShifts);
+	ScalarFieldArray x(nShifts);
+	std::vector<const ScalarField*> xPtr(nShifts);
+	for(int j=0; j<nShifts; j++)
+	{	for(int k=0; k<3; k++) t[j][k] = 2.*Random::uniform() - 1.; //shifts within a couple of bohrs
+		alpha[j] = Random::uniform();
+		nullToZero(x[j], gInfo); initRandomFlat(x[j]);
+		xPtr[j] = &x[j];
+	}
+	const char* splineName = (splineType==TranslationOperatorSpline::Constant) ? "Constant" : "Linear";
+	
+	//Gather: y += sum_j alpha_j T_j(x_j)
+	ScalarField yRef, yBatched;
+	double tStart = clock_sec();
+	for(int iRepeat=0; iRepeat<nRepeat; iRepeat++)
+	{	yRef = 0;
+		for(int j=0; j<nShifts; j++) trans.taxpy(t[j], alpha[j], x[j], yRef);
+	}
+	double tRef = (clock_sec()-tStart)/nRepeat;
+	tStart = clock_sec();
+	for(int iRepeat=0; iRepeat<nRepeat; iRepeat++)
+	{	yBatched = 0;
+		trans.taxpyBatched(t, alpha, xPtr, yBatched);
+	}
+	double tBatched = (clock_sec()-tStart)/nRepeat;
+	logPrintf("%8s gather : per-shift %7.3lf ms, batched %7.3lf ms (speedup %.2lf), rms diff = %le\n", splineName,
+		tRef*1e3, tBatched*1e3, tRef/tBatched, nrm2(yRef-yBatched)/sqrt(gInfo.nr));
+	
+	//Scatter: y_j += alpha_j T_j(x_0)
+	ScalarFieldArray yRefArr(nShifts), yBatchedArr(nShifts);
+	std::vector<ScalarField*> yPtr(nShifts);
+	for(int j=0; j<nShifts; j++) yPtr[j] = &yBatchedArr[j];
+	tStart = clock_sec();
+	for(int iRepeat=0; iRepeat<nRepeat; iRepeat++)
+	{	for(int j=0; j<nShifts; j++) { yRefArr[j] = 0; trans.taxpy(t[j], alpha[j], x[0], yRefArr[j]); }
+	}
+	tRef = (clock_sec()-tStart)/nRepeat;
+	tStart = clock_sec();
+	for(int iRepeat=0; iRepeat<nRepeat; iRepeat++)
+	{	for(int j=0; j<nShifts; j++) yBatchedArr[j] = 0;
+		trans.taxpyBatched(t, alpha, x[0], yPtr);
+	}
+	tBatched = (clock_sec()-tStart)/nRepeat;
+	double errMax = 0.; //max over outputs
+	for(int j=0; j<nShifts; j++) errMax = std::max(errMax, nrm2(yRefArr[j]-yBatchedArr[j]) / sqrt(gInfo.nr));
+	logPrintf("%8s scatter: per-shift %7.3lf ms, batched %7.3lf ms (speedup %.2lf), rms diff = %le\n", splineName,
+		tRef*1e3, tBatched*1e3, tRef/tBatched, errMax);
+}
+
+int main(int argc, char** argv)
+{	initSystem(argc, argv);
+	
+	GridInfo gInfo;
+	gInfo.S = vector3<int>(96, 96, 96);
+	gInfo.R = Diag(0.3 * gInfo.S);
+	gInfo.initialize();
+	
+	int nShifts = 4, nRepeat = 10; //e.g. the sites of a 4-site water model
+	benchmark(gInfo, TranslationOperatorSpline::Constant, nShifts, nRepeat);
+	benchmark(gInfo, TranslationOperatorSpline::Linear, nShifts, nRepeat);
+	
+	finalizeSystem();
+	return 0;
+}
@@ -181,6 +181,31 @@ struct CommandCoulombTruncationIonMargin : public Command
 commandCoulombTruncationIonMargin;
 
 
+struct CommandCoulombKernelCache : public Command
+{
+	CommandCoulombKernelCache() : Command("coulomb-kernel-cache", "jdftx/Coulomb interactions")
+	{
+		format = "<directory>";
+		comments =
+			"Cache numerically computed Coulomb and exchange kernels (Isolated and Wire\n"
+			"geometries, and Wigner-Seitz truncated exchange) in <directory>, keyed by a\n"
+			"hash of the lattice vectors, grid, truncation geometry, screening and regularization.\n"
+			"Subsequent runs with identical parameters load the kernels from the cache\n"
+			"(memory-mapped, so large exchange kernels are paged in on demand) instead of\n"
+			"recomputing them. The directory is created if necessary; by default, no cache is used.";
+	}
+
+	void process(ParamList& pl, Everything& e)
+	{	pl.get(e.coulombParams.kernelCacheDir, string(), "directory", true);
+	}
+
+	void printStatus(Everything& e, int iRep)
+	{	logPrintf("%s", e.coulombParams.kernelCacheDir.c_str());
+	}
+}
+commandCoulombKernelCache;
+
+
 struct CommandExchangeRegularization : public Command
 {
 	CommandExchangeRegularization() : Command("exchange-regularization", "jdftx/Coulomb interactions")
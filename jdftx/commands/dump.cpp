@@ -326,8 +326,13 @@ struct CommandPolarizability : public Command
 {
     CommandPolarizability() : Command("polarizability", "jdftx/Output")
 	{
-		format = "<eigenBasis>=" + polarizabilityMap.optionList() + " [<Ecut>=0] [<nEigs>=0]";
-		comments = "Output polarizability matrix in specified eigenBasis";
+		format = "<eigenBasis>=" + polarizabilityMap.optionList() + " [<Ecut>=0] [<nEigs>=0] [<maxMemory>=0]";
+		comments =
+			"Output polarizability matrix in specified eigenBasis.\n"
+			"Each orbital is transformed to real space once per k-point and reused for all its\n"
+			"pair densities; optionally limit the memory for these cached real-space orbitals\n"
+			"to <maxMemory> in MB (0 => cache all, default), which processes the valence and\n"
+			"conduction bands in blocks that fit (re-transforming conduction bands per block).";
 		
 		forbid("electron-scattering"); //both are major operations that are given permission to destroy Everything if necessary
 	}
@@ -337,12 +342,14 @@ struct CommandPolarizability : public Command
 		pl.get(e.dump.polarizability->eigenBasis, Polarizability::NonInteracting, polarizabilityMap, "eigenBasis");
 		pl.get(e.dump.polarizability->Ecut, 0., "Ecut");
 		pl.get(e.dump.polarizability->nEigs, 0, "nEigs");
+		pl.get(e.dump.polarizability->maxMemory, 0., "maxMemory");
+		if(e.dump.polarizability->maxMemory < 0.) throw string("<maxMemory> must be non-negative");
 		e.dump.insert(std::make_pair(DumpFreq_End, DumpPolarizability));
 	}
 
 	void printStatus(Everything& e, int iRep)
-	{	logPrintf("%s %lg %d", polarizabilityMap.getString(e.dump.polarizability->eigenBasis),
-			e.dump.polarizability->Ecut, e.dump.polarizability->nEigs);
+	{	logPrintf("%s %lg %d %lg", polarizabilityMap.getString(e.dump.polarizability->eigenBasis),
+			e.dump.polarizability->Ecut, e.dump.polarizability->nEigs, e.dump.polarizability->maxMemory);
 	}
 }
 commandPolarizability;
@@ -354,6 +361,7 @@ enum ElectronScatteringMember
 	ESM_fCut,
 	ESM_omegaMax,
 	ESM_RPA,
+	ESM_maxMemory,
 	ESM_slabResponse,
 	ESM_EcutTransverse,
 	ESM_delim
@@ -364,6 +372,7 @@ EnumStringMap<ElectronScatteringMember> esmMap
 	ESM_fCut, "fCut",
 	ESM_omegaMax, "omegaMax",
 	ESM_RPA, "RPA",
+	ESM_maxMemory, "maxMemory",
 	ESM_slabResponse, "slabResponse",
 	ESM_EcutTransverse, "EcutTransverse"
 );
@@ -392,6 +401,10 @@ struct CommandElectronScattering : public Command
 			"   (if zero, autodetermine from available eigenvalues)\n"
 			"\n+ RPA yes|no\n\n"
 			"   If yes, use RPA response that ignores XC contribution. (default: no).\n"
+			"\n+ maxMemory <maxMemory>\n\n"
+			"   Limit the pair densities held while integrating ImSigma over frequency\n"
+			"   to <maxMemory> in MB per process, processing k-points in batches that each\n"
+			"   stream the screened Coulomb operator once (default: 0 => no limit).\n"
 			"\n+ slabResponse yes|no\n\n"
 			"   Whether to output slab-normal-direction susceptibility instead.\n"
 			"   This needs slab geometry in coulomb-interaction, and will bypass the\n"
@@ -419,6 +432,7 @@ struct CommandElectronScattering : public Command
 				case ESM_fCut: pl.get(es.fCut, 0., "fCut", true); break;
 				case ESM_omegaMax: pl.get(es.omegaMax, 0., "omegaMax", true); break;
 				case ESM_RPA: pl.get(es.RPA, false, boolMap, "RPA", true); break;
+				case ESM_maxMemory: pl.get(es.maxMemory, 0., "maxMemory", true); break;
 				case ESM_slabResponse: pl.get(es.slabResponse, false, boolMap, "slabResponse", true); break;
 				case ESM_EcutTransverse: pl.get(es.EcutTransverse, 0., "EcutTransverse", true); break;
 				case ESM_delim: break; //never encountered; to suppress compiler warning
@@ -432,6 +446,7 @@ struct CommandElectronScattering : public Command
 		{	if(es.EcutTransverse) throw string("Cannot specify EcutTransverse when slabResponse = no");
 		}
 		if(es.eta <= 0.) throw string("Must specify frequency grid resolution eta > 0.");
+		if(es.maxMemory < 0.) throw string("<maxMemory> must be non-negative");
 	}
 
 	void printStatus(Everything& e, int iRep)
@@ -441,6 +456,7 @@ struct CommandElectronScattering : public Command
 		logPrintf(" \\\n\tfCut     %lg", es.fCut);
 		logPrintf(" \\\n\tomegaMax %lg", es.omegaMax);
 		logPrintf(" \\\n\tRPA      %s", boolMap.getString(es.RPA));
+		logPrintf(" \\\n\tmaxMemory %lg", es.maxMemory);
 		logPrintf(" \\\n\tslabResponse %s", boolMap.getString(es.slabResponse));
 		if(es.slabResponse) logPrintf(" \\\n\tEcutTransverse %lg", es.EcutTransverse);
 	}
@@ -284,23 +284,96 @@ struct CommandCacheProjectors : public Command
 {
 	CommandCacheProjectors() : Command("cache-projectors", "jdftx/Miscellaneous")
 	{
-		format = "yes|no";
+		format = "yes|no [<maxMemory>=0]";
 		comments =
-			"Cache nonlocal-pseudopotential projectors (yes by default); turn off to save memory.";
+			"Cache nonlocal-pseudopotential projectors (yes by default); turn off to save memory.\n"
+			"Optionally, limit the memory used by the cache to <maxMemory> in MB per process\n"
+			"(0 => unlimited, default). When the limit is reached, projectors that were least\n"
+			"recently used and are cheapest to recompute per unit memory are evicted,\n"
+			"and are regenerated when needed again. Cache statistics are included in\n"
+			"the memory usage report at the end of the run (in builds with profiling enabled).";
 	}
 
 	void process(ParamList& pl, Everything& e)
 	{	pl.get(e.cntrl.cacheProjectors, true, boolMap, "shouldCache", true);
+		pl.get(e.cntrl.projectorCacheMemory, 0., "maxMemory");
+		if(e.cntrl.projectorCacheMemory < 0.) throw string("<maxMemory> must be non-negative");
 	}
 
 	void printStatus(Everything& e, int iRep)
-	{	logPrintf("%s", boolMap.getString(e.cntrl.cacheProjectors));
+	{	logPrintf("%s %lg", boolMap.getString(e.cntrl.cacheProjectors), e.cntrl.projectorCacheMemory);
 	}
 }
 commandCacheProjectors;
 
 //-------------------------------------------------------------------------------------------------
 
+struct CommandRealSpaceProjectors : public Command
+{
+	CommandRealSpaceProjectors() : Command("real-space-projectors", "jdftx/Miscellaneous")
+	{
+		format = "yes|no [<tolerance>=1e-4]";
+		comments =
+			"Apply nonlocal-pseudopotential projectors in real space (no by default).\n"
+			"The projectors are Fourier filtered (tapered smoothly between the wavefunction\n"
+			"cutoff and the largest sphere in the wavefunction FFT box to control aliasing),\n"
+			"and stored only on grid points within a sphere around each atom, whose radius\n"
+			"is set by truncating the projectors below <tolerance> relative to their peak.\n"
+			"This makes projector memory and cost linear in the number of atoms (instead of\n"
+			"quadratic for the cached reciprocal-space projectors), and is therefore useful\n"
+			"for large supercells. Forces use the gradients of the same real-space projectors\n"
+			"(and are therefore consistent with the energy), while other properties such as\n"
+			"momentum matrix elements still use reciprocal-space projectors (computed on demand).\n"
+			"Not supported for noncollinear spin or on GPUs, in which case this command is ignored.";
+		require("spintype");
+	}
+
+	void process(ParamList& pl, Everything& e)
+	{	pl.get(e.cntrl.realSpaceProjectors, false, boolMap, "shouldUse", true);
+		pl.get(e.cntrl.realSpaceProjectorTol, 1e-4, "tolerance");
+		if(e.cntrl.realSpaceProjectorTol <= 0. || e.cntrl.realSpaceProjectorTol >= 1.)
+			throw string("<tolerance> must be in (0,1)");
+		if(e.cntrl.realSpaceProjectors && (e.eInfo.isNoncollinear() || isGpuEnabled()))
+		{	logPrintf("NOTE: real-space projectors not supported for noncollinear spin or on GPUs; ignoring real-space-projectors.\n");
+			e.cntrl.realSpaceProjectors = false;
+		}
+	}
+
+	void printStatus(Everything& e, int iRep)
+	{	logPrintf("%s %lg", boolMap.getString(e.cntrl.realSpaceProjectors), e.cntrl.realSpaceProjectorTol);
+	}
+}
+commandRealSpaceProjectors;
+
+//-------------------------------------------------------------------------------------------------
+
+struct CommandExchangePrefetch : public Command
+{
+	CommandExchangePrefetch() : Command("exchange-prefetch", "jdftx/Miscellaneous")
+	{
+		format = "<depth>=1";
+		comments =
+			"Number of partner k-points whose wavefunctions are broadcast (non-blocking)\n"
+			"ahead of the one being processed in exact-exchange calculations, to overlap\n"
+			"communication with computation. Each level of prefetch holds one additional\n"
+			"set of wavefunctions at a single k-point on every process. Set to 0 to\n"
+			"broadcast each k-point only when it is needed (minimum memory).";
+		hasDefault = true;
+	}
+
+	void process(ParamList& pl, Everything& e)
+	{	pl.get(e.cntrl.exchangePrefetchDepth, 1, "depth");
+		if(e.cntrl.exchangePrefetchDepth < 0) throw string("<depth> must be non-negative");
+	}
+
+	void printStatus(Everything& e, int iRep)
+	{	logPrintf("%d", e.cntrl.exchangePrefetchDepth);
+	}
+}
+commandExchangePrefetch;
+
+//-------------------------------------------------------------------------------------------------
+
 struct CommandBasis : public Command
 {
 	CommandBasis() : Command("basis", "jdftx/Electronic/Parameters")
@@ -263,6 +263,7 @@ enum FluidComponentMember
 	FCM_quad_nAlpha, //!< number of alpha samples for Euler quadrature
 	FCM_quad_nGamma, //!< number of gamma samples for Euler quadrature
 	FCM_translationMode, //!< translation operator type
+	FCM_orientationCacheMB, //!< memory budget for orientation density cache
 	FCM_Nnorm, //!< unit cell molecule count constraint
 	//Delimiter used in parsing:
 	FCM_Delim
@@ -284,6 +285,7 @@ EnumStringMap<FluidComponentMember> fcmMap
 	FCM_quad_nAlpha,    "quad_nAlpha",
 	FCM_quad_nGamma,    "quad_nGamma",
 	FCM_translationMode,"translation",
+	FCM_orientationCacheMB,"orientationCacheMB",
 	FCM_Nnorm,          "Nnorm"
 );
 EnumStringMap<FluidComponentMember> fcmDescMap
@@ -303,6 +305,7 @@ EnumStringMap<FluidComponentMember> fcmDescMap
 	FCM_quad_nAlpha, "number of alpha samples for Euler quadrature",
 	FCM_quad_nGamma, "number of gamma samples for Euler quadrature",
 	FCM_translationMode, "translation operator type: " + addDescriptions(translationModeMap.optionList(), nullDescription, "\n   - "),
+	FCM_orientationCacheMB, "memory budget per process (in MB) for per-thread accumulators of the orientation loops, and then for caching orientation densities between free energy and gradient evaluations (default 0: serial orientation loop without cache)",
 	FCM_Nnorm, "unit cell molecule count constraint"
 );
 
@@ -403,6 +406,7 @@ public:
 				READ_AND_CHECK(quad_nAlpha, >=, 0u)
 				READ_AND_CHECK(quad_nGamma, >=, 0u)
 				READ_ENUM(translationMode, FluidComponent::LinearSpline)
+				READ_AND_CHECK(orientationCacheMB, >=, 0.)
 				READ_AND_CHECK(Nnorm, >=, 0.)
 				case FCM_Delim: return; //end of input
 			}
@@ -440,6 +444,7 @@ public:
 			PRINT_UINT(quad_nAlpha)
 			PRINT_UINT(quad_nGamma)
 			PRINT_ENUM(translationMode)
+			PRINT(orientationCacheMB)
 			PRINT(Nnorm)
 		}
 		#undef PRINT
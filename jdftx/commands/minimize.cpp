@@ -40,6 +40,7 @@ enum MinimizeParamsMember
 	MPM_linminMethod,
 	MPM_nIterations,
 	MPM_history,
+	MPM_nRecycle,
 	MPM_knormThreshold,
 	MPM_energyDiffThreshold,
 	MPM_nEnergyDiff,
@@ -60,6 +61,7 @@ EnumStringMap<MinimizeParamsMember> mpmMap
 	MPM_linminMethod, "linminMethod",
 	MPM_nIterations, "nIterations",
 	MPM_history, "history",
+	MPM_nRecycle, "nRecycle",
 	MPM_knormThreshold, "knormThreshold",
 	MPM_energyDiffThreshold, "energyDiffThreshold",
 	MPM_nEnergyDiff, "nEnergyDiff",
@@ -78,6 +80,7 @@ EnumStringMap<MinimizeParamsMember> mpmDescMap
 	MPM_linminMethod, linminMap.optionList() + " (line minimization method)",
 	MPM_nIterations, "maximum iterations (single point calculation if 0)",
 	MPM_history, "number of past states and gradients retained for L-BFGS",
+	MPM_nRecycle, "dimension of subspace recycled from each linear solve to deflate the next one (linear fluids only; 0 to disable)",
 	MPM_knormThreshold, "convergence threshold for gradient (preconditioned) norm",
 	MPM_energyDiffThreshold, "convergence threshold for energy difference between successive iterations",
 	MPM_nEnergyDiff, "number of iteration pairs that must satisfy energyDiffThreshold",
@@ -112,6 +115,7 @@ void CommandMinimize::process(ParamList& pl, Everything& e)
 			case MPM_linminMethod: pl.get(mp.linminMethod, MinimizeParams::Quad, linminMap, "linminMethod", true); break;
 			case MPM_nIterations: pl.get(mp.nIterations, 0, "nIterations", true); break;
 			case MPM_history: pl.get(mp.history, 0, "history", true); break;
+			case MPM_nRecycle: pl.get(mp.nRecycle, 0, "nRecycle", true); break;
 			case MPM_knormThreshold: pl.get(mp.knormThreshold, 0., "knormThreshold", true); break;
 			case MPM_energyDiffThreshold: pl.get(mp.energyDiffThreshold, 0., "energyDiffThreshold", true); break;
 			case MPM_nEnergyDiff: pl.get(mp.nEnergyDiff, 0, "nEnergyDiff", true); break;
@@ -135,6 +139,7 @@ void CommandMinimize::printStatus(Everything& e, int iRep)
 	logPrintf(" \\\n\tlinminMethod         %s", linminMap.getString(mp.linminMethod));
 	logPrintf(" \\\n\tnIterations          %d", mp.nIterations);
 	logPrintf(" \\\n\thistory              %d", mp.history);
+	logPrintf(" \\\n\tnRecycle             %d", mp.nRecycle);
 	logPrintf(" \\\n\tknormThreshold       %lg", mp.knormThreshold);
 	logPrintf(" \\\n\tenergyDiffThreshold  %lg", mp.energyDiffThreshold);
 	logPrintf(" \\\n\tnEnergyDiff          %d", mp.nEnergyDiff);
@@ -110,6 +110,7 @@ enum PCMparameter
 	PCMp_pCavity, //!< sensitivity of cavity to surface electric fields [e-a0/Eh] in CANDLE
 	PCMp_Ztot, //! Total valence charge on the solvent, used by CANDLE
 	PCMp_screenOverride, //! Overrides screening length
+	PCMp_multigridLevels, //!< number of coarse levels in the multigrid preconditioner for LinearPCM and SaLSA
 	PCMp_Delim //!< Delimiter used in parsing
 };
 EnumStringMap<PCMparameter> pcmParamMap
@@ -132,7 +133,8 @@ EnumStringMap<PCMparameter> pcmParamMap
 	PCMp_sqrtC6eff, "sqrtC6eff",
 	PCMp_pCavity, "pCavity",
 	PCMp_Ztot, "Ztot",
-	PCMp_screenOverride, "screenOverride"
+	PCMp_screenOverride, "screenOverride",
+	PCMp_multigridLevels, "multigridLevels"
 );
 EnumStringMap<PCMparameter> pcmParamDescMap
 (	PCMp_lMax, "angular momentum truncation in SaLSA",
@@ -154,7 +156,8 @@ EnumStringMap<PCMparameter> pcmParamDescMap
 	PCMp_sqrtC6eff, "sqrt(effective molecule C6 coefficient) for CANDLE",
 	PCMp_pCavity, "sensitivity of cavity to surface electric fields [a.u.] in CANDLE",
 	PCMp_Ztot, "total valence charge on the solvent, used by CANDLE",
-	PCMp_screenOverride, "overrides the screening length calculated from fluid-components"
+	PCMp_screenOverride, "overrides the screening length calculated from fluid-components",
+	PCMp_multigridLevels, "number of coarse levels in the geometric multigrid preconditioner for LinearPCM (including NonlinearPCM with SCF) and SaLSA (default: 0 => diagonal preconditioner)"
 );
 
 struct CommandPcmParams : public Command
@@ -202,6 +205,7 @@ struct CommandPcmParams : public Command
 				READ_AND_CHECK(pCavity, <, DBL_MAX)
 				READ_AND_CHECK(Ztot, >, 0.)
 				READ_AND_CHECK(screenOverride, >, 0.)
+				READ_AND_CHECK(multigridLevels, >=, 0)
 				case PCMp_Delim: return; //end of input
 			}
 			#undef READ_AND_CHECK
@@ -231,6 +235,7 @@ struct CommandPcmParams : public Command
 		PRINT(pCavity)
 		PRINT(Ztot)
 		PRINT(screenOverride)
+		logPrintf(" \\\n\tmultigridLevels %d", fsp.multigridLevels);
 		#undef PRINT
 	}
 }
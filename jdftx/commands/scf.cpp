@@ -28,7 +28,9 @@ enum PulayParamsMember
 	PPM_residualThreshold,
 	PPM_mixFraction,
 	PPM_qMetric,
-	PPM_history
+	PPM_history,
+	PPM_algorithm,
+	PPM_pulayPeriod
 };
 
 EnumStringMap<PulayParamsMember> pulayParamsMap
@@ -37,7 +39,9 @@ EnumStringMap<PulayParamsMember> pulayParamsMap
 	PPM_residualThreshold, "residualThreshold",
 	PPM_mixFraction, "mixFraction",
 	PPM_qMetric, "qMetric",
-	PPM_history, "history"
+	PPM_history, "history",
+	PPM_algorithm, "algorithm",
+	PPM_pulayPeriod, "pulayPeriod"
 );
 
 EnumStringMap<PulayParamsMember> pulayParamsDescMap
@@ -46,7 +50,14 @@ EnumStringMap<PulayParamsMember> pulayParamsDescMap
 	PPM_residualThreshold, "convergence threshold for the residual in the mixed variable",
 	PPM_mixFraction, "mix fraction (default 0.5)",
 	PPM_qMetric, "wavevector controlling the metric for overlaps (default: 0.8 bohr^-1)",
-	PPM_history, "number of past residuals that are cached and used for mixing"
+	PPM_history, "number of past residuals that are cached and used for mixing",
+	PPM_algorithm, "extrapolation scheme: Pulay (default) or Broyden (Johnson's modified Broyden)",
+	PPM_pulayPeriod, "extrapolate from history only every pulayPeriod cycles and mix linearly in between (default: 1)"
+);
+
+EnumStringMap<PulayParams::Algorithm> pulayAlgorithmMap
+(	PulayParams::PA_Pulay, "Pulay",
+	PulayParams::PA_Broyden, "Broyden"
 );
 
 //Base class for pulay-mixing commands
@@ -74,6 +85,8 @@ protected:
 					case PPM_mixFraction: pl.get(pp.mixFraction, 0.5, "mixFraction", true); break;
 					case PPM_qMetric: pl.get(pp.qMetric, 0.8, "qMetric", true); break;
 					case PPM_history: pl.get(pp.history, 10, "history", true); if(pp.history<1) throw string("<history> must be >= 1"); break;
+					case PPM_algorithm: pl.get(pp.algorithm, PulayParams::PA_Pulay, pulayAlgorithmMap, "algorithm", true); break;
+					case PPM_pulayPeriod: pl.get(pp.pulayPeriod, 1, "pulayPeriod", true); if(pp.pulayPeriod<1) throw string("<pulayPeriod> must be >= 1"); break;
 				}
 			}
 			else process_sub(keyStr, pl, e);
@@ -89,6 +102,8 @@ protected:
 		PRINT(mixFraction, %lg)
 		PRINT(qMetric, %lg)
 		PRINT(history, %d)
+		logPrintf(" \\\n\talgorithm\t%s", pulayAlgorithmMap.getString(pp.algorithm));
+		PRINT(pulayPeriod, %d)
 		#undef PRINT
 	}
 	
@@ -66,6 +66,8 @@ struct CoulombParams
 	std::set<double> omegaSet; //!< set of exchange erf-screening parameters
 	std::shared_ptr<struct Supercell> supercell; //!< Description of k-point supercell for exchange
 	
+	string kernelCacheDir; //!< directory for on-disk cache of numerically computed kernels (disabled if empty)
+	
 	CoulombParams();
 	
 	//! Create a Coulomb object corresponding to the parameters of this class
@@ -77,7 +77,7 @@ struct EwaldIsolated : public Ewald
 CoulombIsolated::CoulombIsolated(const GridInfo& gInfoOrig, const CoulombParams& params)
 : Coulomb(gInfoOrig, params), ws(gInfo.R), Vc(gInfo)
 {	//Compute kernel:
-	CoulombKernel(gInfo.R, gInfo.S, params.isTruncated()).compute(Vc.data(), ws);
+	CoulombKernel(gInfo.R, gInfo.S, params.isTruncated()).compute(Vc.data(), ws, params.kernelCacheDir);
 	initExchangeEval();
 }
 
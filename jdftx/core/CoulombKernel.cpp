@@ -24,6 +24,11 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/ManagedMemory.h>
 #include <core/Thread.h>
 #include <cfloat>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 const double CoulombKernel::nSigmasPerWidth = 1.+sqrt(-2.*log(DBL_EPSILON)); //gaussian negligible at double precision (+1 sigma for safety)
 
@@ -33,8 +38,19 @@ CoulombKernel::CoulombKernel(const matrix3<> R, const vector3<int> S, const vect
 }
 
 
-void CoulombKernel::compute(double* data, const WignerSeitz& ws) const
-{	//Count number of truncated directions:
+void CoulombKernel::compute(double* data, const WignerSeitz& ws, string cacheDir) const
+{	size_t nG = S[0] * (S[1] * size_t(1 + S[2]/2));
+	std::shared_ptr<CoulombKernelCache> cache;
+	if(cacheDir.length())
+	{	cache = std::make_shared<CoulombKernelCache>(cacheDir, "CoulombKernel");
+		cache->addKey(R); cache->addKey(S); cache->addKey(isTruncated); cache->addKey(omega);
+		const double* cached = cache->load(nG);
+		if(cached)
+		{	memcpy(data, cached, nG*sizeof(double));
+			return;
+		}
+	}
+	//Count number of truncated directions:
 	int nTruncated = 0;
 	for(int k=0; k<3; k++) if(isTruncated[k]) nTruncated++;
 	//Call appropriate routine:
@@ -43,6 +59,7 @@ void CoulombKernel::compute(double* data, const WignerSeitz& ws) const
 		case 3: computeIsolated(data, ws); break;
 		default: assert(!"Invalid truncated direction count");
 	}
+	if(cache) cache->save(data, nG);
 }
 
 //! Compute erfc(omega r)/r - erfc(a r)/r
@@ -286,3 +303,93 @@ void CoulombKernel::computeWire(double* data, const WignerSeitz& ws) const
 	fftw_destroy_plan(fftPlanR2C);
 	logPrintf("Done.\n");
 }
+
+//--------- On-disk kernel cache ---------
+
+static const uint64_t kernelCacheMagic = 0x4A44465478434B32ULL; //identifies cache file format (and byte order)
+
+//File layout: magic, nKeyBytes, nData, key (zero-padded to multiple of 8 bytes), data
+inline size_t kernelCacheHeaderBytes(size_t nKeyBytes)
+{	return 3*sizeof(uint64_t) + 8*((nKeyBytes+7)/8);
+}
+
+CoulombKernelCache::CoulombKernelCache(string cacheDir, string kind)
+: cacheDir(cacheDir), kind(kind), hash(14695981039346656037ULL), mapped(0), mappedBytes(0)
+{	addKeyBytes(kind.data(), kind.length());
+}
+
+CoulombKernelCache::~CoulombKernelCache()
+{	if(mapped) munmap(mapped, mappedBytes);
+}
+
+void CoulombKernelCache::addKeyBytes(const void* data, size_t nBytes)
+{	const unsigned char* bytes = (const unsigned char*)data;
+	key.insert(key.end(), bytes, bytes+nBytes);
+	for(size_t i=0; i<nBytes; i++)
+	{	hash ^= bytes[i];
+		hash *= 1099511628211ULL; //FNV-1a prime
+	}
+}
+
+void CoulombKernelCache::addKey(const double* data, size_t n)
+{	for(size_t i=0; i<n; i++)
+	{	double x = data[i] ? data[i] : 0.; //make -0 and +0 equivalent
+		addKeyBytes(&x, sizeof(double));
+	}
+}
+
+void CoulombKernelCache::addKey(const int* data, size_t n)
+{	addKeyBytes(data, n*sizeof(int));
+}
+
+string CoulombKernelCache::filename() const
+{	char hashStr[17]; sprintf(hashStr, "%016llx", (unsigned long long)hash);
+	return cacheDir + "/" + kind + "-" + hashStr + ".bin";
+}
+
+const double* CoulombKernelCache::load(size_t nData)
+{	if(mapped) { munmap(mapped, mappedBytes); mapped = 0; }
+	string fname = filename();
+	const size_t headerBytes = kernelCacheHeaderBytes(key.size());
+	size_t nBytes = headerBytes + nData*sizeof(double);
+	if(fileSize(fname.c_str()) != off_t(nBytes)) return 0; //missing or mismatched
+	int fd = open(fname.c_str(), O_RDONLY);
+	if(fd < 0) return 0;
+	void* ptr = mmap(0, nBytes, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); //mapping persists after close
+	if(ptr == MAP_FAILED) return 0;
+	const uint64_t* header = (const uint64_t*)ptr;
+	if(header[0]!=kernelCacheMagic || header[1]!=key.size() || header[2]!=nData
+		|| memcmp(header+3, key.data(), key.size()))
+	{	logPrintf("Ignoring cache file '%s' with mismatched parameters; recomputing %s.\n", fname.c_str(), kind.c_str());
+		munmap(ptr, nBytes);
+		return 0;
+	}
+	mapped = ptr; mappedBytes = nBytes;
+	logPrintf("Loaded %s from cache file '%s'.\n", kind.c_str(), fname.c_str());
+	return (const double*)((const char*)ptr + headerBytes);
+}
+
+void CoulombKernelCache::save(const double* data, size_t nData) const
+{	if(!mpiWorld->isHead()) return;
+	mkdir(cacheDir.c_str(), 0755); //ignore failure (typically because it already exists)
+	string fname = filename();
+	ostringstream ossTmp; ossTmp << fname << ".tmp" << getpid();
+	string fnameTmp = ossTmp.str();
+	FILE* fp = fopen(fnameTmp.c_str(), "wb");
+	if(!fp) { logPrintf("WARNING: could not write kernel cache file '%s'.\n", fnameTmp.c_str()); return; }
+	std::vector<unsigned char> header(kernelCacheHeaderBytes(key.size()), 0);
+	uint64_t* headerInts = (uint64_t*)header.data();
+	headerInts[0] = kernelCacheMagic;
+	headerInts[1] = key.size();
+	headerInts[2] = nData;
+	memcpy(headerInts+3, key.data(), key.size());
+	bool ok = (fwrite(header.data(), 1, header.size(), fp) == header.size()) && (fwrite(data, sizeof(double), nData, fp) == nData);
+	ok = (fclose(fp)==0) && ok;
+	if(ok && rename(fnameTmp.c_str(), fname.c_str())==0)
+		logPrintf("Saved %s to cache file '%s'.\n", kind.c_str(), fname.c_str());
+	else
+	{	unlink(fnameTmp.c_str());
+		logPrintf("WARNING: could not write kernel cache file '%s'.\n", fname.c_str());
+	}
+}
@@ -23,6 +23,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/WignerSeitz.h>
 #include <core/matrix3.h>
 #include <core/string.h>
+#include <cstdint>
 
 //! @addtogroup LongRange
 //! @{
@@ -42,7 +43,8 @@ struct CoulombKernel
 	//! ws is the Wigner-Seitz cell corresponding to lattice vectors R.
 	//!      Supported modes include fully truncated (Isolated or Wigner-Seitz
 	//! truncated exchange kernel) and one direction periodic (Wire geometry).
-	void compute(double* data, const WignerSeitz& ws) const;
+	//! If cacheDir is non-empty, the kernel is looked up in (and saved to) the on-disk CoulombKernelCache in that directory.
+	void compute(double* data, const WignerSeitz& ws, string cacheDir=string()) const;
 	
 	static const double nSigmasPerWidth; //!< number of sigmas at which gaussian is negligible at working precision
 	
@@ -52,5 +54,42 @@ private:
 	void computeWire(double* data, const WignerSeitz& ws) const; //!< 1 periodic direction
 };
 
+//! Content-addressed on-disk cache for numerically computed kernels.
+//! The file name is a hash of all parameters added using addKey(), so that
+//! identical lattice / grid / truncation settings reuse the kernel across runs.
+//! The full key is also stored in the file header and compared on load, so that hash collisions are recomputed.
+//! Cached kernels are memory-mapped when loaded, so large kernels are only paged in on access.
+class CoulombKernelCache
+{
+public:
+	CoulombKernelCache(string cacheDir, string kind); //!< kind distinguishes types of kernels with otherwise identical parameters
+	~CoulombKernelCache();
+	
+	void addKey(const double* data, size_t n); //!< add parameters to the key (before load or save)
+	void addKey(const int* data, size_t n); //!< add parameters to the key (before load or save)
+	void addKey(double x) { addKey(&x, 1); }
+	void addKey(int i) { addKey(&i, 1); }
+	void addKey(const vector3<>& v) { addKey(&v[0], 3); }
+	void addKey(const vector3<int>& v) { addKey(&v[0], 3); }
+	void addKey(const vector3<bool>& v) { for(int k=0; k<3; k++) addKey(int(v[k])); }
+	void addKey(const matrix3<>& m) { for(int i=0; i<3; i++) addKey(m.row(i)); }
+	void addKey(const matrix3<int>& m) { for(int i=0; i<3; i++) addKey(m.row(i)); }
+	
+	//! Memory-map the cached kernel of length nData, if available.
+	//! Returns null if the kernel is not cached (or has the wrong size or key); the mapping is valid for the lifetime of this object.
+	const double* load(size_t nData);
+	
+	//! Save a kernel of length nData to the cache (from head process only; written to a temporary file and renamed for atomicity)
+	void save(const double* data, size_t nData) const;
+	
+private:
+	string cacheDir, kind;
+	uint64_t hash; //running FNV-1a hash of the key
+	std::vector<unsigned char> key; //full key (stored in file header to verify matches)
+	void* mapped; size_t mappedBytes; //current memory mapping, if any
+	void addKeyBytes(const void* data, size_t nBytes);
+	string filename() const;
+};
+
 //! @}
 #endif // JDFTX_CORE_COULOMBKERNEL_H
@@ -237,7 +237,7 @@ CoulombWire::CoulombWire(const GridInfo& gInfoOrig, const CoulombParams& params)
 {	//Check orthogonality
 	string dirName = checkOrthogonality(gInfo, params.iDir);
 	//Create kernel:
-	CoulombKernel(gInfo.R, gInfo.S, params.isTruncated()).compute(Vc.data(), ws);
+	CoulombKernel(gInfo.R, gInfo.S, params.isTruncated()).compute(Vc.data(), ws, params.kernelCacheDir);
 	initExchangeEval();
 }
 
@@ -195,7 +195,7 @@ void extractExchangeKernel_thread(size_t iStart, size_t iStop, const vector3<>&
 //-------------------- class ExchangeEval -----------------------
 
 ExchangeEval::ExchangeEval(const GridInfo& gInfo, const CoulombParams& params, const Coulomb& coulomb, double omega)
-: gInfo(gInfo), omega(omega), VcGamma(0), kernelData(0)
+: gInfo(gInfo), omega(omega), VcGamma(0), kernelData(0), kernelMapped(0)
 {
 	if(!omega) logPrintf("\n-------- Setting up exchange kernel --------\n");
 	else logPrintf("\n--- Setting up screened exchange kernel (omega = %lg) ---\n", omega);
@@ -428,7 +428,7 @@ ExchangeEval::ExchangeEval(const GridInfo& gInfo, const CoulombParams& params, c
 				die("Exact-exchange in Isolated geometry should be used only with a single k-point.\n");
 			if(omega) //Create an omega-screened version (but gamma-point only):
 			{	VcGamma = new RealKernel(gInfo);
-				CoulombKernel(gInfo.R, gInfo.S, params.isTruncated(), omega).compute(VcGamma->data(), ((CoulombIsolated&)coulomb).ws);
+				CoulombKernel(gInfo.R, gInfo.S, params.isTruncated(), omega).compute(VcGamma->data(), ((CoulombIsolated&)coulomb).ws, params.kernelCacheDir);
 			}
 			else //use the same kernel as hartree/Vloc
 			{	VcGamma = &((CoulombIsolated&)coulomb).Vc; 
@@ -436,10 +436,40 @@ ExchangeEval::ExchangeEval(const GridInfo& gInfo, const CoulombParams& params, c
 			}
 		}
 		case NumericalKernel:
-		{	//Create the kernel on the k-point supercell:
-			vector3<bool> isTruncated = params.exchangeRegularization==CoulombParams::WignerSeitzTruncated
+		{	vector3<bool> isTruncated = params.exchangeRegularization==CoulombParams::WignerSeitzTruncated
 				? vector3<bool>(true, true, true) //All directions truncated for Wigner-Seitz truncated method
 				: params.isTruncated(); //Same truncation geometry as Hartree/Vloc for G=0 based methods
+			
+			//Construct k-point difference mesh:
+			for(const vector3<>& kpoint: kmesh)
+			{	vector3<> dk = kpoint - kmesh.front();
+				for(int k=0; k<3; k++) dk[k] -= floor(dk[k] + 0.5); //reduce to fundamental zone:
+				 dkArr.push_back(dk);
+			}
+			size_t nKernelData = dkArr.size() * gInfo.nr;
+			
+			//Check on-disk cache (keyed by everything that determines the split kernels):
+			if(params.kernelCacheDir.length())
+			{	kernelCache = std::make_shared<CoulombKernelCache>(params.kernelCacheDir, "ExchangeKernel");
+				kernelCache->addKey(gInfo.R); kernelCache->addKey(gInfo.S); kernelCache->addKey(super);
+				kernelCache->addKey(isTruncated); kernelCache->addKey(omega); kernelCache->addKey(VzeroCorrection);
+				kernelCache->addKey(int(params.exchangeRegularization));
+				for(const vector3<>& dk: dkArr) kernelCache->addKey(dk);
+				const double* cached = kernelCache->load(nKernelData);
+				if(cached)
+				{
+					#ifdef GPU_ENABLED
+					kernelData.init(nKernelData);
+					memcpy(kernelData.data(), cached, nKernelData*sizeof(double));
+					kernelCache = 0; //release mapping
+					#else
+					kernelMapped = cached; //paged in lazily on access
+					#endif
+					break;
+				}
+			}
+			
+			//Create the kernel on the k-point supercell:
 			//--- set up supercell sample count:
 			vector3<int> Ssuper(0,0,0), s; //loop over vertices of parallelopiped:
 			for(s[0]=-1; s[0]<=1; s[0]+=2)
@@ -466,22 +496,18 @@ ExchangeEval::ExchangeEval(const GridInfo& gInfo, const CoulombParams& params, c
 			CoulombKernel(Rsuper, Ssuper, isTruncated, omega).compute(dataSuper, wsSuper);
 			dataSuper[0] += VzeroCorrection; //For slab/wire geometry kernels in AuxiliaryFunction/ProbeChargeEwald methods
 			
-			//Construct k-point difference mesh:
-			for(const vector3<>& kpoint: kmesh)
-			{	vector3<> dk = kpoint - kmesh.front();
-				for(int k=0; k<3; k++) dk[k] -= floor(dk[k] + 0.5); //reduce to fundamental zone:
-				 dkArr.push_back(dk);
-			}
-			
 			//Split supercell kernel into one for each k-point difference:
 			logPrintf("Splitting supercell kernel to unit-cell with k-points ... "); logFlush();
-			size_t nKernelData = dkArr.size() * gInfo.nr;
 			kernelData.init(nKernelData);
 			for(size_t i=0; i<dkArr.size(); i++)
 				threadLaunch(extractExchangeKernel_thread, gInfo.nr, dkArr[i],
 					gInfo.S, Ssuper, super, dataSuper, kernelData.data() + i*gInfo.nr);
 			delete[] dataSuper;
 			logPrintf("Done.\n");
+			if(kernelCache)
+			{	kernelCache->save(kernelData.data(), nKernelData);
+				kernelCache = 0;
+			}
 			break;
 		}
 	}
@@ -536,7 +562,8 @@ complexScalarFieldTilde ExchangeEval::operator()(complexScalarFieldTilde&& in, v
 					vector3<int> offset = round(dkArr[ik] - kDiff, &err);
 					assert(err < symmThreshold);
 					//Multiply kernel:
-					multTransformedKernel(in, kernelData.dataPref() + gInfo.nr * ik, offset);
+					const double* kernel = kernelMapped ? kernelMapped : kernelData.dataPref();
+					multTransformedKernel(in, kernel + gInfo.nr * ik, offset);
 					kDiffFound = true;
 					break;
 				}
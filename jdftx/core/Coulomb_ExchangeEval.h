@@ -60,6 +60,8 @@ private:
 	//For precomputed numerical kernel mode:
 	std::vector< vector3<> > dkArr; //list of allowed k-point differences (modulo integer offsets)
 	ManagedArray<double> kernelData; //data for all the kernels
+	std::shared_ptr<class CoulombKernelCache> kernelCache; //on-disk cache holding the memory-mapped kernels (if enabled and found)
+	const double* kernelMapped; //memory-mapped kernel data (used instead of kernelData when available)
 };
 
 //! @}
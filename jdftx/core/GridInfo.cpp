@@ -39,7 +39,8 @@ GridInfo::~GridInfo()
 	if(initialized)
 	{	//Destroy cached FFTW plans, if any:
 		for(auto entry: planCache)
-			fftw_destroy_plan(entry.second);
+			if(entry.second.second) //shared plans are retained till exit
+				fftw_destroy_plan(entry.second.first);
 		//Destroy GPU plans, if any:
 		#ifdef GPU_ENABLED
 		cufftDestroy(planZ2Z);
@@ -271,16 +272,34 @@ void GridInfo::initialize(bool skipHeader, const std::vector<SpaceGroupOp> sym)
 }
 
 std::mutex GridInfo::planLock;
+bool GridInfo::sharePlans = false;
+size_t GridInfo::nPlansReused = 0;
+double GridInfo::planSecSaved = 0.;
+std::map<std::tuple<vector3<int>,GridInfo::PlanType,int>,GridInfo::SharedPlan> GridInfo::sharedPlanCache;
 
 fftw_plan GridInfo::getPlan(GridInfo::PlanType planType, int nThreads) const
 {	//Return cached plan if available:
 	auto key = std::make_pair(planType, nThreads);
+	auto sharedKey = std::make_tuple(S, planType, nThreads);
 	planLock.lock();
 	auto iter = planCache.find(key);
 	if(iter != planCache.end())
 	{	planLock.unlock();
-		return iter->second;
+		return iter->second.first;
 	}
+	if(sharePlans)
+	{	auto sharedIter = sharedPlanCache.find(sharedKey);
+		if(sharedIter != sharedPlanCache.end())
+		{	//Count reuse only on first lookup by this object (subsequent ones are found in planCache above):
+			nPlansReused++;
+			planSecSaved += sharedIter->second.secPlan;
+			fftw_plan plan = sharedIter->second.plan;
+			((GridInfo*)this)->planCache.insert(std::make_pair(key, std::make_pair(plan, false)));
+			planLock.unlock();
+			return plan;
+		}
+	}
+	double tStart = clock_sec();
 	//Create plan:
 	//--- import wisdom if available:
 	fftw_import_system_wisdom();
@@ -313,7 +332,12 @@ fftw_plan GridInfo::getPlan(GridInfo::PlanType planType, int nThreads) const
 	}
 	if(!plan) die("Failed to create FFT plan with %d threads",  nThreads);
 	//--- cache and return plan:
-	((GridInfo*)this)->planCache.insert(std::make_pair(key, plan));
+	if(sharePlans) //retained till exit (not destroyed with this object)
+	{	SharedPlan& sharedPlan = sharedPlanCache[sharedKey];
+		sharedPlan.plan = plan;
+		sharedPlan.secPlan = clock_sec() - tStart;
+	}
+	((GridInfo*)this)->planCache.insert(std::make_pair(key, std::make_pair(plan, !sharePlans)));
 	planLock.unlock();
 	return plan;
 }
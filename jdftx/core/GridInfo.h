@@ -30,6 +30,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <cstdio>
 #include <mutex>
 #include <map>
+#include <tuple>
 
 /** @brief Simulation grid descriptor
 
@@ -119,6 +120,9 @@ public:
 		PlanCtoR, //!< Complex to real transform
 	};
 	fftw_plan getPlan(PlanType planType, int nThreads) const; //get an FFTW plan of specified type with specified thread count
+	static bool sharePlans; //!< if true, FFTW plans are shared (by grid shape) between all GridInfo objects and retained till exit (used for batch runs)
+	static size_t nPlansReused; //!< number of plans retrieved from the shared cache, counted once per GridInfo object (if sharePlans)
+	static double planSecSaved; //!< time (in seconds) saved by reusing shared plans (if sharePlans)
 	#ifdef GPU_ENABLED
 	cufftHandle planZ2Z; //!< CUFFT plan for all the complex transforms
 	cufftHandle planD2Z; //!< CUFFT plan for R -> G
@@ -149,8 +153,10 @@ private:
 	void updateSdependent();
 	
 	//FFTW plans by thread count and type:
-	std::map<std::pair<PlanType,int>,fftw_plan> planCache;
+	std::map<std::pair<PlanType,int>,std::pair<fftw_plan,bool>> planCache; //plan and whether it is owned (destroyed with this object, i.e. not shared)
 	static std::mutex planLock; //Global lock since planner routines are not thread safe
+	struct SharedPlan { fftw_plan plan; double secPlan; }; //shared plan and time taken to create it
+	static std::map<std::tuple<vector3<int>,PlanType,int>,SharedPlan> sharedPlanCache; //plans shared by grid shape, type and thread count (if sharePlans)
 };
 
 //! @}
@@ -223,6 +223,42 @@ void MPIUtil::allReduce(bool* data, size_t nData, MPIUtil::ReduceOp op, bool saf
 	}
 }
 
+#ifdef MPI_ENABLED
+void MPIUtil::allReduceReproducible(void* data, size_t count, MPI_Datatype type, MPI_Op op) const
+{	int typeSize; MPI_Type_size(type, &typeSize);
+	char* dataBytes = (char*)data;
+	//Combine contributions from all processes (in order of rank) into result:
+	auto combine = [&](const char* contrib, size_t chunkSize, char* result)
+	{	std::copy(contrib, contrib+chunkSize*typeSize, result);
+		for(int jProc=1; jProc<nProcs; jProc++)
+			MPI_Reduce_local(contrib + jProc*chunkSize*typeSize, result, chunkSize, type, op); //result = contrib_j op result
+	};
+	if(count*typeSize*nProcs <= (1<<16) || count < size_t(nProcs))
+	{	//Small data: gather all contributions and combine locally (latency bound, one collective):
+		std::vector<char> buf(count*typeSize*nProcs);
+		MPI_Allgather(data, count, type, buf.data(), count, type, comm);
+		combine(buf.data(), count, dataBytes);
+	}
+	else
+	{	//Large data: each process combines one chunk (reduce-scatter implemented with all-to-all), followed by all-gather.
+		//The chunk division and combination order depend only on the number of processes, so results are reproducible.
+		TaskDivision chunkDiv(count, this);
+		std::vector<int> counts(nProcs), offsets(nProcs), myCounts(nProcs), myOffsets(nProcs);
+		int myChunk = chunkDiv.stop() - chunkDiv.start();
+		for(int jProc=0; jProc<nProcs; jProc++)
+		{	counts[jProc] = chunkDiv.stop(jProc) - chunkDiv.start(jProc);
+			offsets[jProc] = chunkDiv.start(jProc);
+			myCounts[jProc] = myChunk;
+			myOffsets[jProc] = jProc * myChunk;
+		}
+		std::vector<char> buf(size_t(myChunk)*typeSize*nProcs);
+		MPI_Alltoallv(data, counts.data(), offsets.data(), type, buf.data(), myCounts.data(), myOffsets.data(), type, comm);
+		combine(buf.data(), myChunk, dataBytes + chunkDiv.start()*typeSize);
+		MPI_Allgatherv(MPI_IN_PLACE, 0, type, data, counts.data(), offsets.data(), type, comm);
+	}
+}
+#endif
+
 void MPIUtil::reduce(bool* data, size_t nData, MPIUtil::ReduceOp op, int root, Request* request) const
 {	if(nProcs>1)
 	{	if(request) throw string("Asynchronous reduce not supported for bool");
@@ -370,3 +406,22 @@ int TaskDivision::whose(size_t q) const
 		return std::upper_bound(stopArr.begin(),stopArr.end(), q) - stopArr.begin();
 	else return 0;
 }
+
+
+//------- class ReductionQueue ---------
+
+ReductionQueue::ReductionQueue(const MPIUtil* mpiUtil) : mpiUtil(mpiUtil)
+{
+}
+
+ReductionQueue::~ReductionQueue()
+{	wait();
+}
+
+void ReductionQueue::wait()
+{	if(!requests.size()) return;
+	static StopWatch watch("ReductionQueue::wait"); watch.start();
+	MPIUtil::waitAll(requests);
+	requests.clear();
+	watch.stop();
+}
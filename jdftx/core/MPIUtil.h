@@ -44,6 +44,7 @@ class MPIUtil
 	int nProcs, iProc;
 	#ifdef MPI_ENABLED
 	MPI_Comm comm;
+	void allReduceReproducible(void* data, size_t count, MPI_Datatype type, MPI_Op op) const; //!< all-reduce in a fixed order on fixed-size chunks (used by safe mode)
 	#endif
 public:
 	int iProcess() const { return iProc; } //!< rank of current process
@@ -99,7 +100,8 @@ public:
 	void bcast(bool* data, size_t nData, int root=0, Request* request=0) const; //!< specialization for bool which is not natively supported by MPI
 	void bcast(string& s, int root=0, Request* request=0) const; //!< broadcast string
 
-	//AllReduce functions (safe mode gaurantees identical results irrespective of round-off (but could be slower)):
+	//AllReduce functions (safe mode gaurantees identical results irrespective of round-off on all processes,
+	//and across runs with the same number of processes; its cost is comparable to the native allreduce):
 	enum ReduceOp { ReduceMin, ReduceMax, ReduceSum, ReduceProd, ReduceLAnd, ReduceBAnd, ReduceLOr, ReduceBOr, ReduceLXor, ReduceBXor };
 	template<typename T> void allReduceData(ManagedMemory<T>& v, ReduceOp op, bool safeMode=false, Request* request=0) const; //!< managed memory reduction
 	template<typename T> void allReduceData(std::vector<T>& v, ReduceOp op, bool safeMode=false, Request* request=0) const; //!< vector reduction
@@ -154,6 +156,29 @@ private:
 	std::vector<size_t> stopArr; //!< array of sttop values for other processes
 };
 
+//! Schedule of non-blocking reductions, started as soon as each piece of data is ready,
+//! and completed together when the results are first needed (or on destruction).
+//! The data must not be accessed (or freed) between start and completion.
+class ReductionQueue
+{
+public:
+	ReductionQueue(const MPIUtil* mpiUtil);
+	~ReductionQueue(); //!< completes any pending reductions
+	
+	//! Start (non-blocking) all-reduce of field data v (any class with an allReduceData member, such as ScalarFieldData)
+	template<typename FieldData> void allReduceData(FieldData& v, MPIUtil::ReduceOp op)
+	{	if(mpiUtil->nProcesses() == 1) return; //nothing to reduce
+		requests.push_back(MPIUtil::Request());
+		v.allReduceData(mpiUtil, op, false, &requests.back());
+	}
+	
+	void wait(); //!< complete all pending reductions
+	bool pending() const { return requests.size(); } //!< whether any reductions are still in progress
+private:
+	const MPIUtil* mpiUtil;
+	std::vector<MPIUtil::Request> requests;
+};
+
 //! @}
 
 //-------------------------- Template implementations ------------------------------------
@@ -303,10 +328,9 @@ template<typename T> void MPIUtil::allReduce(T* data, size_t nData, MPIUtil::Red
 {	using namespace MPIUtilPrivate;
 	#ifdef MPI_ENABLED
 	if(nProcs>1)
-	{	if(safeMode) //Reduce to root node and then broadcast result (to ensure identical values)
-		{	MPI_Reduce(isHead()?MPI_IN_PLACE:data, data, DataType<T>::nElem*nData, DataType<T>::get(), mpiOp(op), 0, comm);
-			bcast(data, nData, 0);
-			if(request) throw string("Asynchronous allReduce not supported in safeMode");
+	{	if(safeMode) //Reduce in a fixed order and distribute result (to ensure identical, reproducible values)
+		{	if(request) throw string("Asynchronous allReduce not supported in safeMode");
+			allReduceReproducible(data, DataType<T>::nElem*nData, DataType<T>::get(), mpiOp(op));
 		}
 		else //standard Allreduce
 		{		
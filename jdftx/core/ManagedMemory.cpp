@@ -259,8 +259,36 @@ namespace MemPool
 
 //---------- class ManagedMemoryBase -----------
 
+namespace MemUsageReport
+{
+	std::mutex cacheLock;
+	std::map<const ManagedMemoryBase::CacheStats*,string>& caches() { static std::map<const ManagedMemoryBase::CacheStats*,string> cacheMap; return cacheMap; }
+}
+
 void ManagedMemoryBase::reportUsage()
 {	MemUsageReport::manager(MemUsageReport::Print);
+	//Report registered caches:
+	const double bytesToGB = 1./pow(1024.,3);
+	MemUsageReport::cacheLock.lock();
+	for(auto entry: MemUsageReport::caches())
+	{	const CacheStats& stats = *(entry.first);
+		logPrintf("CACHE: %30s %12.6lf GB peak (budget: ", entry.second.c_str(), stats.nBytesPeak * bytesToGB);
+		if(stats.nBytesBudget) logPrintf("%.6lf GB", stats.nBytesBudget * bytesToGB); else logPrintf("unlimited");
+		logPrintf("), %lu hits, %lu misses, %lu evictions\n", stats.nHits, stats.nMisses, stats.nEvictions);
+	}
+	MemUsageReport::cacheLock.unlock();
+}
+
+void ManagedMemoryBase::registerCache(string name, const CacheStats* stats)
+{	MemUsageReport::cacheLock.lock();
+	MemUsageReport::caches()[stats] = name;
+	MemUsageReport::cacheLock.unlock();
+}
+
+void ManagedMemoryBase::unregisterCache(const CacheStats* stats)
+{	MemUsageReport::cacheLock.lock();
+	MemUsageReport::caches().erase(stats);
+	MemUsageReport::cacheLock.unlock();
 }
 
 //Free memory
@@ -35,6 +35,15 @@ class ManagedMemoryBase
 {
 public:
 	static void reportUsage(); //!< print memory usage report
+	
+	//! Usage statistics of a cache of managed-memory objects
+	struct CacheStats
+	{	size_t nHits, nMisses, nEvictions; //!< number of lookups that succeeded / failed, and number of entries evicted
+		size_t nBytes, nBytesPeak, nBytesBudget; //!< current, peak and maximum allowed (0 => unlimited) size of cached data
+		CacheStats() : nHits(0), nMisses(0), nEvictions(0), nBytes(0), nBytesPeak(0), nBytesBudget(0) {}
+	};
+	static void registerCache(string name, const CacheStats* stats); //!< include statistics of a cache in reportUsage (stats must remain valid until then, or until unregistered)
+	static void unregisterCache(const CacheStats* stats); //!< remove a cache registered using registerCache
 
 protected:
 	ManagedMemoryBase(): nBytes(0),c(0),onGpu(false) {} //!< Initialize a valid state, but don't allocate anything
@@ -22,6 +22,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <core/MinimizeParams.h>
 #include <core/Util.h>
+#include <core/matrix.h>
 #include <deque>
 #include <cmath>
 #include <cfloat>
@@ -97,8 +98,39 @@ template<typename Vector> struct LinearSolvable
 	virtual double sync(double x) const { return x; }
 	
 	//! Solve the linear system hessian * state == rhs using conjugate gradients:
+	//! The current state serves as the initial guess. If MinimizeParams::nRecycle > 0, this is deflated CG
+	//! with a recycled subspace W of nRecycle approximate eigenvectors of the preconditioned hessian,
+	//! corresponding to its smallest eigenvalues, extracted from the previous solve. The initial guess is
+	//! corrected by a Galerkin projection onto W, and every search direction is made hessian-conjugate to W.
+	//! Each solve costs nRecycle additional hessian and preconditioner applications,
+	//! and holds upto 5*nRecycle additional vectors (nRecycle of which are retained between solves).
 	//! @return the number of iterations taken to achieve target tolerance
 	int solve(const Vector& rhs, const MinimizeParams& params);
+	
+	LinearSolvable() : logRatePrev(0.) {}
+	
+	void clearRecycle() { recycleU.clear(); } //!< Discard recycled subspace
+	
+private:
+	std::vector<Vector> recycleU; //!< approximate eigenvectors retained from the previous solve for deflation
+	double logRatePrev; //!< average log reduction of sqrt(|r.z|) per iteration in previous solve (to estimate savings)
+	
+	//! Set W to a hessian-orthonormal basis of recycleU and AW to its image under the current hessian,
+	//! correct the initial guess by projection onto W and update residual r, preconditioned residual z and r.z
+	void deflateInit(std::vector<Vector>& W, std::vector<Vector>& AW, Vector& r, Vector& z, double& rdotz, const MinimizeParams& p);
+	
+	//! Make d hessian-conjugate to W: d -= W (AW)^T d
+	void deflate(Vector& d, const std::vector<Vector>& W, const std::vector<Vector>& AW) const;
+	
+	//! Set recycleU to the Ritz vectors of the preconditioned hessian for its nRecycle smallest eigenvalues
+	//! within the span of W and the first search directions P of this solve, given the images AP and MAP of P
+	//! under the hessian and the preconditioned hessian respectively
+	void recycleRitz(const std::vector<Vector>& W, const std::vector<Vector>& AW,
+		const std::vector<Vector>& P, const std::vector<Vector>& AP, const std::vector<Vector>& MAP, const MinimizeParams& p);
+	
+	//! Return T such that T^T G T = identity, for symmetric positive semi-definite G,
+	//! dropping directions that are (nearly) linearly dependent relative to their norm
+	static matrix orthonormalizer(const matrix& G);
 };
 
 
@@ -308,40 +340,175 @@ template<typename Vector> int LinearSolvable<Vector>::solve(const Vector& rhs, c
 	Vector r = clone(rhs); axpy(-1.0, hessian(state), r); //residual r = rhs - A.state;
 	Vector z = precondition(r), d = r; //the preconditioned residual and search direction
 	double beta=0.0, rdotzPrev=0.0, rdotz = sync(dot(r, z));
+	std::vector<Vector> W, AW; //deflation subspace and its image under hessian
+	if(p.nRecycle <= 0) clearRecycle();
+	if(recycleU.size()) deflateInit(W, AW, r, z, rdotz, p);
 
 	//Check initial residual
 	double rzNorm = sqrt(fabs(rdotz)/p.nDim);
+	const double rzNormInitial = rzNorm;
 	fprintf(p.fpLog, "%sInitial:  sqrt(|r.z|): %12.6le\n", p.linePrefix, rzNorm); fflush(p.fpLog);
-	if(rzNorm<p.knormThreshold) { fprintf(p.fpLog, "%sConverged sqrt(r.z)<%le\n", p.linePrefix, p.knormThreshold); fflush(p.fpLog); return 0; }
-
+	bool converged = (rzNorm<p.knormThreshold);
+	
 	//Main loop:
-	int iter;
-	for(iter=0; iter<p.nIterations && !killFlag; iter++)
+	int iter = 0;
+	std::vector<Vector> P, AP, MAP; //first nRecycle search directions and their images under hessian and preconditioned hessian
+	for(; iter<p.nIterations && !converged && !killFlag; iter++)
 	{	//Update search direction:
 		if(rdotzPrev)
 		{	beta = rdotz/rdotzPrev;
 			d *= beta; axpy(1.0, z, d); // d = z + beta*d
 		}
 		else d = clone(z); //fresh search direction (along gradient)
+		if(W.size()) deflate(d, W, AW);
 		//Step:
 		Vector w = hessian(d);
 		double alpha = rdotz/sync(dot(w,d));
 		axpy(alpha, d, state);
 		axpy(-alpha, w, r);
+		bool retain = (int(P.size()) < p.nRecycle); //retain first search directions for the recycled subspace
+		Vector zPrev; if(retain) zPrev = z;
 		z = precondition(r);
 		rdotzPrev = rdotz;
 		rdotz = sync(dot(r, z));
+		if(retain)
+		{	Vector MAd = clone(zPrev); axpy(-1.0, z, MAd); MAd *= 1./alpha; //M.A.d = (z_prev - z)/alpha
+			P.push_back(clone(d));
+			AP.push_back(w);
+			MAP.push_back(MAd);
+		}
 		//Print info:
-		double rzNorm = sqrt(fabs(rdotz)/p.nDim);
+		rzNorm = sqrt(fabs(rdotz)/p.nDim);
 		fprintf(p.fpLog, "%sIter: %3d  sqrt(|r.z|): %12.6le  alpha: %12.6le  beta: %13.6le  t[s]: %9.2lf\n",
 			p.linePrefix, iter, rzNorm, alpha, beta, clock_sec()); fflush(p.fpLog);
-		//Check convergence:
-		if(rzNorm<p.knormThreshold) { fprintf(p.fpLog, "%sConverged sqrt(r.z)<%le\n", p.linePrefix, p.knormThreshold); fflush(p.fpLog); return iter; }
+		converged = (rzNorm<p.knormThreshold);
+	}
+	if(converged) { fprintf(p.fpLog, "%sConverged sqrt(r.z)<%le\n", p.linePrefix, p.knormThreshold); fflush(p.fpLog); }
+	else { fprintf(p.fpLog, "%sGradient did not converge within threshold in %d iterations\n", p.linePrefix, iter); fflush(p.fpLog); }
+	if(iter) logRatePrev = log(rzNormInitial/rzNorm) / iter;
+	
+	//Extract recycled subspace for next solve:
+	if(p.nRecycle > 0)
+	{	if(P.size()) recycleRitz(W, AW, P, AP, MAP, p);
+		else recycleU = W; //no new directions: retain current subspace
 	}
-	fprintf(p.fpLog, "%sGradient did not converge within threshold in %d iterations\n", p.linePrefix, iter); fflush(p.fpLog);
 	return iter;
 }
 
+template<typename Vector> void LinearSolvable<Vector>::deflateInit(std::vector<Vector>& W, std::vector<Vector>& AW, Vector& r, Vector& z, double& rdotz, const MinimizeParams& p)
+{	//Apply current hessian to recycled vectors U:
+	int nU = recycleU.size();
+	std::vector<Vector> AU(nU);
+	for(int i=0; i<nU; i++)
+		AU[i] = hessian(recycleU[i]);
+	matrix UtAU(nU, nU);
+	for(int i=0; i<nU; i++)
+		for(int j=0; j<=i; j++)
+		{	double UtAUij = 0.5*sync(dot(recycleU[i], AU[j]) + dot(recycleU[j], AU[i])); //symmetrize
+			UtAU.set(i,j, UtAUij);
+			UtAU.set(j,i, UtAUij);
+		}
+	//Hessian-orthonormalize:
+	matrix T = orthonormalizer(UtAU);
+	W.assign(T.nCols(), Vector());
+	AW.assign(T.nCols(), Vector());
+	for(int k=0; k<T.nCols(); k++)
+		for(int i=0; i<nU; i++)
+		{	double c = T(i,k).real();
+			axpy(c, recycleU[i], W[k]);
+			axpy(c, AU[i], AW[k]);
+		}
+	AU.clear();
+	recycleU.clear();
+	
+	//Galerkin correction of initial guess: state += W W^T r, r -= AW W^T r
+	double rzNorm = sqrt(fabs(rdotz)/p.nDim);
+	for(size_t k=0; k<W.size(); k++)
+	{	double c = sync(dot(W[k], r));
+		axpy(c, W[k], state);
+		axpy(-c, AW[k], r);
+	}
+	z = precondition(r);
+	rdotz = sync(dot(r, z));
+	double rzNormNew = sqrt(fabs(rdotz)/p.nDim);
+	double nItersSaved = (logRatePrev>0. && rzNormNew>0.) ? log(rzNorm/rzNormNew)/logRatePrev : 0.;
+	fprintf(p.fpLog, "%sDeflating %d recycled directions: initial sqrt(|r.z|) reduced from %12.6le to %12.6le (saved ~%.0lf iterations)\n",
+		p.linePrefix, int(W.size()), rzNorm, rzNormNew, nItersSaved);
+	fflush(p.fpLog);
+}
+
+template<typename Vector> void LinearSolvable<Vector>::deflate(Vector& d, const std::vector<Vector>& W, const std::vector<Vector>& AW) const
+{	for(size_t k=0; k<W.size(); k++)
+		axpy(-sync(dot(AW[k], d)), W[k], d);
+}
+
+template<typename Vector> void LinearSolvable<Vector>::recycleRitz(const std::vector<Vector>& W, const std::vector<Vector>& AW,
+	const std::vector<Vector>& P, const std::vector<Vector>& AP, const std::vector<Vector>& MAP, const MinimizeParams& p)
+{	//Subspace Z = [W, P] and its images AZ, MAZ:
+	int nW = W.size(), nZ = nW + P.size();
+	auto Z = [&](int i) -> const Vector& { return i<nW ? W[i] : P[i-nW]; };
+	auto AZ = [&](int i) -> const Vector& { return i<nW ? AW[i] : AP[i-nW]; };
+	//Projected hessian Z^T A Z and preconditioned-hessian (AZ)^T M (AZ):
+	matrix G(nZ, nZ), F(nZ, nZ);
+	for(int j=0; j<nZ; j++)
+	{	Vector MAWj; if(j<nW) MAWj = precondition(AW[j]); //not stored for W
+		const Vector& MAZj = j<nW ? MAWj : MAP[j-nW];
+		for(int i=0; i<nZ; i++)
+		{	G.set(i,j, sync(dot(Z(i), AZ(j))));
+			F.set(i,j, sync(dot(AZ(i), MAZj)));
+		}
+	}
+	G = 0.5*(G + dagger(G)); //symmetrize
+	F = 0.5*(F + dagger(F));
+	//Solve the generalized eigenproblem F y = lambda G y:
+	matrix T = orthonormalizer(G);
+	matrix evecs; diagMatrix eigs;
+	(dagger(T) * F * T).diagonalize(evecs, eigs);
+	std::vector<int> order(eigs.size());
+	for(size_t k=0; k<order.size(); k++) order[k] = k;
+	std::sort(order.begin(), order.end(), [&](int k1, int k2) { return eigs[k1] < eigs[k2]; });
+	matrix Y = T * evecs;
+	//Retain vectors corresponding to smallest eigenvalues:
+	int nU = std::min(p.nRecycle, int(order.size()));
+	recycleU.assign(nU, Vector());
+	for(int k=0; k<nU; k++)
+		for(int i=0; i<nZ; i++)
+			axpy(Y(i,order[k]).real(), Z(i), recycleU[k]);
+	if(nU)
+	{	fprintf(p.fpLog, "%sRecycling %d approximate eigenvectors of the preconditioned hessian (eigenvalues %le to %le)\n",
+			p.linePrefix, nU, eigs[order[0]], eigs[order[nU-1]]);
+		fflush(p.fpLog);
+	}
+}
+
+template<typename Vector> matrix LinearSolvable<Vector>::orthonormalizer(const matrix& G)
+{	//Scale each direction to unit norm first, so that the cutoff is insensitive to their magnitudes:
+	int n = G.nRows();
+	diagMatrix s(n);
+	for(int i=0; i<n; i++)
+	{	double Gii = G(i,i).real();
+		s[i] = Gii>0. ? 1./sqrt(Gii) : 0.;
+	}
+	matrix Gs(n, n);
+	for(int i=0; i<n; i++)
+		for(int j=0; j<n; j++)
+			Gs.set(i,j, s[i] * G(i,j).real() * s[j]);
+	matrix evecs; diagMatrix eigs;
+	Gs.diagonalize(evecs, eigs);
+	double eigMax = *std::max_element(eigs.begin(), eigs.end());
+	std::vector<int> keep;
+	for(int k=0; k<n; k++)
+		if(eigs[k] > 1e-10*eigMax)
+			keep.push_back(k);
+	matrix T(n, keep.size());
+	for(size_t kk=0; kk<keep.size(); kk++)
+	{	int k = keep[kk];
+		for(int i=0; i<n; i++)
+			T.set(i,kk, s[i] * evecs(i,k).real() / sqrt(eigs[k]));
+	}
+	return T;
+}
+
 //--- Implementation of EdiffCheck ---
 inline EdiffCheck::EdiffCheck(unsigned nDiff, double threshold) : nDiff(nDiff), threshold(fabs(threshold)) {}
 inline bool EdiffCheck::checkConvergence(double E)
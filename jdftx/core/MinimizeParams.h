@@ -48,6 +48,7 @@ struct MinimizeParams
 	int nIterations; //!< Maximum number of iterations (default 100)
 	int nDim; //!< Dimension of optimization space; used only for knormThreshold (default 1)
 	int history; //!< Number of past variables and residuals to store (BFGS only)
+	int nRecycle; //!< Dimension of subspace recycled from each linear solve to deflate the next one (LinearSolvable only; default 0)
 	FILE* fpLog; //!< Stream to log iterations to
 	const char* linePrefix; //!< prefix for each output line of minimizer, useful for nested minimizations (default "CG\t")
 	const char* energyLabel; //!< Label for the minimized quantity (default "E")
@@ -72,7 +73,7 @@ struct MinimizeParams
 	//! Set the default values
 	MinimizeParams() 
 	: dirUpdateScheme(PolakRibiere), linminMethod(DirUpdateRecommended),
-		nIterations(100), nDim(1), history(15), fpLog(stdout),
+		nIterations(100), nDim(1), history(15), nRecycle(0), fpLog(stdout),
 		linePrefix("CG\t"), energyLabel("E"), energyFormat("%22.15le"),
 		knormThreshold(0), energyDiffThreshold(0), nEnergyDiff(2),
 		alphaTstart(1.0), alphaTmin(1e-10), updateTestStepSize(true),
@@ -29,7 +29,8 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 //! @{
 
 //! @brief Pulay mixing to optimize self-consistent field optimization
-//! @
+//! Residuals are preconditioned once when added to the history, so each cycle's update is a single accumulation over the history.
+//! PulayParams::algorithm selects Pulay or Broyden extrapolation, and PulayParams::pulayPeriod enables periodic Pulay.
 template<typename Variable> class Pulay
 {
 public:
@@ -76,9 +77,13 @@ protected:
 
 private:
 	const PulayParams& pp; //!< Pulay parameters
-	std::vector<Variable> pastVariables; //!< Previous variables
+	Variable lastVariable; //!< Variable at the start of the current cycle
+	std::vector<Variable> pastMixed; //!< Previous variables, each incremented by its preconditioned residual
 	std::vector<Variable> pastResiduals; //!< Previous residuals
 	matrix overlap; //!< Overlap matrix of residuals
+	
+	void pushHistory(const Variable& variable, const Variable& residual); //!< Append to history (preconditions residual once)
+	std::vector<double> getCoefficients() const; //!< Coefficients of pastMixed in the next variable (from overlap)
 };
 
 //! @}
@@ -130,17 +135,17 @@ template<typename Variable> double Pulay<Variable>::minimize(double Eprev, std::
 	for(int iter=0; iter<pp.nIterations; iter++)
 	{
 		//If history is full, remove oldest member
-		assert(pastResiduals.size() == pastVariables.size());
+		assert(pastResiduals.size() == pastMixed.size());
 		if((int)pastResiduals.size() >= pp.history)
 		{	size_t ndim = pastResiduals.size();
 			if(ndim>1) overlap.set(0,ndim-1, 0,ndim-1, overlap(1,ndim, 1,ndim));
-			pastVariables.erase(pastVariables.begin());
+			pastMixed.erase(pastMixed.begin());
 			pastResiduals.erase(pastResiduals.begin());
 		}
 		
 		//Cache the old energy and variables
 		Eprev = E;
-		pastVariables.push_back(getVariable());
+		lastVariable = getVariable();
 
 		//Perform cycle:
 		std::vector<double> extraValues(extraThresh.size());
@@ -151,8 +156,8 @@ template<typename Variable> double Pulay<Variable>::minimize(double Eprev, std::
 		//Calculate and cache residual:
 		double residualNorm = 0.;
 		{	Variable residual = getResidual();
-			pastResiduals.push_back(residual);
 			residualNorm = sync(sqrt(dot(residual,residual)));
+			pushHistory(lastVariable, residual);
 		}
 		
 		//Print energy and convergence parameters:
@@ -203,23 +208,14 @@ template<typename Variable> double Pulay<Variable>::minimize(double Eprev, std::
 			overlap.set(ndim-1, j, thisOverlap);
 		}
 		
-		//Invert the residual overlap matrix to get the minimum of residual
-		matrix cOverlap(ndim+1, ndim+1); //Add row and column to enforce normalization constraint
-		cOverlap.set(0, ndim, 0, ndim, overlap(0, ndim, 0, ndim));
-		for(size_t j=0; j<ndim; j++)
-		{	cOverlap.set(j, ndim, 1);
-			cOverlap.set(ndim, j, 1);
-		}
-		cOverlap.set(ndim, ndim, 0);
-		matrix cOverlap_inv = inv(cOverlap);
-		
-		//Update variable:
+		//Update variable (single accumulation pass over the preconditioned history):
 		Variable v;
-		for(size_t j=0; j<ndim; j++)
-		{	double alpha = cOverlap_inv.data()[cOverlap_inv.index(j, ndim)].real();
-			axpy(alpha, pastVariables[j], v);
-			axpy(alpha, precondition(pastResiduals[j]), v);
+		if((iter+1) % pp.pulayPeriod == 0)
+		{	std::vector<double> alpha = getCoefficients();
+			for(size_t j=0; j<ndim; j++)
+				if(alpha[j]) axpy(alpha[j], pastMixed[j], v);
 		}
+		else axpy(1., pastMixed.back(), v); //linear mixing between periodic extrapolations
 		setVariable(v);
 	}
 	return E;
@@ -227,9 +223,64 @@ template<typename Variable> double Pulay<Variable>::minimize(double Eprev, std::
 
 template<typename Variable> Variable Pulay<Variable>::getResidual() const
 {	Variable residual = getVariable(); 
-	axpy(-1., pastVariables.back(), residual);
+	axpy(-1., lastVariable, residual);
 	return residual;
 }
+
+template<typename Variable> void Pulay<Variable>::pushHistory(const Variable& variable, const Variable& residual)
+{	Variable mixed = precondition(residual);
+	axpy(1., variable, mixed);
+	pastMixed.push_back(mixed);
+	pastResiduals.push_back(residual);
+}
+
+template<typename Variable> std::vector<double> Pulay<Variable>::getCoefficients() const
+{	size_t ndim = pastResiduals.size();
+	std::vector<double> alpha(ndim, 0.);
+	#define O(i,j) overlap(i,j).real()
+	switch(pp.algorithm)
+	{	case PulayParams::PA_Pulay:
+		{	//Invert the residual overlap matrix to get the minimum of residual
+			matrix cOverlap(ndim+1, ndim+1); //Add row and column to enforce normalization constraint
+			cOverlap.set(0, ndim, 0, ndim, overlap(0, ndim, 0, ndim));
+			for(size_t j=0; j<ndim; j++)
+			{	cOverlap.set(j, ndim, 1);
+				cOverlap.set(ndim, j, 1);
+			}
+			cOverlap.set(ndim, ndim, 0);
+			matrix cOverlap_inv = inv(cOverlap);
+			for(size_t j=0; j<ndim; j++)
+				alpha[j] = cOverlap_inv.data()[cOverlap_inv.index(j, ndim)].real();
+			break;
+		}
+		case PulayParams::PA_Broyden:
+		{	//Johnson's modified Broyden (PRB 38, 12807) in terms of normalized residual differences dF_i = F_{i+1}-F_i:
+			const double w0 = 0.01; //regularization weight recommended by Johnson
+			size_t m = ndim-1; //index of latest entry
+			alpha[m] = 1.;
+			if(!m) break;
+			diagMatrix dFnorm(m);
+			for(size_t i=0; i<m; i++)
+				dFnorm[i] = sqrt(std::max(O(i+1,i+1) - 2*O(i+1,i) + O(i,i), DBL_MIN));
+			matrix A(m, m), c(m, 1);
+			for(size_t i=0; i<m; i++)
+			{	for(size_t j=0; j<m; j++)
+					A.set(i,j, (O(i+1,j+1) - O(i+1,j) - O(i,j+1) + O(i,j)) / (dFnorm[i]*dFnorm[j]) + (i==j ? w0*w0 : 0.));
+				c.set(i,0, (O(i+1,m) - O(i,m)) / dFnorm[i]);
+			}
+			matrix gamma = inv(A) * c;
+			//x_{m+1} = (x+PF)_m - sum_i gamma_i [(x+PF)_{i+1} - (x+PF)_i]:
+			for(size_t i=0; i<m; i++)
+			{	double gamma_i = gamma.data()[gamma.index(i,0)].real() / dFnorm[i];
+				alpha[i+1] -= gamma_i;
+				alpha[i] += gamma_i;
+			}
+			break;
+		}
+	}
+	#undef O
+	return alpha;
+}
  
 template<typename Variable> void Pulay<Variable>::loadState(const char* filename)
 {
@@ -244,13 +295,14 @@ template<typename Variable> void Pulay<Variable>::loadState(const char* filename
 	if(nBytesFile % nBytesCycle != 0)
 		die("Pulay history file '%s' does not contain an integral multiple of the mixed variables and residuals.\n", filename);
 	fprintf(pp.fpLog, "%sReading %lu past variables and residuals from '%s' ... ", pp.linePrefix, ndim, filename); logFlush();
-	pastVariables.resize(ndim);
-	pastResiduals.resize(ndim);
+	clearState();
 	FILE* fp = fopen(filename, "r");
 	if(dimOffset) fseek(fp, dimOffset*nBytesCycle, SEEK_SET);
 	for(size_t idim=0; idim<ndim; idim++)
-	{	readVariable(pastVariables[idim], fp);
-		readVariable(pastResiduals[idim], fp);
+	{	Variable variable, residual;
+		readVariable(variable, fp);
+		readVariable(residual, fp);
+		pushHistory(variable, residual);
 	}
 	fclose(fp);
 	fprintf(pp.fpLog, "done.\n"); fflush(pp.fpLog);
@@ -269,8 +321,11 @@ template<typename Variable> void Pulay<Variable>::saveState(const char* filename
 {
 	if(mpiWorld->isHead())
 	{	FILE* fp = fopen(filename, "w");
-		for(size_t idim=0; idim<pastVariables.size(); idim++)
-		{	writeVariable(pastVariables[idim], fp);
+		for(size_t idim=0; idim<pastMixed.size(); idim++)
+		{	Variable variable; //recover variable from stored mix (keeps file format unchanged)
+			axpy(1., pastMixed[idim], variable);
+			axpy(-1., precondition(pastResiduals[idim]), variable);
+			writeVariable(variable, fp);
 			writeVariable(pastResiduals[idim], fp);
 		}
 		fclose(fp);
@@ -278,7 +333,7 @@ template<typename Variable> void Pulay<Variable>::saveState(const char* filename
 }
 
 template<typename Variable> void Pulay<Variable>::clearState()
-{	pastVariables.clear();
+{	pastMixed.clear();
 	pastResiduals.clear();
 }
 
@@ -41,10 +41,19 @@ struct PulayParams
 	double mixFraction;  //!< Mixing fraction for total density / potential
 	double qMetric; //!< Wavevector controlling the metric for overlaps
 	
+	//! Scheme used to extrapolate from the history
+	enum Algorithm
+	{	PA_Pulay, //!< Pulay / DIIS extrapolation (minimize residual in span of history)
+		PA_Broyden //!< Johnson's modified Broyden update (regularized Pulay on successive differences)
+	}
+	algorithm; //!< Extrapolation scheme
+	int pulayPeriod; //!< Extrapolate only every pulayPeriod cycles, and use linear mixing in between (periodic Pulay if > 1)
+	
 	PulayParams()
 	: fpLog(stdout), linePrefix("Pulay: "), energyLabel("E"), energyFormat("%22.15le"),
 		nIterations(50), energyDiffThreshold(1e-8), residualThreshold(1e-7),
-		history(10), mixFraction(0.5), qMetric(0.8)
+		history(10), mixFraction(0.5), qMetric(0.8),
+		algorithm(PA_Pulay), pulayPeriod(1)
 	{
 	}
 };
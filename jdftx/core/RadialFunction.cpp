@@ -21,6 +21,8 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/SphericalHarmonics.h>
 #include <core/GpuUtil.h>
 #include <core/Thread.h>
+#include <mutex>
+#include <map>
 
 RadialFunctionG::RadialFunctionG() : dGinv(0), nCoeff(0),
 #ifdef GPU_ENABLED
@@ -163,15 +165,89 @@ static void RadialFunction_transform_sub(int iMineStart, int iMineStop, int iGst
 		fTilde[iG] = rFunc->transform(l, iG*dG);
 }
 
+bool RadialFunctionR::cacheTransforms = false;
+size_t RadialFunctionR::nTransformsReused = 0;
+double RadialFunctionR::transformSecSaved = 0.;
+
+//Cache of transformed samples (used when RadialFunctionR::cacheTransforms is set)
+namespace RadialTransformCache
+{	struct Entry
+	{	int l; double dG;
+		std::vector<double> r, dr, f; //function data (compared exactly to avoid hash collisions)
+		std::vector<double> fTilde; //transformed samples computed so far
+		double secPerSample; //time taken per sample (for estimating savings)
+	};
+	std::multimap<uint64_t,Entry> entries; //indexed by hash
+	std::mutex lock;
+	
+	uint64_t hash(int l, double dG, const RadialFunctionR& rFunc)
+	{	uint64_t h = 14695981039346656037ULL; //FNV-1a
+		auto accum = [&h](const void* data, size_t nBytes)
+		{	const unsigned char* bytes = (const unsigned char*)data;
+			for(size_t i=0; i<nBytes; i++) { h ^= bytes[i]; h *= 1099511628211ULL; }
+		};
+		accum(&l, sizeof(l));
+		accum(&dG, sizeof(dG));
+		accum(rFunc.r.data(), rFunc.r.size()*sizeof(double));
+		accum(rFunc.f.data(), rFunc.f.size()*sizeof(double));
+		return h;
+	}
+	
+	//Find (and optionally create) entry for specified transform:
+	Entry* find(int l, double dG, const RadialFunctionR& rFunc, uint64_t h)
+	{	auto range = entries.equal_range(h);
+		for(auto iter=range.first; iter!=range.second; iter++)
+		{	Entry& entry = iter->second;
+			if(entry.l==l && entry.dG==dG && entry.r==rFunc.r && entry.dr==rFunc.dr && entry.f==rFunc.f)
+				return &entry;
+		}
+		return 0;
+	}
+}
+
 // Initialize a uniform G radial function from the log-grid function
 void RadialFunctionR::transform(int l, double dG, int nGrid, RadialFunctionG& func) const
 {	static StopWatch watch("RadialFunctionR::transform"); watch.start();
 	std::vector<double> fTilde(nGrid, 0.);
-	int iGstart, iGstop; TaskDivision(nGrid, mpiWorld).myRange(iGstart, iGstop);
-	int nGridMine = iGstop-iGstart;
-	if(nGridMine)
-		threadLaunch(RadialFunction_transform_sub, nGridMine, iGstart, l, dG, this, fTilde.data());
-	mpiWorld->allReduceData(fTilde, MPIUtil::ReduceSum);
+	//Retrieve previously computed samples, if caching is enabled:
+	int nCached = 0; uint64_t h = 0;
+	if(cacheTransforms)
+	{	h = RadialTransformCache::hash(l, dG, *this);
+		RadialTransformCache::lock.lock();
+		const RadialTransformCache::Entry* entry = RadialTransformCache::find(l, dG, *this, h);
+		if(entry)
+		{	nCached = std::min(nGrid, int(entry->fTilde.size()));
+			std::copy(entry->fTilde.begin(), entry->fTilde.begin()+nCached, fTilde.begin());
+			nTransformsReused++;
+			transformSecSaved += nCached * entry->secPerSample;
+		}
+		RadialTransformCache::lock.unlock();
+	}
+	//Compute remaining samples:
+	if(nCached < nGrid)
+	{	double tStart = clock_sec();
+		std::vector<double> fTildeNew(nGrid, 0.);
+		int iGstart, iGstop; TaskDivision(nGrid-nCached, mpiWorld).myRange(iGstart, iGstop);
+		int nGridMine = iGstop-iGstart;
+		if(nGridMine)
+			threadLaunch(RadialFunction_transform_sub, nGridMine, nCached+iGstart, l, dG, this, fTildeNew.data());
+		mpiWorld->allReduceData(fTildeNew, MPIUtil::ReduceSum);
+		std::copy(fTildeNew.begin()+nCached, fTildeNew.end(), fTilde.begin()+nCached);
+		if(cacheTransforms)
+		{	double secPerSample = (clock_sec()-tStart) / (nGrid-nCached);
+			RadialTransformCache::lock.lock();
+			RadialTransformCache::Entry* entry = RadialTransformCache::find(l, dG, *this, h);
+			if(!entry)
+			{	RadialTransformCache::Entry newEntry;
+				newEntry.l = l; newEntry.dG = dG;
+				newEntry.r = r; newEntry.dr = dr; newEntry.f = f;
+				entry = &(RadialTransformCache::entries.insert(std::make_pair(h, newEntry))->second);
+			}
+			if(int(entry->fTilde.size()) < nGrid) entry->fTilde = fTilde;
+			entry->secPerSample = secPerSample;
+			RadialTransformCache::lock.unlock();
+		}
+	}
 	func.free(this!=func.rFunc);
 	func.init(l, fTilde, dG);
 	if(this!=func.rFunc) func.rFunc = new RadialFunctionR(*this);
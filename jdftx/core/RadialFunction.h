@@ -128,6 +128,12 @@ struct RadialFunctionR
 	//! Initialize a uniform G radial function from the logPrintf grid function according to
 	//! @$ func(G) = \int dr 4\pi r^2 j_l(G r) f(r) @$
 	void transform(int l, double dG, int nGrid, RadialFunctionG& func) const;
+	
+	//! If true, cache results of the above transform (keyed by l, dG and the function data), so that
+	//! identical functions (eg. pseudopotentials reused by several calculations in one process) are transformed only once
+	static bool cacheTransforms;
+	static size_t nTransformsReused; //!< number of transforms (fully or partially) retrieved from the cache
+	static double transformSecSaved; //!< estimated time saved (in seconds) due to cached transforms
 };
 
 //! @}
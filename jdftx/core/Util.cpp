@@ -145,6 +145,12 @@ void logResume()
 {	globalLog = globalLogOrig;
 }
 
+FILE* logRedirect(FILE* fp)
+{	FILE* fpPrev = globalLogOrig;
+	globalLog = globalLogOrig = fp;
+	return fpPrev;
+}
+
 int nProcessGroups = 0;
 MPIUtil* mpiWorld = 0;
 MPIUtil* mpiGroup = 0;
@@ -385,12 +391,14 @@ void initSystemCmdline(int argc, char** argv, InitParams& ip)
 }
 
 #ifdef ENABLE_PROFILING
-void stopWatchManager(const StopWatch* addWatch=0, const string* watchName=0)
+void stopWatchManager(const StopWatch* addWatch=0, const string* watchName=0, bool reset=false)
 {	static std::multimap<string, const StopWatch*> watches; //static array of all watches
 	if(addWatch) watches.insert(std::make_pair(*watchName,addWatch));
 	else //print timings:
 	{	logPrintf("\n");
 		for(const auto& wPair: watches) wPair.second->print();
+		if(reset)
+			for(const auto& wPair: watches) ((StopWatch*)wPair.second)->reset();
 	}
 }
 #endif // ENABLE_PROFILING
@@ -475,8 +483,18 @@ void StopWatch::print() const
 			name.c_str(), meanT*1e-6, sigmaT*1e-6, nT, Ttot*1e-6);
 	}
 }
+void StopWatch::reset()
+{	Ttot = 0.; TsqTot = 0.; nT = 0;
+}
 #endif //ENABLE_PROFILING
 
+void printAndResetStopWatches()
+{
+	#ifdef ENABLE_PROFILING
+	stopWatchManager(0, 0, true);
+	#endif
+}
+
 
 // Print a minimal stack trace (convenient for debugging)
 void printStack(bool detailedStackScript)
@@ -605,7 +623,8 @@ namespace Citations
 	//(Done this way, so that add may be called during static initialization safely)
 	//If addCitation is non-null, enter the pair into the list
 	//If getCitationList is non-null, retrieve the list
-	void manage(std::pair<string,string>* addCitation=0, std::list<std::pair<string,string>>* getCitationList=0)
+	//If setCitationList is non-null, replace the list with it
+	void manage(std::pair<string,string>* addCitation=0, std::list<std::pair<string,string>>* getCitationList=0, const std::list<std::pair<string,string>>* setCitationList=0)
 	{	static std::list<std::pair<string,string>> citationList; //pair.first = paper, pair.second = reason
 		if(addCitation)
 		{	auto iter=citationList.begin();
@@ -624,6 +643,7 @@ namespace Citations
 			if(!duplicate) citationList.insert(iter, *addCitation);
 		}
 		if(getCitationList) *getCitationList = citationList;
+		if(setCitationList) citationList = *setCitationList;
 	}
 	
 	void add(string reason, string paper)
@@ -631,6 +651,16 @@ namespace Citations
 		manage(&citation, 0);
 	}
 
+	std::list<std::pair<string,string>> savedCitationList; //state saved by save() for restore()
+	
+	void save()
+	{	manage(0, &savedCitationList);
+	}
+	
+	void restore()
+	{	manage(0, 0, &savedCitationList);
+	}
+
 	void print(FILE* fp)
 	{	fprintf(fp, "\n---- Citations for features of the code used in this run ----\n\n");
 		//Get the citation map:
@@ -96,6 +96,7 @@ public:
 	void start();
 	void stop();
 	void print() const;
+	void reset(); //!< clear timing statistics
 private:
 	double tPrev, Ttot, TsqTot; int nT;
 	string name;
@@ -111,6 +112,10 @@ public:
 };
 #endif //ENABLE_PROFILING
 
+//! Print and then clear timings of all StopWatch objects (no-op without ENABLE_PROFILING);
+//! used to report timings separately for each calculation in a batch
+void printAndResetStopWatches();
+
 
 
 // -----------  Debugging ---------------
@@ -127,6 +132,7 @@ extern FILE* globalLog;
 extern FILE* nullLog; //!< pointer to /dev/null
 void logSuspend(); //!< temporarily disable all log output (until logResume())
 void logResume(); //!< re-enable logging after a logSuspend() call
+FILE* logRedirect(FILE* fp); //!< send all subsequent log output to fp (including after logSuspend/logResume), and return previous log file pointer
 
 #define logPrintf(...) fprintf(globalLog, __VA_ARGS__) //!< printf() for log files
 #define logFlush() fflush(globalLog) //!< fflush() for log files
@@ -157,6 +163,11 @@ namespace Citations
 	
 	//!Print the list of citations (with reasons) to the specified stream
 	void print(FILE* fp=globalLog);
+	
+	//!Save the current list of citations, and restore the list to that saved state
+	//!(so that each calculation in a batch lists only citations for the features it used)
+	void save();
+	void restore();
 }
 
 
@@ -0,0 +1,34 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#ifndef JDFTX_ELECTRONIC_CALCULATION_H
+#define JDFTX_ELECTRONIC_CALCULATION_H
+
+class Everything;
+
+//! @addtogroup ElecSystem
+//! @{
+//! @file Calculation.h Top-level driver for a JDFTx calculation
+
+//! Run the calculation specified in e (which must already be setup and have its initial dumps done):
+//! fixed-state / band-structure / vibrations / lattice / dynamics / ionic minimization, followed by the final dump
+void runCalculation(Everything& e);
+
+//! @}
+#endif // JDFTX_ELECTRONIC_CALCULATION_H
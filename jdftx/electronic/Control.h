@@ -40,6 +40,9 @@ class Control
 public:
 	bool fixed_H; //!< fixed Hamiltonian (band structure) mode for electronic sector
 	bool cacheProjectors; //!< whether to cache nonlocal projectors
+	double projectorCacheMemory; //!< memory budget (in MB) for cached projectors (0 => unlimited)
+	bool realSpaceProjectors; //!< whether to apply nonlocal projectors in real space (instead of reciprocal space)
+	double realSpaceProjectorTol; //!< relative tolerance for truncating the filtered real-space projectors
 	double davidsonBandRatio; //!< ratio of number of Davidson working bands to actual bands in system (>= 1)
 	
 	ElecEigenAlgo elecEigenAlgo; //!< Eigenvalue algorithm
@@ -63,14 +66,16 @@ public:
 	bool scf; //!< whether SCF iteration or total energy minimizer will be called
 	bool convergeEmptyStates; //!< whether to converge empty states after every electronic minimization
 	bool dumpOnly; //!< run a single-electronic-point energy evaluation and process the end dump
+	int exchangePrefetchDepth; //!< number of exact-exchange partner states broadcast ahead of the one being processed
 	
 	Control()
 	:	fixed_H(false),
-		cacheProjectors(true), davidsonBandRatio(1.1),
+		cacheProjectors(true), projectorCacheMemory(0.), realSpaceProjectors(false), realSpaceProjectorTol(1e-4), davidsonBandRatio(1.1),
 		elecEigenAlgo(ElecEigenDavidson), basisKdep(BasisKpointDep), Ecut(0), EcutRho(0), dragWavefunctions(true),
 		fluidGummel_nIterations(10), fluidGummel_Atol(1e-5),
 		shouldPrintEigsFillings(false), shouldPrintEcomponents(false), shouldPrintMuSearch(false), shouldPrintKpointsBasis(false),
-		subspaceRotationFactor(1.), subspaceRotationAdjust(true), scf(false), convergeEmptyStates(false), dumpOnly(false)
+		subspaceRotationFactor(1.), subspaceRotationAdjust(true), scf(false), convergeEmptyStates(false), dumpOnly(false),
+		exchangePrefetchDepth(1)
 	{
 	}
 };
@@ -517,15 +517,16 @@ void DOS::dump()
 			mpiWorld->sendData(message, 0, 0, 0);
 		}
 	}
-	if(!mpiWorld->isHead()) return;
+	if(mpiWorld->isHead()) eval.weldEigenvalues(Etol);
+	if(mpiWorld->nProcesses()>1) eval.bcast(mpiWorld); //tetrahedra are divided over all processes below
 	
-	//Compute and print density of states (head only):
+	//Compute density of states (all processes) and print (head only):
 	string header = "\"Energy\"";
 	for(const Weight& weight: weights)
 		header += ("\t\"" + weight.getDescription(*e) + "\"");
-	eval.weldEigenvalues(Etol);
 	for(int iSpin=0; iSpin<nSpins; iSpin++)
-	{	TetrahedralDOS::Lspline dos = eval.getDOS(iSpin, Etol);
+	{	TetrahedralDOS::Lspline dos = eval.getDOS(iSpin, Etol, mpiWorld);
+		if(!mpiWorld->isHead()) continue;
 		if(Esigma>0.) dos = eval.gaussSmooth(dos, Esigma); //apply Gauss smoothing if requested
 		eval.printDOS(dos, e->dump.getFilename(nSpins==1 ? "dos" : (iSpin==0 ? "dosUp" : "dosDn")), header);
 	}
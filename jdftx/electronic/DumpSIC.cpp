@@ -22,6 +22,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <electronic/ColumnBundle.h>
 #include <core/Operators.h>
 #include <core/Util.h>
+#include <list>
 
 DumpSelfInteractionCorrection::DumpSelfInteractionCorrection(const Everything& everything)
 {
@@ -29,38 +30,83 @@ DumpSelfInteractionCorrection::DumpSelfInteractionCorrection(const Everything& e
 }
 
 double DumpSelfInteractionCorrection::operator()(std::vector<diagMatrix>* correctedEigenvalues)
-{
-	// Loop over all quantum numbers (spin+kpoint) and bands; and corrects their eigenvalues
-	double selfInteractionEnergy = 0;
-	DC.resize(3);
-	for(int q=0; q<e->eInfo.nStates; q++) //need to loop over all states since XC is MPI parallelized
-	{	if(e->exCorr.needsKEdensity() && e->eInfo.isMine(q))
-			for(int iDir=0; iDir<3; iDir++)
-				DC[iDir] = D(e->eVars.C[q], iDir);
-		if(e->eInfo.isMine(q) && correctedEigenvalues)
-			(*correctedEigenvalues)[q].resize(e->eInfo.nBands);
-		for(int n=0; n<e->eInfo.nBands; n++)
-		{	double selfInteractionError = calcSelfInteractionError(q,n);
-			if(e->eInfo.isMine(q))
-			{	if(correctedEigenvalues)
-					(*correctedEigenvalues)[q][n] = e->eVars.Hsub_eigs[q][n] - selfInteractionError;
-				selfInteractionEnergy += e->eVars.F[q][n]*e->eInfo.qnums[q].weight*selfInteractionError;
+{	static StopWatch watch("DumpSelfInteractionCorrection"); watch.start();
+	const ElecInfo& eInfo = e->eInfo;
+	const int nBands = eInfo.nBands;
+	const int iProc = mpiWorld->iProcess();
+	
+	// Divide orbitals (over all quantum numbers and bands) evenly between processes
+	TaskDivision orbitalDiv(eInfo.nStates*nBands, mpiWorld);
+	auto getBandRange = [&](int q, int jProc, int& bStart, int& bStop)
+	{	bStart = std::max(0, int(orbitalDiv.start(jProc)) - q*nBands);
+		bStop = std::min(nBands, int(orbitalDiv.stop(jProc)) - q*nBands);
+	};
+	
+	// Move each block of orbitals from the process that owns the state to the one that handles it
+	std::vector<ColumnBundle> Cmine(eInfo.nStates); //columns [bStart,bStop) of each state handled by this process
+	std::list<ColumnBundle> sendBuffers; //kept till sends complete
+	std::vector<MPIUtil::Request> requests;
+	for(int q=0; q<eInfo.nStates; q++)
+	{	int bStart, bStop; getBandRange(q, iProc, bStart, bStop);
+		if(bStart < bStop)
+		{	if(eInfo.isMine(q))
+				Cmine[q] = e->eVars.C[q].getSub(bStart, bStop);
+			else
+			{	Cmine[q].init(bStop-bStart, e->basis[q].nbasis*eInfo.spinorLength(), &e->basis[q], &eInfo.qnums[q], isGpuEnabled());
+				requests.push_back(MPIUtil::Request());
+				mpiWorld->recvData(Cmine[q], eInfo.whose(q), q, &requests.back());
+			}
+		}
+		if(eInfo.isMine(q))
+			for(int jProc=0; jProc<mpiWorld->nProcesses(); jProc++)
+			{	int jStart, jStop; getBandRange(q, jProc, jStart, jStop);
+				if(jProc==iProc || jStart>=jStop) continue;
+				sendBuffers.push_back(e->eVars.C[q].getSub(jStart, jStop));
+				requests.push_back(MPIUtil::Request());
+				mpiWorld->sendData(sendBuffers.back(), jProc, q, &requests.back());
 			}
+	}
+	MPIUtil::waitAll(requests);
+	sendBuffers.clear();
+	
+	// Calculate self-interaction errors of orbitals handled by this process (no communication)
+	std::vector<double> selfInteractionErrors(eInfo.nStates*nBands, 0.);
+	for(int q=0; q<eInfo.nStates; q++)
+	{	if(!Cmine[q]) continue;
+		int bStart, bStop; getBandRange(q, iProc, bStart, bStop);
+		if(e->exCorr.needsKEdensity())
+		{	DC.resize(3);
+			for(int iDir=0; iDir<3; iDir++)
+				DC[iDir] = D(Cmine[q], iDir);
 		}
+		for(int n=bStart; n<bStop; n++)
+			selfInteractionErrors[q*nBands+n] = calcSelfInteractionError(Cmine[q], n-bStart);
+		Cmine[q].free();
 	}
 	DC.clear();
+	mpiWorld->allReduceData(selfInteractionErrors, MPIUtil::ReduceSum); //each entry is non-zero only on one process
+	
+	// Correct eigenvalues and collect self-interaction energy for states owned by this process
+	double selfInteractionEnergy = 0;
+	for(int q=eInfo.qStart; q<eInfo.qStop; q++)
+	{	if(correctedEigenvalues)
+			(*correctedEigenvalues)[q].resize(nBands);
+		for(int n=0; n<nBands; n++)
+		{	double selfInteractionError = selfInteractionErrors[q*nBands+n];
+			if(correctedEigenvalues)
+				(*correctedEigenvalues)[q][n] = e->eVars.Hsub_eigs[q][n] - selfInteractionError;
+			selfInteractionEnergy += e->eVars.F[q][n]*eInfo.qnums[q].weight*selfInteractionError;
+		}
+	}
 	mpiWorld->allReduce(selfInteractionEnergy, MPIUtil::ReduceSum);
+	watch.stop();
 	return selfInteractionEnergy;
-	
 }
 
-double DumpSelfInteractionCorrection::calcSelfInteractionError(int q, int n)
+double DumpSelfInteractionCorrection::calcSelfInteractionError(const ColumnBundle& Cq, int n)
 {
 	// Get the real-space orbital density
-	ScalarField orbitalDensity; nullToZero(orbitalDensity, e->gInfo);
-	if(e->eInfo.isMine(q))
-		orbitalDensity = diagouterI(eye(1), e->eVars.C[q].getSub(n,n+1), 1, &e->gInfo)[0];
-	orbitalDensity->bcastData(mpiWorld, e->eInfo.whose(q));
+	ScalarField orbitalDensity = diagouterI(eye(1), Cq.getSub(n,n+1), 1, &e->gInfo)[0];
 	ScalarFieldTilde orbitalDensityTilde = J(orbitalDensity);
 	
 	// Calculate the Coulomb energy
@@ -76,13 +122,11 @@ double DumpSelfInteractionCorrection::calcSelfInteractionError(int q, int n)
 	ScalarFieldArray KEdensity(2);
 	if(e->exCorr.needsKEdensity())
 	{	nullToZero(KEdensity, e->gInfo);
-		if(e->eInfo.isMine(q))
-			for(int iDir=0; iDir<3; iDir++)
-				KEdensity[0] += 0.5 * diagouterI(eye(1), DC[iDir].getSub(n,n+1), 1, &e->gInfo)[0];
-		KEdensity[0]->bcastData(mpiWorld, e->eInfo.whose(q));
+		for(int iDir=0; iDir<3; iDir++)
+			KEdensity[0] += 0.5 * diagouterI(eye(1), DC[iDir].getSub(n,n+1), 1, &e->gInfo)[0];
 	}
 
-	double xcEnergy = e->exCorr(orbitalSpinDensity, 0, IncludeTXC(), &KEdensity, 0);
+	double xcEnergy = e->exCorr(orbitalSpinDensity, 0, IncludeTXC(), &KEdensity, 0, true); //evaluated locally (orbitals are distributed)
 	
 	return coulombEnergy + xcEnergy;
 }
@@ -44,8 +44,8 @@ public:
 	bool needsTau;  //!< The kinetic energy density is needed for meta-gga functionals.
 private:
 	const Everything* e;
-	double calcSelfInteractionError(int q, int n); //!< Calculates the self-interaction error of the KS orbital atthe n'th band at q'th quantum number
-	std::vector<ColumnBundle> DC; //!< ColumnBundle for the derivative of the wavefunctions in each cartesian direction
+	double calcSelfInteractionError(const ColumnBundle& Cq, int n); //!< Calculates the self-interaction error of the KS orbital in the n'th column of Cq (evaluated on the current process alone)
+	std::vector<ColumnBundle> DC; //!< ColumnBundle for the derivative of the wavefunctions (Cq above) in each cartesian direction
 };
 
 //---------------- Implemented in DumpExcitationsMoments.cpp -----------------
@@ -384,9 +384,12 @@ double ElecVars::elecEnergyAndGrad(Energies& ener, ElecGradient* grad, ElecGradi
 	}
 	
 	//Update the density and density-dependent pieces if required:
-	n = calcDensity();
-	if(e->exCorr.needsKEdensity()) tau = KEdensity();
+	//--- reductions over processes of each density component overlap the remaining local work
+	ReductionQueue densityReductions(mpiWorld);
+	n = calcDensity(&densityReductions);
+	if(e->exCorr.needsKEdensity()) tau = KEdensity(&densityReductions);
 	if(eInfo.hasU) e->iInfo.rhoAtom_calc(F, C, rhoAtom); //Atomic density matrix contributions for DFT+U
+	densityReductions.wait(); //complete reductions of n and tau before first use
 	EdensityAndVscloc(ener); //Calculate density functional and its gradient
 	if(need_Hsub) e->iInfo.augmentDensityGridGrad(Vscloc); //Update Vscloc projected onto spherical functions for ultrasoft psps
 	
@@ -542,7 +545,7 @@ void ElecVars::setEigenvectors()
 	}
 }
 
-ScalarFieldArray ElecVars::KEdensity() const
+ScalarFieldArray ElecVars::KEdensity(ReductionQueue* reductions) const
 {	ScalarFieldArray tau(n.size());
 	//Compute KE density from valence electrons:
 	for(int q=e->eInfo.qStart; q<e->eInfo.qStop; q++)
@@ -551,17 +554,19 @@ ScalarFieldArray ElecVars::KEdensity() const
 	for(ScalarField& tau_s: tau)
 	{	nullToZero(tau_s, e->gInfo);
 		e->symm.symmetrize(tau_s); //Symmetrize
-		tau_s->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		if(reductions) reductions->allReduceData(*tau_s, MPIUtil::ReduceSum); //overlap with symmetrization of next component
+		else tau_s->allReduceData(mpiWorld, MPIUtil::ReduceSum);
 	}
 	//Add core KE density model:
 	if(e->iInfo.tauCore)
-	{	for(unsigned s=0; s<tau.size(); s++)
+	{	if(reductions) reductions->wait(); //core contribution must be added after the reduction
+		for(unsigned s=0; s<tau.size(); s++)
 			tau[s] += (1.0/tau.size()) * e->iInfo.tauCore; //add core KE density
 	}
 	return tau;
 }
 
-ScalarFieldArray ElecVars::calcDensity() const
+ScalarFieldArray ElecVars::calcDensity(ReductionQueue* reductions) const
 {	ScalarFieldArray density(n.size());
 	//Runs over all states and accumulates density to the corresponding spin channel of the total density
 	e->iInfo.augmentDensityInit();
@@ -574,7 +579,8 @@ ScalarFieldArray ElecVars::calcDensity() const
 	for(ScalarField& ns: density)
 	{	nullToZero(ns, e->gInfo);
 		e->symm.symmetrize(ns); //Symmetrize
-		ns->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		if(reductions) reductions->allReduceData(*ns, MPIUtil::ReduceSum); //overlap with symmetrization of next component
+		else ns->allReduceData(mpiWorld, MPIUtil::ReduceSum);
 	}
 	return density;
 }
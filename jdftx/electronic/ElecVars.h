@@ -109,11 +109,15 @@ public:
 	//! Set C to eigenvectors of the subspace hamiltonian
 	void setEigenvectors(); 
 	
-	//! Compute the kinetic energy density
-	ScalarFieldArray KEdensity() const;
-	
-	//! Calculate density using current orthonormal wavefunctions (C)
-	ScalarFieldArray calcDensity() const;
+	//! Compute the kinetic energy density.
+	//! If reductions is non-null, the MPI reductions of each spin component are started on it, and
+	//! must be completed (ReductionQueue::wait) before the result is used (unless there is a core KE density).
+	ScalarFieldArray KEdensity(ReductionQueue* reductions=0) const;
+	
+	//! Calculate density using current orthonormal wavefunctions (C).
+	//! If reductions is non-null, the MPI reductions of each spin component are started on it,
+	//! and must be completed (ReductionQueue::wait) before the result is used.
+	ScalarFieldArray calcDensity(ReductionQueue* reductions=0) const;
 	
 	//! Orthonormalise wavefunctions, with an optional extra rotation
 	//! If extraRotation is present, it is applied after symmetric orthononormalization,
@@ -38,24 +38,73 @@ struct LCAOminimizer : Minimizable<ElecGradient> //Uses only the Haux entries of
 	const ExCorr* exCorr;
 	std::vector<matrix> HniSub;
 	std::vector<matrix> rotPrev; //Accumulated rotations of the wavefunctions
+	bool threadStates; //whether loops over states may be threaded (operators within each state are then serial)
 	
 	LCAOminimizer(ElecVars& eVars, const Everything& e)
-	: eVars(eVars), e(e), eInfo(e.eInfo), HniSub(eInfo.nStates), rotPrev(eInfo.nStates)
+	: eVars(eVars), e(e), eInfo(e.eInfo), HniSub(eInfo.nStates), rotPrev(eInfo.nStates),
+		threadStates(!(isGpuEnabled() || e.cntrl.realSpaceProjectors)) //real-space projector initialization is not thread safe
 	{
 	}
 	
+	//Run func(q, args...) for all local states, concurrently over states if there are enough of them:
+	template<typename Func, typename... Args> static void forStates_thread(int iStart, int iStop, const LCAOminimizer* lcao, Func* func, Args... args)
+	{	for(int q=lcao->eInfo.qStart+iStart; q<lcao->eInfo.qStart+iStop; q++)
+			(*func)(q, args...);
+	}
+	template<typename Func, typename... Args> void forStates(Func* func, Args... args) const
+	{	int nQmine = eInfo.qStop-eInfo.qStart;
+		//Thread over states only if they can occupy at least half the cores; otherwise loop serially with threaded operators:
+		int nThreads = std::min(nProcsAvailable, nQmine);
+		if(!threadStates || !shouldThreadOperators() || 2*nThreads < nProcsAvailable) nThreads = 1;
+		if(nThreads > 1)
+			threadLaunch(nThreads, forStates_thread<Func,Args...>, nQmine, this, func, args...);
+		else
+			forStates_thread<Func,Args...>(0, nQmine, this, func, args...);
+	}
+	
+	static void step_q(int q, LCAOminimizer* lcao, const ElecGradient* dir, double alpha)
+	{	ElecVars& eVars = lcao->eVars;
+		assert(dir->Haux[q]);
+		//Move aux along dir after transforming dir to match rotations:
+		matrix Haux = eVars.Haux_eigs[q], Haux_evecs;
+		axpy(alpha, dagger(lcao->rotPrev[q])*dir->Haux[q]*lcao->rotPrev[q], Haux);
+		//Adjust rotations to make Haux diagonal again:
+		Haux.diagonalize(Haux_evecs, eVars.Haux_eigs[q]);
+		lcao->rotPrev[q] = lcao->rotPrev[q] * Haux_evecs;
+		eVars.C[q] = eVars.C[q] * Haux_evecs;
+		for(unsigned sp=0; sp<lcao->e.iInfo.species.size(); sp++)
+			if(eVars.VdagC[q][sp]) eVars.VdagC[q][sp] = eVars.VdagC[q][sp] * Haux_evecs;
+	}
+	
 	void step(const ElecGradient& dir, double alpha)
-	{	for(int q=eInfo.qStart; q<eInfo.qStop; q++)
-		{	assert(dir.Haux[q]);
-			//Move aux along dir after transforming dir to match rotations:
-			matrix Haux = eVars.Haux_eigs[q], Haux_evecs;
-			axpy(alpha, dagger(rotPrev[q])*dir.Haux[q]*rotPrev[q], Haux);
-			//Adjust rotations to make Haux diagonal again:
-			Haux.diagonalize(Haux_evecs, eVars.Haux_eigs[q]);
-			rotPrev[q] = rotPrev[q] * Haux_evecs;
-			eVars.C[q] = eVars.C[q] * Haux_evecs;
-			for(unsigned sp=0; sp<e.iInfo.species.size(); sp++)
-				if(eVars.VdagC[q][sp]) eVars.VdagC[q][sp] = eVars.VdagC[q][sp] * Haux_evecs;
+	{	forStates(step_q, this, &dir, alpha);
+	}
+	
+	//Non-interacting energy, and optionally subspace Hamiltonian and constraint contributions of state q:
+	static void compute_q(int q, LCAOminimizer* lcao, bool needGrad, double mu, double Bz, double* ENI, double* dmuNum, double* dmuDen)
+	{	const Everything& e = lcao->e;
+		const ElecInfo& eInfo = lcao->eInfo;
+		ElecVars& eVars = lcao->eVars;
+		const QuantumNumber& qnum = eInfo.qnums[q];
+		int iq = q - eInfo.qStart;
+		
+		//KE and Nonlocal pseudopotential from precomputed subspace matrix:
+		matrix HniRot = dagger(lcao->rotPrev[q]) * lcao->HniSub[q] * lcao->rotPrev[q];
+		ENI[iq] = qnum.weight * trace(eVars.F[q] * HniRot).real();
+	
+		//Gradient and subspace Hamiltonian:
+		if(needGrad)
+		{	ColumnBundle HCq = Idag_DiagV_I(eVars.C[q], eVars.Vscloc); //Accumulate Idag Diag(Vscloc) I C
+			if(eInfo.hasU) e.iInfo.rhoAtom_grad(eVars.C[q], eVars.U_rhoAtom, HCq); //Contribution via atomic density matrices (DFT+U)
+			std::vector<matrix> HVdagCq(e.iInfo.species.size());
+			e.iInfo.augmentDensitySphericalGrad(qnum, eVars.VdagC[q], HVdagCq); //Contribution via pseudopotential density augmentation
+			e.iInfo.projectGrad(HVdagCq, eVars.C[q], HCq);
+			eVars.Hsub[q] = HniRot + (eVars.C[q]^HCq);
+			eVars.Hsub[q].diagonalize(eVars.Hsub_evecs[q], eVars.Hsub_eigs[q]);
+			//N/M constraint contributions to gradient:
+			diagMatrix fprime = eInfo.smearPrime(eInfo.muEff(mu,Bz,q), eVars.Haux_eigs[q]);
+			dmuNum[iq] = qnum.weight * trace(fprime * (diag(eVars.Hsub[q])-eVars.Haux_eigs[q]));
+			dmuDen[iq] = qnum.weight * trace(fprime);
 		}
 	}
 	
@@ -79,31 +128,17 @@ struct LCAOminimizer : Minimizable<ElecGradient> //Uses only the Haux entries of
 		eVars.EdensityAndVscloc(ener, exCorr);
 		if(grad) e.iInfo.augmentDensityGridGrad(eVars.Vscloc);
 		
-		//Wavefunction dependent parts:
+		//Wavefunction dependent parts (concurrently over states):
+		int nQmine = eInfo.qStop - eInfo.qStart;
+		std::vector<double> ENI(nQmine, 0.), dmuNumQ(nQmine, 0.), dmuDenQ(nQmine, 0.);
+		forStates(compute_q, this, bool(grad), mu, Bz, ENI.data(), dmuNumQ.data(), dmuDenQ.data());
 		ener.E["NI"] = 0.;
 		for(int q=eInfo.qStart; q<eInfo.qStop; q++)
-		{	const QuantumNumber& qnum = eInfo.qnums[q];
-			
-			//KE and Nonlocal pseudopotential from precomputed subspace matrix:
-			matrix HniRot = dagger(rotPrev[q]) * HniSub[q] * rotPrev[q];
-			ener.E["NI"] += qnum.weight * trace(eVars.F[q] * HniRot).real();
-		
-			//Gradient and subspace Hamiltonian:
-			if(grad)
-			{	ColumnBundle HCq = Idag_DiagV_I(eVars.C[q], eVars.Vscloc); //Accumulate Idag Diag(Vscloc) I C
-				if(eInfo.hasU) e.iInfo.rhoAtom_grad(eVars.C[q], eVars.U_rhoAtom, HCq); //Contribution via atomic density matrices (DFT+U)
-				std::vector<matrix> HVdagCq(e.iInfo.species.size());
-				e.iInfo.augmentDensitySphericalGrad(qnum, eVars.VdagC[q], HVdagCq); //Contribution via pseudopotential density augmentation
-				e.iInfo.projectGrad(HVdagCq, eVars.C[q], HCq);
-				eVars.Hsub[q] = HniRot + (eVars.C[q]^HCq);
-				eVars.Hsub[q].diagonalize(eVars.Hsub_evecs[q], eVars.Hsub_eigs[q]);
-				//N/M constraint contributions to gradient:
-				diagMatrix fprime = eInfo.smearPrime(eInfo.muEff(mu,Bz,q), eVars.Haux_eigs[q]);
-				double w = eInfo.qnums[q].weight;
-				int sIndex = eInfo.qnums[q].index();
-				dmuNum[sIndex] += w * trace(fprime * (diag(eVars.Hsub[q])-eVars.Haux_eigs[q]));
-				dmuDen[sIndex] += w * trace(fprime);
-			}
+		{	int iq = q - eInfo.qStart;
+			int sIndex = eInfo.qnums[q].index();
+			ener.E["NI"] += ENI[iq];
+			dmuNum[sIndex] += dmuNumQ[iq];
+			dmuDen[sIndex] += dmuDenQ[iq];
 		}
 		mpiWorld->allReduce(ener.E["NI"], MPIUtil::ReduceSum);
 		
@@ -144,6 +179,44 @@ struct LCAOminimizer : Minimizable<ElecGradient> //Uses only the Haux entries of
 	{	eInfo.smearReport();
 		return false;
 	}
+	
+	//Atomic orbitals for state q (with nExtra extra columns to be randomized later):
+	static void initOrbitals_q(int q, LCAOminimizer* lcao, int nExtra)
+	{	lcao->eVars.C[q] = lcao->e.iInfo.getAtomicOrbitals(q, false, nExtra);
+	}
+	
+	//Orthonormalize orbitals and compute non-interacting subspace Hamiltonian for state q:
+	static void initHni_q(int q, LCAOminimizer* lcao)
+	{	ElecVars& eVars = lcao->eVars;
+		const IonInfo& iInfo = lcao->e.iInfo;
+		eVars.orthonormalize(q);
+		ColumnBundle HniCq = -0.5*L(eVars.C[q]);
+		std::vector<matrix> HVdagCq(iInfo.species.size());
+		iInfo.EnlAndGrad(lcao->eInfo.qnums[q], eye(lcao->nBands), eVars.VdagC[q], HVdagCq); //non-local pseudopotentials
+		iInfo.projectGrad(HVdagCq, eVars.C[q], HniCq);
+		lcao->HniSub[q] = eVars.C[q]^HniCq;
+		lcao->rotPrev[q] = eye(lcao->nBands);
+		eVars.F[q].resize(lcao->nBands, 0.);
+	}
+	
+	//Subspace Hamiltonian in the current potential for state q, and switch to its eigenvectors:
+	static void subspaceRotate_q(int q, LCAOminimizer* lcao)
+	{	ElecVars& eVars = lcao->eVars;
+		const IonInfo& iInfo = lcao->e.iInfo;
+		ColumnBundle HCq = Idag_DiagV_I(eVars.C[q], eVars.Vscloc); //local self-consistent potential
+		std::vector<matrix> HVdagCq(iInfo.species.size());
+		iInfo.augmentDensitySphericalGrad(lcao->eInfo.qnums[q], eVars.VdagC[q], HVdagCq); //ultrasoft augmentation
+		iInfo.projectGrad(HVdagCq, eVars.C[q], HCq);
+		eVars.Hsub[q] = dagger(lcao->rotPrev[q]) * lcao->HniSub[q] * lcao->rotPrev[q] + (eVars.C[q]^HCq);
+		//Switch to eigenvectors of Hsub:
+		eVars.Hsub[q].diagonalize(eVars.Hsub_evecs[q], eVars.Hsub_eigs[q]);
+		eVars.C[q] = eVars.C[q] * eVars.Hsub_evecs[q];
+		for(unsigned sp=0; sp<iInfo.species.size(); sp++)
+			if(eVars.VdagC[q][sp]) eVars.VdagC[q][sp] = eVars.VdagC[q][sp] * eVars.Hsub_evecs[q];
+		lcao->rotPrev[q] = lcao->rotPrev[q] * eVars.Hsub_evecs[q];
+		eVars.Hsub[q] = eVars.Hsub_eigs[q];
+		eVars.Hsub_evecs[q] = eye(lcao->nBands);
+	}
 };
 
 
@@ -184,19 +257,11 @@ int ElecVars::LCAO()
 	
 	//Get orthonormal atomic orbitals and non-interacting part of subspace Hamiltonian:
 	lcao.nBands = std::max(nAtomic+1, std::max(eInfo.nBands, int(ceil(1+eInfo.nElectrons/eInfo.qWeightSum))));
-	for(int q=eInfo.qStart; q<eInfo.qStop; q++)
-	{	C[q] = iInfo.getAtomicOrbitals(q, false, lcao.nBands-nAtomic);
-		if(nAtomic<lcao.nBands) C[q].randomize(nAtomic, lcao.nBands); //Randomize extra columns if any
-		orthonormalize(q);
-		//Non-interacting Hamiltonian:
-		ColumnBundle HniCq = -0.5*L(C[q]);
-		std::vector<matrix> HVdagCq(iInfo.species.size());
-		iInfo.EnlAndGrad(eInfo.qnums[q], eye(lcao.nBands), VdagC[q], HVdagCq); //non-local pseudopotentials
-		iInfo.projectGrad(HVdagCq, C[q], HniCq);
-		lcao.HniSub[q] = C[q]^HniCq;
-		lcao.rotPrev[q] = eye(lcao.nBands);
-		F[q].resize(lcao.nBands, 0.);
-	}
+	lcao.forStates(LCAOminimizer::initOrbitals_q, &lcao, lcao.nBands-nAtomic);
+	if(nAtomic<lcao.nBands) //Randomize extra columns if any (serially, to keep random sequence independent of threading)
+		for(int q=eInfo.qStart; q<eInfo.qStop; q++)
+			C[q].randomize(nAtomic, lcao.nBands);
+	lcao.forStates(LCAOminimizer::initHni_q, &lcao);
 	
 	//Get electron density obtained by adding those of the atoms:
 	if(!e->cntrl.fixed_H)
@@ -228,24 +293,7 @@ int ElecVars::LCAO()
 		iInfo.augmentDensityInit();
 		iInfo.augmentDensityGridGrad(Vscloc); //Update Vscloc projections on ultrasoft pseudopotentials
 		
-		for(int q=eInfo.qStart; q<eInfo.qStop; q++)
-		{
-			//Calculate subspace Hamiltonian:
-			ColumnBundle HCq = Idag_DiagV_I(C[q], Vscloc); //local self-consistent potential
-			std::vector<matrix> HVdagCq(iInfo.species.size());
-			iInfo.augmentDensitySphericalGrad(eInfo.qnums[q], VdagC[q], HVdagCq); //ultrasoft augmentation
-			iInfo.projectGrad(HVdagCq, C[q], HCq);
-			Hsub[q] = dagger(lcao.rotPrev[q]) * lcao.HniSub[q] * lcao.rotPrev[q] + (C[q]^HCq);
-			
-			//Switch to eigenvectors of Hsub:
-			Hsub[q].diagonalize(Hsub_evecs[q], Hsub_eigs[q]);
-			C[q] = C[q] * Hsub_evecs[q];
-			for(unsigned sp=0; sp<iInfo.species.size(); sp++)
-				if(VdagC[q][sp]) VdagC[q][sp] = VdagC[q][sp] * Hsub_evecs[q]; 
-			lcao.rotPrev[q] = lcao.rotPrev[q] * Hsub_evecs[q];
-			Hsub[q] = Hsub_eigs[q];
-			Hsub_evecs[q] = eye(lcao.nBands);
-		}
+		lcao.forStates(LCAOminimizer::subspaceRotate_q, &lcao); //subspace Hamiltonian and rotation (per state)
 		
 		if(pass+1<nPasses) n = calcDensity(); //only needed here for a subsequent pass
 	}
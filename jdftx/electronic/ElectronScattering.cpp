@@ -42,8 +42,10 @@ double regularizedDelta(double omega, double omega0, double etaInv)
 	return (1./M_PI) * (etaInv/(1+t*t));
 }
 
+diagMatrix diagouter(const matrix& A, const matrix& B); //diag(A*dagger(B)), defined below
+
 ElectronScattering::ElectronScattering()
-: eta(0.), Ecut(0.), fCut(1e-6), omegaMax(0.), RPA(false), slabResponse(false), EcutTransverse(0.)
+: eta(0.), Ecut(0.), fCut(1e-6), omegaMax(0.), RPA(false), maxMemory(0.), slabResponse(false), EcutTransverse(0.)
 {
 }
 
@@ -303,61 +305,120 @@ void ElectronScattering::dump(const Everything& everything)
 		}
 		assert(iHead < nbasis);
 		
-		//Calculate Im(screened Coulomb operator):
+		//Calculate Im(screened Coulomb operator), which stays distributed over frequencies:
 		logPrintf("\tComputing Im(Kscreened) ... "); logFlush();
-		std::vector<matrix> ImKscr(omegaGrid.nRows());
+		matrix ImKscrMine(nbasis, nbasis*(iOmegaStop-iOmegaStart)); //ImKscr for local frequencies, stacked column-wise
 		for(int iOmega=iOmegaStart; iOmega<iOmegaStop; iOmega++)
 		{	matrix chi0 = RPA
 				? chiKS[iOmega]
 				: inv(eye(nbasis) - chiKS[iOmega] * Kxc) * chiKS[iOmega];
 			chiKS[iOmega] = 0; //free to save memory
-			ImKscr[iOmega] = Im(inv(invKq - chi0));
+			matrix ImKscr = Im(inv(invKq - chi0));
 			chi0 = 0; //free to save memory
-			ImKscrHead[iOmega] += qmesh[iq].weight * ImKscr[iOmega](iHead,iHead).real(); //accumulate head of ImKscr
+			ImKscrHead[iOmega] += qmesh[iq].weight * ImKscr(iHead,iHead).real(); //accumulate head of ImKscr
+			callPref(eblas_copy)(ImKscrMine.dataPref()+ImKscrMine.index(0,(iOmega-iOmegaStart)*nbasis), ImKscr.dataPref(), ImKscr.nData());
 		}
 		chiKS.clear(); //free memory; no longer needed
-		for(int iOmega=0; iOmega<omegaGrid.nRows(); iOmega++)
-		{	if(!omegaDiv.isMine(iOmega)) ImKscr[iOmega] = zeroes(nbasis,nbasis);
-			mpiWorld->bcastData(ImKscr[iOmega], omegaDiv.whose(iOmega));
-		}
 		logPrintf("done.\n"); logFlush();
 		
-		//Calculate ImSigma contributions:
+		//Collect events for ImSigma in batches of local k-points and spins, bounded by maxMemory:
 		logPrintf("\tComputing ImSigma ... "); logFlush(); 
-		for(size_t ik=ikStart; ik<ikStop; ik++)
-		for(int iSpin=0; iSpin<nSpins; iSpin++)
-		{	//Report progress:
-			size_t ikDone = ik-ikStart+1;
-			if(ikDone % ikInterval == 0 && !iSpin)
-			{	logPrintf("%d%% ", int(round(ikDone*100./nkMine)));
-				logFlush();
+		struct EventSet
+		{	size_t ik; int iSpin;
+			std::vector<Event> events;
+			matrix nijDag; //dagger of pair densities in basisChi
+			diagMatrix contrib; //frequency-integrated contribution of each event to linewidth
+		};
+		const double maxBytes = maxMemory * 1024*1024;
+		size_t ikNext = ikStart; int iSpinNext = 0; //next local k-point and spin whose events are to be collected
+		int nBatches = 0;
+		while(true)
+		{	std::vector<EventSet> eventSets;
+			double eventSetBytes = 0.;
+			while(ikNext<ikStop && !(maxBytes && eventSets.size() && eventSetBytes>=maxBytes))
+			{	size_t ik = ikNext; int iSpin = iSpinNext;
+				if(++iSpinNext == nSpins) { iSpinNext = 0; ikNext++; }
+				//Report progress:
+				size_t ikDone = ik-ikStart+1;
+				if(ikDone % ikInterval == 0 && !iSpin)
+				{	logPrintf("%d%% ", int(round(ikDone*100./nkMine)));
+					logFlush();
+				}
+				//Get events:
+				size_t jk; matrix nij;
+				std::vector<Event> events = getEvents(false, iSpin, ik, iq, jk, nij);
+				if(!events.size()) continue;
+				EventSet es;
+				es.ik = ik; es.iSpin = iSpin;
+				es.events = events;
+				es.nijDag = dagger(nij);
+				es.contrib.assign(events.size(), 0.);
+				eventSets.push_back(es);
+				eventSetBytes += es.nijDag.nData() * sizeof(complex);
 			}
-			//Get events:
-			size_t jk; matrix nij;
-			std::vector<Event> events = getEvents(false, iSpin, ik, iq, jk, nij);
-			if(!events.size()) continue;
-			//Integrate over frequency for event contributions to linewidth:
-			diagMatrix eventContrib(events.size(), 0);
-			for(int iOmega=0; iOmega<omegaGrid.nRows(); iOmega++)
-			{	//Construct energy conserving delta-function:
-				double omega = omegaGrid[iOmega];
-				complex omegaTilde(omega, 2*eta);
-				diagMatrix delta; delta.reserve(events.size());
-				for(const Event& event: events)
-					delta.push_back(e.gInfo.detR * event.fWeight * //overlap and sign for electron / hole
-						( regularizedDelta(omega, +event.Eji, etaInv)
-						- regularizedDelta(omega, -event.Eji, etaInv) ) ); //pick up correct omega
-				eventContrib += wOmega[iOmega] * delta * diag(dagger(nij) * ImKscr[iOmega] * nij);
+			//Stop once all processes have processed all their events (frequency integration below is collective):
+			int anyPending = eventSets.size() ? 1 : 0;
+			mpiWorld->allReduce(anyPending, MPIUtil::ReduceMax);
+			if(!anyPending) break;
+			nBatches++;
+			//Integrate over frequency, streaming ImKscr from each process in turn (next block prefetched during computation):
+			int nProcs = mpiWorld->nProcesses(), iProc = mpiWorld->iProcess();
+			matrix ImKscrBuf[2]; MPIUtil::Request request[2];
+			auto startBcast = [&](int jProc)
+			{	if(jProc >= nProcs) return;
+				matrix& buf = (jProc == iProc) ? ImKscrMine : ImKscrBuf[jProc % 2]; //broadcast local block in place
+				if(jProc != iProc) buf = matrix(nbasis, nbasis*(omegaDiv.stop(jProc)-omegaDiv.start(jProc)));
+				if(buf.nData()) mpiWorld->bcastData(buf, jProc, &request[jProc % 2]);
+			};
+			startBcast(0);
+			for(int jProc=0; jProc<nProcs; jProc++)
+			{	startBcast(jProc+1); //prefetch next block
+				const matrix& ImKscrBlock = (jProc == iProc) ? ImKscrMine : ImKscrBuf[jProc % 2];
+				int jOmegaStart = omegaDiv.start(jProc);
+				int nOmegaBlock = omegaDiv.stop(jProc) - jOmegaStart;
+				if(!nOmegaBlock) continue;
+				mpiWorld->wait(request[jProc % 2]);
+				for(EventSet& es: eventSets)
+				{	const std::vector<Event>& events = es.events;
+					int nEvents = events.size();
+					//Process frequencies in chunks, with the intermediate dagger(nij)*ImKscr no larger than ImKscrBlock:
+					int nOmegaChunk = std::max(1, std::min(nOmegaBlock, (nOmegaBlock*nbasis)/nEvents));
+					for(int iOmegaChunk=0; iOmegaChunk<nOmegaBlock; iOmegaChunk+=nOmegaChunk)
+					{	int nOmegaCur = std::min(nOmegaChunk, nOmegaBlock-iOmegaChunk);
+						//Single matrix product over all frequencies in chunk: nijDagKscr = dagger(nij) * [ImKscr(omega1) ImKscr(omega2) ...]
+						matrix nijDagKscr(nEvents, nbasis*nOmegaCur);
+						callPref(eblas_zgemm)(CblasNoTrans, CblasNoTrans, nEvents, nbasis*nOmegaCur, nbasis,
+							1., es.nijDag.dataPref(), nEvents, ImKscrBlock.dataPref()+ImKscrBlock.index(0,iOmegaChunk*nbasis), nbasis,
+							0., nijDagKscr.dataPref(), nEvents);
+						for(int iOmegaCur=0; iOmegaCur<nOmegaCur; iOmegaCur++)
+						{	int iOmega = jOmegaStart + iOmegaChunk + iOmegaCur;
+							//Construct energy conserving delta-function:
+							double omega = omegaGrid[iOmega];
+							diagMatrix delta; delta.reserve(events.size());
+							for(const Event& event: events)
+								delta.push_back(e.gInfo.detR * event.fWeight * //overlap and sign for electron / hole
+									( regularizedDelta(omega, +event.Eji, etaInv)
+									- regularizedDelta(omega, -event.Eji, etaInv) ) ); //pick up correct omega
+							matrix nijDagKscrCur = nijDagKscr(0,nEvents, iOmegaCur*nbasis,(iOmegaCur+1)*nbasis);
+							es.contrib += wOmega[iOmega] * delta * diagouter(nijDagKscrCur, es.nijDag); //= diag(dagger(nij) * ImKscr[iOmega] * nij)
+						}
+					}
+				}
+				ImKscrBuf[jProc % 2] = 0; //free block
 			}
-			//Accumulate contributions to linewidth:
-			int iReduced = supercell->kmeshTransform[ik].iReduced; //directly collect to reduced k-point
-			double symFactor = e.eInfo.spinWeight / (supercell->kmesh.size() * e.eInfo.qnums[iReduced].weight); //symmetrization factor = 1 / |orbit of iReduced|
-			double qWeight = qmesh[iq].weight;
-			for(size_t iEvent=0; iEvent<events.size(); iEvent++)
-			{	const Event& event = events[iEvent];
-				ImSigma[iReduced+iSpin*qCount][event.i] += symFactor * qWeight * eventContrib[iEvent];
+			//Accumulate contributions to linewidth (event sets of this batch are freed at end of scope):
+			for(const EventSet& es: eventSets)
+			{	int iReduced = supercell->kmeshTransform[es.ik].iReduced; //directly collect to reduced k-point
+				double symFactor = e.eInfo.spinWeight / (supercell->kmesh.size() * e.eInfo.qnums[iReduced].weight); //symmetrization factor = 1 / |orbit of iReduced|
+				double qWeight = qmesh[iq].weight;
+				for(size_t iEvent=0; iEvent<es.events.size(); iEvent++)
+				{	const Event& event = es.events[iEvent];
+					ImSigma[iReduced+es.iSpin*qCount][event.i] += symFactor * qWeight * es.contrib[iEvent];
+				}
 			}
 		}
+		ImKscrMine = 0;
+		if(nBatches > 1) logPrintf("(%d event batches) ", nBatches);
 		logPrintf("done.\n"); logFlush();
 	}
 	logPrintf("\n");
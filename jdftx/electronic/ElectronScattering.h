@@ -39,6 +39,7 @@ struct ElectronScattering
 	double fCut; //!< threshold for considering states fully occupied / unoccupied (default: 1e-6)
 	double omegaMax; //!< maximum energy transfer to account for and hence maximum frequency in dielectric grid (if zero, autodetermine from available eigenvalues)
 	bool RPA; //!< if true, ignore XC (RPA response)
+	double maxMemory; //!< memory budget (in MB per process) for pair densities held while integrating ImSigma over frequency (if zero, hold all)
 	
 	bool slabResponse; //!< whether to work in slab response output mode
 	double EcutTransverse; //!< energy cutoff in directions transverse to slab normal (same as Ecut above if unspecified)
@@ -137,6 +137,75 @@ void FunctionalGGA::evaluate(int N, std::vector<const double*> n, std::vector<co
 }
 
 
+//---------------- Fused LDA / GGA exchange-correlation thread launchers / gpu switch --------------------
+
+FunctionalLDAxc::FunctionalLDAxc(LDA_Variant cVariant, double scaleFac) : Functional(scaleFac), cVariant(cVariant)
+{	switch(cVariant)
+	{	case LDA_C_PZ:      logPrintf("Initalized Slater LDA exchange and Perdew-Zunger LDA correlation.\n"); break;
+		case LDA_C_PW:      logPrintf("Initalized Slater LDA exchange and Perdew-Wang LDA correlation.\n"); break;
+		case LDA_C_PW_prec: logPrintf("Initalized Slater LDA exchange and Perdew-Wang LDA correlation (extended precision).\n"); break;
+		case LDA_C_VWN:     logPrintf("Initalized Slater LDA exchange and Vosko-Wilk-Nusair LDA correlation.\n"); break;
+		default: die("Unsupported correlation functional in fused LDA exchange-correlation.\n");
+	}
+}
+
+template<LDA_Variant cVariant, int nCount>
+void LDA_XC(int N, array<const double*,nCount> n, double* E, array<double*,nCount> E_n, double scaleFac)
+{	threadedLoop(LDA_XC_calc<cVariant,nCount>::compute, N, n, E, E_n, scaleFac);
+}
+void LDA_XC(LDA_Variant cVariant, int N, std::vector<const double*> n, double* E, std::vector<double*> E_n, double scaleFac)
+{	SwitchTemplate_spin(SwitchTemplate_LDA_XC, cVariant, n.size(), LDA_XC, (N, n, E, E_n, scaleFac) )
+}
+#ifdef GPU_ENABLED
+void LDA_XC_gpu(LDA_Variant cVariant, int N, std::vector<const double*> n, double* E, std::vector<double*> E_n, double scaleFac);
+#endif
+
+void FunctionalLDAxc::evaluate(int N, std::vector<const double*> n, std::vector<const double*> sigma,
+	std::vector<const double*> lap, std::vector<const double*> tau,
+	double* E, std::vector<double*> E_n, std::vector<double*> E_sigma,
+	std::vector<double*> E_lap, std::vector<double*> E_tau) const
+{	assert(n.size()==1 || n.size()==2);
+	callPref(LDA_XC)(cVariant, N, n, E, E_n, scaleFac);
+}
+
+FunctionalGGAxc::FunctionalGGAxc(GGA_Variant xVariant, GGA_Variant cVariant, double scaleX, double scaleSR)
+: xVariant(xVariant), cVariant(cVariant), scaleX(scaleX), scaleSR(scaleSR)
+{	if(xVariant==GGA_X_PBE && cVariant==GGA_C_PBE)
+		logPrintf("Initalized PBE GGA exchange%s and correlation.\n", scaleSR ? " (with short-ranged omega-PBE exchange)" : "");
+	else if(xVariant==GGA_X_PBEsol && cVariant==GGA_C_PBEsol && !scaleSR)
+		logPrintf("Initalized PBEsol GGA exchange and correlation.\n");
+	else if(xVariant==GGA_X_PW91 && cVariant==GGA_C_PW91 && !scaleSR)
+		logPrintf("Initalized PW91 GGA exchange and correlation.\n");
+	else die("Unsupported combination in fused GGA exchange-correlation.\n");
+}
+
+template<GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int nCount>
+void GGA_XC(int N, array<const double*,nCount> n, array<const double*,2*nCount-1> sigma,
+	double* E, array<double*,nCount> E_n, array<double*,2*nCount-1> E_sigma, double scaleX, double scaleSR, double scaleC)
+{	threadedLoop(GGA_XC_calc<xVariant,cVariant,screened,nCount>::compute, N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC);
+}
+void GGA_XC(GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int N, std::vector<const double*> n, std::vector<const double*> sigma,
+	double* E, std::vector<double*> E_n, std::vector<double*> E_sigma, double scaleX, double scaleSR, double scaleC)
+{	switch(n.size())
+	{	case 1: { SwitchTemplate_GGA_XC(xVariant,cVariant,screened,1, GGA_XC, (N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC)) break; }
+		case 2: { SwitchTemplate_GGA_XC(xVariant,cVariant,screened,2, GGA_XC, (N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC)) break; }
+		default: break;
+	}
+}
+#ifdef GPU_ENABLED
+void GGA_XC_gpu(GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int N, std::vector<const double*> n, std::vector<const double*> sigma,
+	double* E, std::vector<double*> E_n, std::vector<double*> E_sigma, double scaleX, double scaleSR, double scaleC);
+#endif
+
+void FunctionalGGAxc::evaluate(int N, std::vector<const double*> n, std::vector<const double*> sigma,
+	std::vector<const double*> lap, std::vector<const double*> tau,
+	double* E, std::vector<double*> E_n, std::vector<double*> E_sigma,
+	std::vector<double*> E_lap, std::vector<double*> E_tau) const
+{	assert(n.size()==1 || n.size()==2);
+	callPref(GGA_XC)(xVariant, cVariant, scaleSR!=0., N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleFac);
+}
+
+
 //---------------- metaGGA thread launcher / gpu switch --------------------
 
 FunctionalMGGA::FunctionalMGGA(mGGA_Variant variant, double scaleFac) : Functional(scaleFac), variant(variant)
@@ -296,52 +365,98 @@ public:
 		if(E_tauTemp.size()) eblas_daxpy(Nn, 1., &E_tauTemp[0], 1, E_tau, 1);
 	}
 	
-	static void evaluate_thread(int iStart, int iStop, const FunctionalLibXC* func, int iOffset,
-		int nCount, const double* n, const double* sigma, const double* lap, const double* tau,
-		double* e, double* E_n, double* E_sigma, double* E_lap, double* E_tau)
+	//! Evaluate on points iOffset+iStart to iOffset+iStop given separate (non-interleaved) spin-component arrays.
+	//! Spin-polarized data is interleaved into (and gradients out of) LibXC order in small cache-resident
+	//! blocks, instead of transposing entire fields; unpolarized data is passed to LibXC directly.
+	static void evaluate_thread(int iStart, int iStop, const FunctionalLibXC* func, int iOffset, int nCount,
+		std::vector<const double*> n, std::vector<const double*> sigma, std::vector<const double*> lap, std::vector<const double*> tau,
+		double* e, std::vector<double*> E_n, std::vector<double*> E_sigma, std::vector<double*> E_lap, std::vector<double*> E_tau)
 	{
-		int offs_e = (iOffset+iStart);
-		int offs_n = offs_e * nCount;
-		int offs_sigma = offs_e * (2*nCount-1);
-		int N = iStop-iStart; if(!N) return;
-		#define OFFSET(ptr,offset) ((ptr) ? ((ptr)+(offset)) : 0)
-		func->evaluate(nCount, N, OFFSET(n,offs_n), OFFSET(sigma,offs_sigma), OFFSET(lap,offs_n), OFFSET(tau,offs_n),
-			OFFSET(e,offs_e), OFFSET(E_n,offs_n), OFFSET(E_sigma,offs_sigma), OFFSET(E_lap,offs_n), OFFSET(E_tau,offs_n) );
-		#undef OFFSET
+		const int blockSize = 1024;
+		const int sigmaCount = 2*nCount-1;
+		const bool needsSigma = func->needsSigma(), needsLap = func->needsLap(), needsTau = func->needsTau();
+		const bool needsGrad = E_n[0];
+		if(nCount == 1)
+		{	for(int iBlock=iOffset+iStart; iBlock<iOffset+iStop; iBlock+=blockSize)
+			{	int N = std::min(blockSize, iOffset+iStop-iBlock);
+				#define OFFSET(ptrs,needed) ((needed) ? ((ptrs)[0]+iBlock) : 0)
+				func->evaluate(1, N, n[0]+iBlock, OFFSET(sigma,needsSigma), OFFSET(lap,needsLap), OFFSET(tau,needsTau),
+					e+iBlock, OFFSET(E_n,needsGrad), OFFSET(E_sigma,needsGrad && needsSigma),
+					OFFSET(E_lap,needsGrad && needsLap), OFFSET(E_tau,needsGrad && needsTau) );
+				#undef OFFSET
+			}
+			return;
+		}
+		//Spin-polarized: scratch space for one block in LibXC order
+		std::vector<double> nBlock(nCount*blockSize), sigmaBlock(needsSigma ? sigmaCount*blockSize : 0);
+		std::vector<double> lapBlock(needsLap ? nCount*blockSize : 0), tauBlock(needsTau ? nCount*blockSize : 0);
+		std::vector<double> E_nBlock(needsGrad ? nCount*blockSize : 0), E_sigmaBlock(needsGrad ? sigmaBlock.size() : 0);
+		std::vector<double> E_lapBlock(needsGrad ? lapBlock.size() : 0), E_tauBlock(needsGrad ? tauBlock.size() : 0);
+		#define DATA(v) ((v).size() ? (v).data() : 0)
+		for(int iBlock=iOffset+iStart; iBlock<iOffset+iStop; iBlock+=blockSize)
+		{	int N = std::min(blockSize, iOffset+iStop-iBlock);
+			interleave(N, n, iBlock, nBlock);
+			if(needsSigma) interleave(N, sigma, iBlock, sigmaBlock);
+			if(needsLap) interleave(N, lap, iBlock, lapBlock);
+			if(needsTau) interleave(N, tau, iBlock, tauBlock);
+			for(std::vector<double>* v: {&E_nBlock, &E_sigmaBlock, &E_lapBlock, &E_tauBlock})
+				std::fill(v->begin(), v->end(), 0.);
+			func->evaluate(nCount, N, DATA(nBlock), DATA(sigmaBlock), DATA(lapBlock), DATA(tauBlock),
+				e+iBlock, DATA(E_nBlock), DATA(E_sigmaBlock), DATA(E_lapBlock), DATA(E_tauBlock));
+			if(needsGrad)
+			{	deinterleaveAccum(N, E_nBlock, E_n, iBlock);
+				if(needsSigma) deinterleaveAccum(N, E_sigmaBlock, E_sigma, iBlock);
+				if(needsLap) deinterleaveAccum(N, E_lapBlock, E_lap, iBlock);
+				if(needsTau) deinterleaveAccum(N, E_tauBlock, E_tau, iBlock);
+			}
+		}
+		#undef DATA
 	}
 	
+	//! Evaluate on points iStart to iStop, given separate (non-interleaved) spin-component arrays on the CPU
 	void evaluateSub(int nCount, int iStart, int iStop,
-		const double* n, const double* sigma, const double* lap, const double* tau,
-		double* e, double* E_n, double* E_sigma, double* E_lap, double* E_tau) const
+		std::vector<const double*> n, std::vector<const double*> sigma, std::vector<const double*> lap, std::vector<const double*> tau,
+		double* e, std::vector<double*> E_n, std::vector<double*> E_sigma, std::vector<double*> E_lap, std::vector<double*> E_tau) const
 	{
 		int N = iStop-iStart; if(!N) return;
 		threadLaunch(FunctionalLibXC::evaluate_thread, N, this, iStart,
 			nCount, n, sigma, lap, tau, e, E_n, E_sigma, E_lap, E_tau);
 	}
+
+private:
+	//! Copy a block of N points starting at iStart from the component arrays x into interleaved order in out
+	static void interleave(int N, const std::vector<const double*>& x, int iStart, std::vector<double>& out)
+	{	const int M = x.size();
+		for(int m=0; m<M; m++)
+		{	const double* xm = x[m] + iStart;
+			for(int j=0; j<N; j++)
+				out[j*M+m] = xm[j];
+		}
+	}
+	
+	//! Accumulate a block of N interleaved points from in onto the component arrays y starting at iStart
+	static void deinterleaveAccum(int N, const std::vector<double>& in, const std::vector<double*>& y, int iStart)
+	{	const int M = y.size();
+		for(int m=0; m<M; m++)
+		{	double* ym = y[m] + iStart;
+			for(int j=0; j<N; j++)
+				ym[j] += in[j*M+m];
+		}
+	}
 };
 
-//! Convert a collection of scalar fields into an interleaved vector field.
-//! result can be freed using delete[]
-template<unsigned M> double* transpose(const ScalarFieldArray& inVec)
-{	assert(inVec.size()==M);
-	const unsigned N = inVec[0]->nElem;
-	const double* in[M]; for(unsigned m=0; m<M; m++) in[m] = inVec[m]->data();
-	double *out = new double[M*N], *outPtr = out;
-	for(unsigned n=0; n<N; n++)
-		for(unsigned m=0; m<M; m++)
-			*(outPtr++) = in[m][n];
-	return out;
-}
-
-//! Convert an interleaved vector field to a collection of scalar fields
-template<unsigned M> void transpose(double* in, ScalarFieldArray& outVec)
-{	assert(outVec.size()==M);
-	const unsigned N = outVec[0]->nElem;
-	double* out[M]; for(unsigned m=0; m<M; m++) out[m] = outVec[m]->data();
-	double *inPtr = in;
-	for(unsigned n=0; n<N; n++)
-		for(unsigned m=0; m<M; m++)
-			out[m][n] = *(inPtr++);
+//! Extract CPU data pointers from a ScalarFieldArray (LibXC always runs on the CPU)
+std::vector<const double*> constDataCPU(const ScalarFieldArray& x)
+{	std::vector<const double*> xData(x.size());
+	for(unsigned s=0; s<x.size(); s++)
+		xData[s] = x[s] ? x[s]->data() : 0;
+	return xData;
+}
+std::vector<double*> dataCPU(ScalarFieldArray& x)
+{	std::vector<double*> xData(x.size());
+	for(unsigned s=0; s<x.size(); s++)
+		xData[s] = x[s] ? x[s]->data() : 0;
+	return xData;
 }
 
 #endif //LIBXC_ENABLED
@@ -359,6 +474,12 @@ struct FunctionalList
 	void add(mGGA_Variant variant, double scaleFac=1.0)
 	{	internal.push_back(std::make_shared<FunctionalMGGA>(variant, scaleFac));
 	}
+	void addFused(LDA_Variant cVariant) //!< Slater exchange + cVariant correlation in one sweep
+	{	internal.push_back(std::make_shared<FunctionalLDAxc>(cVariant));
+	}
+	void addFused(GGA_Variant xVariant, GGA_Variant cVariant, double scaleX=1.0, double scaleSR=0.0) //!< see FunctionalGGAxc
+	{	internal.push_back(std::make_shared<FunctionalGGAxc>(xVariant, cVariant, scaleX, scaleSR));
+	}
 	
 	#ifdef LIBXC_ENABLED
 	std::vector<std::shared_ptr<FunctionalLibXC> > libXC; //!<Functionals which use LibXC for evaluation
@@ -409,23 +530,19 @@ void ExCorr::setup(const Everything& everything)
 		#endif //LIBXC_ENABLED
 		
 		case ExCorrLDA_PZ:
-			functionals->add(LDA_X_Slater);
-			functionals->add(LDA_C_PZ);
+			functionals->addFused(LDA_C_PZ);
 			Citations::add(citeReason, "J.P. Perdew and A. Zunger, Phys. Rev. B 23, 5048 (1981)");
 			break;
 		case ExCorrLDA_PW:
-			functionals->add(LDA_X_Slater);
-			functionals->add(LDA_C_PW);
+			functionals->addFused(LDA_C_PW);
 			Citations::add(citeReason, "J.P. Perdew and Y. Wang, Phys. Rev. B 45, 13244 (1992)");
 			break;
 		case ExCorrLDA_PW_prec:
-			functionals->add(LDA_X_Slater);
-			functionals->add(LDA_C_PW_prec);
+			functionals->addFused(LDA_C_PW_prec);
 			Citations::add(citeReason, "J.P. Perdew and Y. Wang, Phys. Rev. B 45, 13244 (1992)");
 			break;
 		case ExCorrLDA_VWN:
-			functionals->add(LDA_X_Slater);
-			functionals->add(LDA_C_VWN);
+			functionals->addFused(LDA_C_VWN);
 			Citations::add(citeReason, "S.H. Vosko, L. Wilk and M. Nusair, Can. J. Phys. 58, 1200 (1980)");
 			break;
 		case ExCorrLDA_Teter:
@@ -433,18 +550,15 @@ void ExCorr::setup(const Everything& everything)
 			Citations::add(citeReason, "S. Goedecker, M. Teter and J. Hutter, Phys. Rev. B 54, 1703 (1996)");
 			break;
 		case ExCorrGGA_PBE:
-			functionals->add(GGA_X_PBE);
-			functionals->add(GGA_C_PBE);
+			functionals->addFused(GGA_X_PBE, GGA_C_PBE);
 			Citations::add(citeReason, "J.P. Perdew, K. Burke and M. Ernzerhof, Phys. Rev. Lett. 77, 3865 (1996)");
 			break;
 		case ExCorrGGA_PBEsol:
-			functionals->add(GGA_X_PBEsol);
-			functionals->add(GGA_C_PBEsol);
+			functionals->addFused(GGA_X_PBEsol, GGA_C_PBEsol);
 			Citations::add(citeReason, "J.P. Perdew et al., Phys. Rev. Lett. 100, 136406 (2008)");
 			break;
 		case ExCorrGGA_PW91:
-			functionals->add(GGA_X_PW91);
-			functionals->add(GGA_C_PW91);
+			functionals->addFused(GGA_X_PW91, GGA_C_PW91);
 			Citations::add(citeReason, "J.P. Perdew et al., Phys. Rev. B 46, 6671 (1992)");
 			break;
 		case ExCorrMGGA_TPSS:
@@ -466,39 +580,31 @@ void ExCorr::setup(const Everything& everything)
 			Citations::add(citeReason, "M. Kuisma, J. Ojanen, J. Enkovaara and T. T. Rantala, Phys. Rev. B 82, 115106 (2010)");
 			break;
 		case ExCorrPOT_LB94:
-			functionals->add(LDA_X_Slater);
-			functionals->add(LDA_C_PZ);
+			functionals->addFused(LDA_C_PZ);
 			functionals->add(GGA_X_LB94);
 			Citations::add(citeReason, "R. van Leeuwen and E. J. Baerends, Phys. Rev. A 49, 2421 (1994)");
 			break;
 		case ExCorrHYB_PBE0:
 			exxScale = exxScaleOverride ? exxScaleOverride : 1./4;
-			functionals->add(GGA_X_PBE, 1.-exxScale);
-			functionals->add(GGA_C_PBE);
+			functionals->addFused(GGA_X_PBE, GGA_C_PBE, 1.-exxScale);
 			Citations::add(citeReason, "M. Ernzerhof and G. E. Scuseria, J. Chem. Phys. 110, 5029 (1999)");
 			break;
 		case ExCorrHYB_HSE06:
 			exxOmega = exxOmegaOverride ? exxOmegaOverride : 0.11;
 			exxScale = exxScaleOverride ? exxScaleOverride : 1./4;
-			functionals->add(GGA_X_wPBE_SR, -exxScale);
-			functionals->add(GGA_X_PBE);
-			functionals->add(GGA_C_PBE);
+			functionals->addFused(GGA_X_PBE, GGA_C_PBE, 1., -exxScale);
 			Citations::add(citeReason, "A.V. Krukau, O.A. Vydrov, A.F. Izmaylov and G.E. Scuseria, J. Chem. Phys. 125, 224106 (2006)");
 			break;
 		case ExCorrHYB_HSE12:
 			exxOmega = exxOmegaOverride ? exxOmegaOverride : 0.185;
 			exxScale = exxScaleOverride ? exxScaleOverride : 0.313;
-			functionals->add(GGA_X_wPBE_SR, -exxScale);
-			functionals->add(GGA_X_PBE);
-			functionals->add(GGA_C_PBE);
+			functionals->addFused(GGA_X_PBE, GGA_C_PBE, 1., -exxScale);
 			Citations::add(citeReason, "J.E. Moussa, P.A. Schultz and J.R. Chelikowsky, J. Chem. Phys. 136, 204117 (2012)");
 			break;
 		case ExCorrHYB_HSE12s:
 			exxOmega = exxOmegaOverride ? exxOmegaOverride : 0.408;
 			exxScale = exxScaleOverride ? exxScaleOverride : 0.425;
-			functionals->add(GGA_X_wPBE_SR, -exxScale);
-			functionals->add(GGA_X_PBE);
-			functionals->add(GGA_C_PBE);
+			functionals->addFused(GGA_X_PBE, GGA_C_PBE, 1., -exxScale);
 			Citations::add(citeReason, "J.E. Moussa, P.A. Schultz and J.R. Chelikowsky, J. Chem. Phys. 136, 204117 (2012)");
 			break;
 		case ExCorrHF:
@@ -617,7 +723,7 @@ template<typename Func> bool shouldInclude(const std::shared_ptr<Func>& function
 }
 
 double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, IncludeTXC includeTXC,
-		const ScalarFieldArray* tauPtr, ScalarFieldArray* Vtau) const
+		const ScalarFieldArray* tauPtr, ScalarFieldArray* Vtau, bool localOnly) const
 {
 	static StopWatch watch("ExCorrTotal"), watchComm("ExCorrCommunication"), watchFunc("ExCorrFunctional");
 	watch.start();
@@ -626,6 +732,8 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 	const int nCount = std::min(nInCount, 2); //Number of spin-densities used in the parametrization of the functional
 	const int sigmaCount = 2*nCount-1;
 	const GridInfo& gInfo = n[0]->gInfo;
+	int irStart = localOnly ? 0 : gInfo.irStart;
+	int irStop = localOnly ? gInfo.nr : gInfo.irStop;
 	
 	//------- Prepare inputs, allocate outputs -------
 	
@@ -659,7 +767,8 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 	//Calculate spatial gradients for GGA (if needed)
 	std::vector<VectorField> Dn(nInCount);
 	int iDirStart, iDirStop;
-	TaskDivision(3, mpiWorld).myRange(iDirStart, iDirStop);
+	if(localOnly) { iDirStart = 0; iDirStop = 3; }
+	else TaskDivision(3, mpiWorld).myRange(iDirStart, iDirStop);
 	if(needsSigma)
 	{	//Compute the gradients of the (spin-)densities:
 		for(int s=0; s<nInCount; s++)
@@ -736,7 +845,7 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 					sigma[s1+s2] += Dn[s1][i] * Dn[s2][i];
 				watchComm.start();
 				nullToZero(sigma[s1+s2], gInfo);
-				sigma[s1+s2]->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+				if(!localOnly) sigma[s1+s2]->allReduceData(mpiWorld, MPIUtil::ReduceSum);
 				watchComm.stop();
 			}
 		//Allocate gradient if required:
@@ -746,55 +855,20 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 	#ifdef LIBXC_ENABLED
 	//------------------ Evaluate LibXC functionals ---------------
 	if(functionals->libXC.size())
-	{	//Prepare input/output data on the CPU in transposed order (spins contiguous)
-		double *eData = E->data(), *nData=0, *sigmaData=0, *lapData=0, *tauData=0;
-		double *E_nData=0, *E_sigmaData=0, *E_lapData=0, *E_tauData=0;
-		if(nCount == 1)
-		{	nData = nCapped[0]->data();
-			if(needsSigma) sigmaData = sigma[0]->data();
-			if(needsLap) lapData = lap[0]->data();
-			if(needsTau) tauData = tau[0]->data();
-			if(Vxc)
-			{	E_nData = E_n[0]->data();
-				if(needsSigma) E_sigmaData = E_sigma[0]->data();
-				if(needsLap) E_lapData = E_lap[0]->data();
-				if(needsTau) E_tauData = E_tau[0]->data();
-			}
-		}
-		else //Need to interleave input spin-vector fields:
-		{	nData = transpose<2>(nCapped);
-			if(needsSigma) sigmaData = transpose<3>(sigma);
-			if(needsLap) lapData = transpose<2>(lap);
-			if(needsTau) tauData = transpose<2>(tau);
-			if(Vxc)
-			{	E_nData = new double[2*gInfo.nr]; eblas_zero(2*gInfo.nr, E_nData);
-				if(needsSigma) { E_sigmaData = new double[3*gInfo.nr]; eblas_zero(3*gInfo.nr, E_sigmaData); }
-				if(needsLap) { E_lapData = new double[2*gInfo.nr]; eblas_zero(2*gInfo.nr, E_lapData); }
-				if(needsTau) { E_tauData = new double[2*gInfo.nr]; eblas_zero(2*gInfo.nr, E_tauData); }
-			}
-		}
+	{	//Spin components are passed as separate arrays, and interleaved block-wise within each thread:
+		double* eData = E->data();
+		std::vector<const double*> nData = constDataCPU(nCapped), sigmaData = constDataCPU(sigma);
+		std::vector<const double*> lapData = constDataCPU(lap), tauData = constDataCPU(tau);
+		std::vector<double*> E_nData = dataCPU(E_n), E_sigmaData = dataCPU(E_sigma);
+		std::vector<double*> E_lapData = dataCPU(E_lap), E_tauData = dataCPU(E_tau);
 		
 		//Calculate all the required functionals:
 		watchFunc.start();
 		for(auto func: functionals->libXC)
 			if(shouldInclude(func, includeTXC))
-				func->evaluateSub(nCount, gInfo.irStart, gInfo.irStop, nData, sigmaData, lapData, tauData,
+				func->evaluateSub(nCount, irStart, irStop, nData, sigmaData, lapData, tauData,
 					eData, E_nData, E_sigmaData, E_lapData, E_tauData);
 		watchFunc.stop();
-		
-		//Uninterleave spin-vector field results:
-		if(nCount != 1)
-		{	delete[] nData;
-			if(needsSigma) delete[] sigmaData;
-			if(needsLap) delete[] lapData;
-			if(needsTau) delete[] tauData;
-			if(Vxc)
-			{	transpose<2>(E_nData, E_n); delete[] E_nData;
-				if(needsSigma) { transpose<3>(E_sigmaData, E_sigma); delete[] E_sigmaData; }
-				if(needsLap) { transpose<2>(E_lapData, E_lap); delete[] E_lapData; }
-				if(needsTau) { transpose<2>(E_tauData, E_tau); delete[] E_tauData; }
-			}
-		}
 	
 		//Convert per-particle energy to energy density per volume
 		E = E * (nCount==1 ? nCapped[0] : nCapped[0]+nCapped[1]);
@@ -805,7 +879,7 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 	watchFunc.start();
 	for(auto func: functionals->internal)
 		if(shouldInclude(func, includeTXC))
-			func->evaluateSub(gInfo.irStart, gInfo.irStop,
+			func->evaluateSub(irStart, irStop,
 				constDataPref(nCapped), constDataPref(sigma), constDataPref(lap), constDataPref(tau),
 				E->dataPref(), dataPref(E_n), dataPref(E_sigma), dataPref(E_lap), dataPref(E_tau));
 	watchFunc.stop();
@@ -818,13 +892,15 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 	tau.clear();
 	
 	//---------------- Collect results over processes ----------------
-	watchComm.start();
-	mpiWorld->allReduce(Exc, MPIUtil::ReduceSum);
-	for(ScalarField& x: E_n) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
-	for(ScalarField& x: E_sigma) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
-	for(ScalarField& x: E_lap) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
-	for(ScalarField& x: E_tau) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
-	watchComm.stop();
+	if(!localOnly)
+	{	watchComm.start();
+		mpiWorld->allReduce(Exc, MPIUtil::ReduceSum);
+		for(ScalarField& x: E_n) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		for(ScalarField& x: E_sigma) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		for(ScalarField& x: E_lap) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		for(ScalarField& x: E_tau) if(x) x->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+		watchComm.stop();
+	}
 
 	//--------------- Gradient propagation ---------------------
 	if(Vxc)
@@ -886,7 +962,7 @@ double ExCorr::operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc, Incl
 			for(int s=0; s<nInCount; s++)
 			{	watchComm.start();
 				nullToZero(E_nTilde[s], gInfo);
-				E_nTilde[s]->allReduceData(mpiWorld, MPIUtil::ReduceSum);
+				if(!localOnly) E_nTilde[s]->allReduceData(mpiWorld, MPIUtil::ReduceSum);
 				watchComm.stop();
 				E_n[s] += Jdag(E_nTilde[s],true);
 			}
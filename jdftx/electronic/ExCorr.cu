@@ -84,6 +84,45 @@ void GGA_gpu(GGA_Variant variant, int N, std::vector<const double*> n, std::vect
 {	SwitchTemplate_spin(SwitchTemplate_GGA, variant, n.size(), GGA_gpu, (N, n, sigma, E, E_n, E_sigma, scaleFac) )
 }
 
+//-------------------------- Fused LDA / GGA exchange-correlation GPU launch mechanism ----------------------------
+
+template<LDA_Variant cVariant, int nCount> __global__
+void LDA_XC_kernel(int N, array<const double*,nCount> n, double* E, array<double*,nCount> E_n, double scaleFac)
+{	int i = kernelIndex1D();
+	if(i<N) LDA_XC_calc<cVariant,nCount>::compute(i, n, E, E_n, scaleFac);
+}
+template<LDA_Variant cVariant, int nCount>
+void LDA_XC_gpu(int N, array<const double*,nCount> n, double* E, array<double*,nCount> E_n, double scaleFac)
+{	GpuLaunchConfig1D glc(LDA_XC_kernel<cVariant,nCount>, N);
+	LDA_XC_kernel<cVariant,nCount><<<glc.nBlocks,glc.nPerBlock>>>(N, n, E, E_n, scaleFac);
+	gpuErrorCheck();
+}
+void LDA_XC_gpu(LDA_Variant cVariant, int N, std::vector<const double*> n, double* E, std::vector<double*> E_n, double scaleFac)
+{	SwitchTemplate_spin(SwitchTemplate_LDA_XC, cVariant, n.size(), LDA_XC_gpu, (N, n, E, E_n, scaleFac) )
+}
+
+template<GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int nCount> __global__
+void GGA_XC_kernel(int N, array<const double*,nCount> n, array<const double*,2*nCount-1> sigma,
+	double* E, array<double*,nCount> E_n, array<double*,2*nCount-1> E_sigma, double scaleX, double scaleSR, double scaleC)
+{	int i = kernelIndex1D();
+	if(i<N) GGA_XC_calc<xVariant,cVariant,screened,nCount>::compute(i, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC);
+}
+template<GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int nCount>
+void GGA_XC_gpu(int N, array<const double*,nCount> n, array<const double*,2*nCount-1> sigma,
+	double* E, array<double*,nCount> E_n, array<double*,2*nCount-1> E_sigma, double scaleX, double scaleSR, double scaleC)
+{	GpuLaunchConfig1D glc(GGA_XC_kernel<xVariant,cVariant,screened,nCount>, N);
+	GGA_XC_kernel<xVariant,cVariant,screened,nCount><<<glc.nBlocks,glc.nPerBlock>>>(N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC);
+	gpuErrorCheck();
+}
+void GGA_XC_gpu(GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int N, std::vector<const double*> n, std::vector<const double*> sigma,
+	double* E, std::vector<double*> E_n, std::vector<double*> E_sigma, double scaleX, double scaleSR, double scaleC)
+{	switch(n.size())
+	{	case 1: { SwitchTemplate_GGA_XC(xVariant,cVariant,screened,1, GGA_XC_gpu, (N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC)) break; }
+		case 2: { SwitchTemplate_GGA_XC(xVariant,cVariant,screened,2, GGA_XC_gpu, (N, n, sigma, E, E_n, E_sigma, scaleX, scaleSR, scaleC)) break; }
+		default: break;
+	}
+}
+
 //-------------------------- metaGGA GPU launch mechanism ----------------------------
 
 template<mGGA_Variant variant, bool spinScaling, int nCount> __global__
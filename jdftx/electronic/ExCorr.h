@@ -84,9 +84,11 @@ public:
 	//! includeTXC selects which components to include in result (XC without kinetic by default).
 	//! Orbital KE density tau must be provided if needsKEdensity() is true (for meta GGAs)
 	//! and the corresponding gradient will be returned in Vtau if non-null
-	//! For metaGGAs, Vtau should be non-null if Vxc is non-null
+	//! For metaGGAs, Vtau should be non-null if Vxc is non-null.
+	//! If localOnly, evaluate entirely on the current process without MPI division or communication
+	//! (for callers that process different densities on each process).
 	double operator()(const ScalarFieldArray& n, ScalarFieldArray* Vxc=0, IncludeTXC includeTXC=IncludeTXC(),
-		const ScalarFieldArray* tau=0, ScalarFieldArray* Vtau=0) const;
+		const ScalarFieldArray* tau=0, ScalarFieldArray* Vtau=0, bool localOnly=false) const;
 	
 	//! Compute the exchange-correlation energy (and optionally gradient) for a unpolarized density n
 	//! includeTXC selects which components to include in result (XC without kinetic by default).
@@ -654,5 +654,55 @@ template<> __hostanddev__ double GGA_eval<GGA_KE_PW91>(double rs, double s2, dou
 	return eTF * F;
 }
 
+
+//! GGA exchange and correlation (and optionally the short-ranged omega-PBE exchange of HSE-type hybrids)
+//! evaluated together in a single sweep over the grid, for the common semi-local parts of PBE-like functionals
+class FunctionalGGAxc : public Functional
+{
+public:
+	//! Exchange xVariant scaled by scaleX, plus GGA_X_wPBE_SR scaled by scaleSR if non-zero, plus correlation cVariant
+	FunctionalGGAxc(GGA_Variant xVariant, GGA_Variant cVariant, double scaleX=1.0, double scaleSR=0.0);
+	bool needsSigma() const { return true; }
+	bool needsLap() const { return false; }
+	bool needsTau() const { return false; }
+	bool hasExchange() const { return true; }
+	bool hasCorrelation() const { return true; }
+	bool hasKinetic() const { return false; }
+	bool hasEnergy() const { return true; }
+	
+	void evaluate(int N, std::vector<const double*> n, std::vector<const double*> sigma,
+		std::vector<const double*> lap, std::vector<const double*> tau,
+		double* E, std::vector<double*> E_n, std::vector<double*> E_sigma,
+		std::vector<double*> E_lap, std::vector<double*> E_tau) const;
+
+private:
+	GGA_Variant xVariant, cVariant;
+	double scaleX, scaleSR; //!< scale factors of exchange parts (scaleFac applies to correlation)
+};
+
+//! Switch a function fTemplate templated over the exchange and correlation variants,
+//! screening and spin count of FunctionalGGAxc, over all supported combinations
+#define SwitchTemplate_GGA_XC(xVariant,cVariant,screened,nCount, fTemplate,argList) \
+	if(xVariant==GGA_X_PBE && cVariant==GGA_C_PBE) \
+	{	if(screened) fTemplate< GGA_X_PBE, GGA_C_PBE, true, nCount> argList; \
+		else fTemplate< GGA_X_PBE, GGA_C_PBE, false, nCount> argList; \
+	} \
+	else if(xVariant==GGA_X_PBEsol && cVariant==GGA_C_PBEsol && !screened) \
+		fTemplate< GGA_X_PBEsol, GGA_C_PBEsol, false, nCount> argList; \
+	else if(xVariant==GGA_X_PW91 && cVariant==GGA_C_PW91 && !screened) \
+		fTemplate< GGA_X_PW91, GGA_C_PW91, false, nCount> argList;
+
+//! Fused exchange xVariant (+ short-ranged omega-PBE exchange if screened) + correlation cVariant at one grid point
+template<GGA_Variant xVariant, GGA_Variant cVariant, bool screened, int nCount> struct GGA_XC_calc
+{	__hostanddev__ static
+	void compute(int i, array<const double*,nCount> n, array<const double*,2*nCount-1> sigma,
+		double* E, array<double*,nCount> E_n, array<double*,2*nCount-1> E_sigma,
+		double scaleX, double scaleSR, double scaleC)
+	{	GGA_calc<xVariant,true,nCount>::compute(i, n, sigma, E, E_n, E_sigma, scaleX);
+		if(screened) GGA_calc<GGA_X_wPBE_SR,true,nCount>::compute(i, n, sigma, E, E_n, E_sigma, scaleSR);
+		GGA_calc<cVariant,false,nCount>::compute(i, n, sigma, E, E_n, E_sigma, scaleC);
+	}
+};
+
 //! @}
 #endif // JDFTX_ELECTRONIC_EXCORR_INTERNAL_GGA_H
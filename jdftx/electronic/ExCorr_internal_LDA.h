@@ -305,5 +305,48 @@ double LDA_eval<LDA_XC_Teter>(double rs, double zeta, double& e_rs, double& e_ze
 	return -num/den;
 };
 
+
+//! Slater exchange and an LDA correlation evaluated together in a single sweep over the grid
+//! (reads the densities and accumulates the energy and potential once, instead of once per functional)
+class FunctionalLDAxc : public Functional
+{
+public:
+	FunctionalLDAxc(LDA_Variant cVariant, double scaleFac=1.0);
+	bool needsSigma() const { return false; }
+	bool needsLap() const { return false; }
+	bool needsTau() const { return false; }
+	bool hasExchange() const { return true; }
+	bool hasCorrelation() const { return true; }
+	bool hasKinetic() const { return false; }
+	bool hasEnergy() const { return true; }
+	
+	void evaluate(int N, std::vector<const double*> n, std::vector<const double*> sigma,
+		std::vector<const double*> lap, std::vector<const double*> tau,
+		double* E, std::vector<double*> E_n, std::vector<double*> E_sigma,
+		std::vector<double*> E_lap, std::vector<double*> E_tau) const;
+
+private:
+	LDA_Variant cVariant; //!< correlation part (exchange is always Slater)
+};
+
+//! Switch a function fTemplate templated over the correlation variant and spin count of FunctionalLDAxc
+#define SwitchTemplate_LDA_XC(cVariant,nCount, fTemplate,argList) \
+	switch(cVariant) \
+	{	case LDA_C_PZ:      fTemplate< LDA_C_PZ,      nCount> argList; break; \
+		case LDA_C_PW:      fTemplate< LDA_C_PW,      nCount> argList; break; \
+		case LDA_C_PW_prec: fTemplate< LDA_C_PW_prec, nCount> argList; break; \
+		case LDA_C_VWN:     fTemplate< LDA_C_VWN,     nCount> argList; break; \
+		default: break; \
+	}
+
+//! Fused Slater exchange + correlation cVariant at one grid point
+template<LDA_Variant cVariant, int nCount> struct LDA_XC_calc
+{	__hostanddev__ static
+	void compute(int i, array<const double*,nCount> n, double* E, array<double*,nCount> E_n, double scaleFac)
+	{	LDA_calc<LDA_X_Slater,nCount>::compute(i, n, E, E_n, scaleFac);
+		LDA_calc<cVariant,nCount>::compute(i, n, E, E_n, scaleFac);
+	}
+};
+
 //! @}
 #endif // JDFTX_ELECTRONIC_EXCORR_INTERNAL_LDA_H
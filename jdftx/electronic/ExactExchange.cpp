@@ -33,9 +33,22 @@ class ExactExchangeEval
 public:
 	ExactExchangeEval(const Everything& e);
 	
-	//! Calculate for one entry of the k-mesh at a particular spin:
-	double calc(int iSpin, unsigned iReduced, unsigned iInvert, unsigned iSym, 
-		double aXX, double omega, const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C, std::vector<ColumnBundle>* HC) const;
+	//! Wavefunctions and fillings of one entry of the k-mesh at a particular spin, broadcast to all processes
+	struct PartnerState
+	{	int iTask; //!< combined index of spin and k-mesh entry (see startFetch)
+		QuantumNumber qnum_k;
+		ColumnBundle Ck;
+		diagMatrix Fk;
+		MPIUtil::Request request[2]; //!< pending broadcasts of Ck and Fk
+	};
+	int nTasks() const { return nSpins * kmap.size(); } //!< number of partner states (spin and k-mesh entries)
+	
+	//! Prepare partner state iTask on its source process and start its (non-blocking) broadcast into ps
+	void startFetch(int iTask, PartnerState& ps, const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C) const;
+	
+	//! Calculate for one entry of the k-mesh at a particular spin, given its partner state whose broadcast has completed:
+	double calc(const PartnerState& ps, double aXX, double omega,
+		const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C, std::vector<ColumnBundle>* HC) const;
 	
 private:
 	friend class ExactExchange;
@@ -80,13 +93,26 @@ double ExactExchange::operator()(double aXX, double omega,
 				(*HC)[q].zero();
 			}
 	
-	//Calculate:
+	//Calculate, with broadcasts of upcoming partner states overlapping computation of the current one:
+	int nTasks = eval->nTasks();
+	int depth = std::max(0, e.cntrl.exchangePrefetchDepth);
+	std::vector<ExactExchangeEval::PartnerState> partners(depth+1); //ring buffer (not resized below, since Ck points to qnum_k)
+	for(int iTask=0; iTask<std::min(depth,nTasks); iTask++)
+		eval->startFetch(iTask, partners[iTask % partners.size()], F, C);
 	double EXX = 0.0;
-	for(int iSpin=0; iSpin<eval->nSpins; iSpin++)
-		for(int iReduced=0; iReduced<eval->qCount; iReduced++)
-		for(unsigned iInvert=0; iInvert<eval->invertList.size(); iInvert++)
-		for(unsigned iSym=0; iSym<eval->sym.size(); iSym++)
-			EXX += eval->calc(iSpin, iReduced, iInvert, iSym, aXX, omega, F, C, HC);
+	for(int iTask=0; iTask<nTasks; iTask++)
+	{	if(iTask+depth < nTasks) //prefetch (or fetch current state, if depth = 0)
+			eval->startFetch(iTask+depth, partners[(iTask+depth) % partners.size()], F, C);
+		ExactExchangeEval::PartnerState& ps = partners[iTask % partners.size()];
+		if(mpiWorld->nProcesses() > 1) //requests only initialized when broadcast is actually needed
+		{	static StopWatch watchWait("ExactExchange::wait"); watchWait.start();
+			mpiWorld->wait(ps.request[0]);
+			mpiWorld->wait(ps.request[1]);
+			watchWait.stop();
+		}
+		EXX += eval->calc(ps, aXX, omega, F, C, HC);
+		ps.Ck.free(); //release buffer before next prefetch
+	}
 	watch.stop();
 	return EXX;
 }
@@ -131,23 +157,40 @@ ExactExchangeEval::ExactExchangeEval(const Everything& e)
 	logResume();
 }
 
-double ExactExchangeEval::calc(int iSpin, unsigned iReduced, unsigned iInvert, unsigned iSym,
-	double aXX, double omega, const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C, std::vector<ColumnBundle>* HC) const
-{
-	//Prepare ik state and gradient on all processes:
-	const KmapEntry& ki = kmap[kmapIndex(iReduced, iInvert, iSym)];
+void ExactExchangeEval::startFetch(int iTask, PartnerState& ps, const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C) const
+{	//Decompose task index (ordered as spin, reduced k, inversion, symmetry from slowest to fastest):
+	int iSpin = iTask / kmap.size();
+	int iKmap = iTask % kmap.size();
+	int iReduced = iKmap / (invertList.size()*sym.size());
+	const KmapEntry& ki = kmap[iKmap];
 	int ikSrc = iReduced + iSpin*qCount; //source state number
-	const Basis& basis_k = ki.basis;
-	QuantumNumber qnum_k = e.eInfo.qnums[ikSrc]; qnum_k.k =  ki.k;
-	ColumnBundle Ck(e.eInfo.nBands, basis_k.nbasis*nSpinor, &basis_k, &qnum_k, isGpuEnabled()), HCk;
-	diagMatrix Fk(e.eInfo.nBands);
+	//Prepare ik state on source process:
+	ps.iTask = iTask;
+	ps.qnum_k = e.eInfo.qnums[ikSrc]; ps.qnum_k.k = ki.k;
+	ps.Ck.init(e.eInfo.nBands, ki.basis.nbasis*nSpinor, &ki.basis, &ps.qnum_k, isGpuEnabled());
+	ps.Fk.resize(e.eInfo.nBands);
 	if(e.eInfo.isMine(ikSrc))
-	{	Ck.zero();
-		ki.transform->scatterAxpy(1., C[ikSrc], Ck,0,1);
-		Fk = F[ikSrc];
+	{	ps.Ck.zero();
+		ki.transform->scatterAxpy(1., C[ikSrc], ps.Ck,0,1);
+		ps.Fk = F[ikSrc];
 	}
-	mpiWorld->bcastData(Ck, e.eInfo.whose(ikSrc));
-	mpiWorld->bcastData(Fk, e.eInfo.whose(ikSrc));
+	//Start broadcast to all processes:
+	mpiWorld->bcastData(ps.Ck, e.eInfo.whose(ikSrc), &ps.request[0]);
+	mpiWorld->bcastData(ps.Fk, e.eInfo.whose(ikSrc), &ps.request[1]);
+}
+
+double ExactExchangeEval::calc(const PartnerState& ps, double aXX, double omega,
+	const std::vector<diagMatrix>& F, const std::vector<ColumnBundle>& C, std::vector<ColumnBundle>* HC) const
+{
+	//Prepare gradient of ik state on all processes:
+	int iSpin = ps.iTask / kmap.size();
+	int iKmap = ps.iTask % kmap.size();
+	const KmapEntry& ki = kmap[iKmap];
+	int ikSrc = iKmap / (invertList.size()*sym.size()) + iSpin*qCount; //source state number
+	const QuantumNumber& qnum_k = ps.qnum_k;
+	const ColumnBundle& Ck = ps.Ck;
+	const diagMatrix& Fk = ps.Fk;
+	ColumnBundle HCk;
 	if(HC) { HCk = Ck.similar(); HCk.zero(); }
 	
 	//Calculate energy (and gradient):
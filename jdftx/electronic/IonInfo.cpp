@@ -29,6 +29,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/Units.h>
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 
 #define MIN_ION_DISTANCE 1e-10
 
@@ -40,6 +41,7 @@ IonInfo::IonInfo()
 
 void IonInfo::setup(const Everything &everything)
 {	e = &everything;
+	projectorCache.setBudget(size_t(e->cntrl.projectorCacheMemory * 1024*1024));
 
 	//Force output in same coordinate system as input forces
 	if(forcesOutputCoords==ForcesCoordsPositions)
@@ -230,10 +232,14 @@ double IonInfo::ionicEnergyAndGrad(IonicGradient& forces) const
 		std::vector<matrix> HVdagCq(species.size()); 
 		EnlAndGrad(qnum, eVars.F[q], eVars.VdagC[q], HVdagCq);
 		augmentDensitySphericalGrad(qnum, eVars.VdagC[q], HVdagCq);
+		//Gradients of projections (only computed here in real-space projector mode, to stay consistent with the energy):
+		std::vector<std::vector<matrix>> DVdagCq;
+		projectGradPos(eVars.C[q], HVdagCq, DVdagCq);
 		//Propagate to atomic positions:
 		for(unsigned sp=0; sp<species.size(); sp++) if(HVdagCq[sp])
 		{	matrix grad_CdagOCq = -(eVars.Hsub_eigs[q] * eVars.F[q]); //gradient of energy w.r.t overlap matrix
-			species[sp]->accumNonlocalForces(eVars.C[q], eVars.VdagC[q][sp], HVdagCq[sp]*eVars.F[q], grad_CdagOCq, forcesNL[sp]);
+			species[sp]->accumNonlocalForces(eVars.C[q], eVars.VdagC[q][sp], HVdagCq[sp]*eVars.F[q], grad_CdagOCq, forcesNL[sp],
+				DVdagCq[sp].size() ? DVdagCq[sp].data() : 0);
 		}
 	}
 	for(auto& force: forcesNL) //Accumulate contributions over processes
@@ -278,22 +284,91 @@ void IonInfo::augmentDensitySphericalGrad(const QuantumNumber& qnum, const std::
 		species[sp]->augmentDensitySphericalGrad(qnum, VdagCq[sp], HVdagCq[sp]);
 }
 
+//Real-space projection of columns [colStart,colEnd) of Cq for all species with pending projections
+void projectRealSpace_sub(int colStart, int colEnd, const IonInfo* iInfo, const ColumnBundle* Cq, std::vector<matrix>* VdagCq, const std::vector<bool>* pending)
+{	for(int b=colStart; b<colEnd; b++)
+	{	complexScalarField Ipsi = I(Cq->getColumn(b,0));
+		for(unsigned sp=0; sp<iInfo->species.size(); sp++)
+			if(pending->at(sp))
+				iInfo->species[sp]->projectRealSpace(Ipsi, b, VdagCq->at(sp));
+	}
+}
+
+//Real-space accumulation of projector gradients onto columns [colStart,colEnd) of HCq
+void projectGradRealSpace_sub(int colStart, int colEnd, const IonInfo* iInfo, const std::vector<matrix>* HVdagCq, ColumnBundle* HCq)
+{	for(int b=colStart; b<colEnd; b++)
+	{	complexScalarField X;
+		nullToZero(X, *(HCq->basis->gInfo));
+		for(unsigned sp=0; sp<iInfo->species.size(); sp++)
+			if(HVdagCq->at(sp))
+				iInfo->species[sp]->projectGradRealSpace(HVdagCq->at(sp), b, X);
+		HCq->accumColumn(b,0, J(X));
+	}
+}
+
+//Real-space projection of columns [colStart,colEnd) of Cq on projector gradients for all species with non-empty DVdagCq
+void projectGradPosRealSpace_sub(int colStart, int colEnd, const IonInfo* iInfo, const ColumnBundle* Cq, std::vector<std::vector<matrix>>* DVdagCq)
+{	for(int b=colStart; b<colEnd; b++)
+	{	complexScalarField Ipsi = I(Cq->getColumn(b,0));
+		for(unsigned sp=0; sp<iInfo->species.size(); sp++)
+			if(DVdagCq->at(sp).size())
+				iInfo->species[sp]->projectGradPosRealSpace(Ipsi, b, DVdagCq->at(sp).data());
+	}
+}
+
 void IonInfo::project(const ColumnBundle& Cq, std::vector<matrix>& VdagCq, matrix* rotExisting) const
 {	VdagCq.resize(species.size());
+	bool realSpace = e->cntrl.realSpaceProjectors && (!Cq.isSpinor()) && (!isGpuEnabled());
+	std::vector<bool> pending(species.size(), false); //species needing real-space projections
 	for(unsigned sp=0; sp<e->iInfo.species.size(); sp++)
 	{	if(rotExisting && VdagCq[sp]) VdagCq[sp] = VdagCq[sp] * (*rotExisting); //rotate and keep the existing projections
+		else if(realSpace)
+		{	int nProj = species[sp]->nProjectors();
+			if(!nProj) continue;
+			species[sp]->initRealSpaceProjectors(*(Cq.basis->gInfo), Cq.qnum->k);
+			VdagCq[sp] = zeroes(nProj, Cq.nCols());
+			pending[sp] = true;
+		}
 		else
 		{	auto V = e->iInfo.species[sp]->getV(Cq);
 			if(V) VdagCq[sp] = (*V) ^ Cq;
 		}
 	}
+	if(std::count(pending.begin(), pending.end(), true))
+		threadLaunch(isGpuEnabled()?1:0, projectRealSpace_sub, Cq.nCols(), this, &Cq, &VdagCq, &pending);
 }
 
 void IonInfo::projectGrad(const std::vector<matrix>& HVdagCq, const ColumnBundle& Cq, ColumnBundle& HCq) const
-{	for(unsigned sp=0; sp<species.size(); sp++)
+{	if(e->cntrl.realSpaceProjectors && (!Cq.isSpinor()) && (!isGpuEnabled()))
+	{	bool needed = false;
+		for(unsigned sp=0; sp<species.size(); sp++)
+			if(HVdagCq[sp])
+			{	species[sp]->initRealSpaceProjectors(*(Cq.basis->gInfo), Cq.qnum->k);
+				needed = true;
+			}
+		if(needed) threadLaunch(isGpuEnabled()?1:0, projectGradRealSpace_sub, HCq.nCols(), this, &HVdagCq, &HCq);
+		return;
+	}
+	for(unsigned sp=0; sp<species.size(); sp++)
 		if(HVdagCq[sp]) HCq += *(species[sp]->getV(Cq)) * HVdagCq[sp];
 }
 
+void IonInfo::projectGradPos(const ColumnBundle& Cq, const std::vector<matrix>& HVdagCq, std::vector<std::vector<matrix>>& DVdagCq) const
+{	DVdagCq.assign(species.size(), std::vector<matrix>());
+	if(!(e->cntrl.realSpaceProjectors && (!Cq.isSpinor()) && (!isGpuEnabled()))) return;
+	bool needed = false;
+	for(unsigned sp=0; sp<species.size(); sp++)
+		if(HVdagCq[sp])
+		{	species[sp]->initRealSpaceProjectors(*(Cq.basis->gInfo), Cq.qnum->k);
+			species[sp]->initRealSpaceProjectorGrad();
+			DVdagCq[sp].assign(3, zeroes(species[sp]->nProjectors(), Cq.nCols()));
+			needed = true;
+		}
+	if(needed) threadLaunch(projectGradPosRealSpace_sub, Cq.nCols(), this, &Cq, &DVdagCq);
+	for(unsigned sp=0; sp<species.size(); sp++)
+		if(HVdagCq[sp]) species[sp]->freeRealSpaceProjectorGrad();
+}
+
 //----- DFT+U functions --------
 
 size_t IonInfo::rhoAtom_nMatrices() const
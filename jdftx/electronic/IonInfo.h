@@ -23,6 +23,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <electronic/SpeciesInfo.h>
 #include <electronic/IonicMinimizer.h>
+#include <electronic/ProjectorCache.h>
 #include <core/matrix.h>
 #include <core/ScalarField.h>
 #include <core/Thread.h>
@@ -49,6 +50,7 @@ enum coreOverlapCheck { additive, vector, none };
 class IonInfo
 {
 public:
+	mutable ProjectorCache projectorCache; //!< cache of nonlocal projectors for all species (declared before species, which use it till destruction)
 	std::vector< std::shared_ptr<SpeciesInfo> > species; //!< list of ionic species
 	std::vector<string> pspFilenamePatterns; //!< list of wildcards for pseudopotential sets
 	
@@ -96,6 +98,7 @@ public:
 	
 	void project(const ColumnBundle& Cq, std::vector<matrix>& VdagCq, matrix* rotExisting=0) const; //Update pseudopotential projections (optionally retain non-zero ones with specified rotation)
 	void projectGrad(const std::vector<matrix>& HVdagCq, const ColumnBundle& Cq, ColumnBundle& HCq) const; //Propagate projected gradient (HVdagCq) to full gradient (HCq)
+	void projectGradPos(const ColumnBundle& Cq, const std::vector<matrix>& HVdagCq, std::vector<std::vector<matrix>>& DVdagCq) const; //Cartesian gradients of projections for species with non-null HVdagCq using real-space projectors (empty if not in real-space mode)
 	
 	//! Compute U corrections (DFT+U in the simplified rotationally-invariant scheme [Dudarev et al, Phys. Rev. B 57, 1505])
 	//rhoAtom is a flat array of atomic density matrices per U type, with index order (outer to inner): species, Uparam(n,l), spin, atom
@@ -25,7 +25,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/VectorField.h>
 #include <core/ScalarFieldIO.h>
 
-Polarizability::Polarizability() : eigenBasis(NonInteracting), Ecut(0), nEigs(0)
+Polarizability::Polarizability() : eigenBasis(NonInteracting), Ecut(0), nEigs(0), maxMemory(0)
 {
 }
 
@@ -33,6 +33,7 @@ Polarizability::Polarizability() : eigenBasis(NonInteracting), Ecut(0), nEigs(0)
 class PairDensityCalculator
 {
 	int nK;
+	int nFieldsMax; //!< maximum number of real-space orbitals cached at a time (0 => unlimited)
 	
 	struct State
 	{	const ColumnBundle* C;
@@ -129,43 +130,86 @@ public:
 			assert(foundk2); //such a partner should always be found for a uniform kmesh
 			state2.setup(e, k2, kTransform2);
 		}
+		
+		//Determine number of real-space orbitals that fit in memory budget:
+		size_t fieldBytes = state1.C->basis->gInfo->nr * sizeof(complex);
+		nFieldsMax = e.dump.polarizability->maxMemory
+			? std::max(2, int(e.dump.polarizability->maxMemory * 1024*1024 / fieldBytes))
+			: 0;
 	}
 
 	//Store resulting pair densities scaled by 2*invsqrt(eigenvalue differences) in rho,
 	//so that the non-interacting susceptibility is negative identity in this basis.
 	void compute(int nV, int nC, ColumnBundle& rho, int kOffset) const
-	{	threadLaunch(isGpuEnabled() ? 1 : 0, compute_thread, nV*nC, nV, nC, &rho, kOffset, this);
+	{	compute(0, nV, nV, nC, rho, kOffset);
 	}
 	
 	//Accumulate contribution from currentkpoint pair to negative of noninteracting susceptibility in plane-wave basis:
 	void accumMinusXniPW(int nV, int nC, const Basis& basis, matrix& minusXni)
 	{	assert(minusXni.nRows() == int(basis.nbasis));
 		assert(minusXni.nCols() == int(basis.nbasis));
-		ColumnBundle rho(nV*nC, basis.nbasis, &basis);
-		compute(nV, nC, rho, 0);
-		//Xni += (detR)*rho*dagger(rho):
-		callPref(eblas_zgemm)(CblasNoTrans, CblasConjTrans, basis.nbasis, basis.nbasis, rho.nCols(),
-			basis.gInfo->detR, rho.dataPref(), rho.colLength(), rho.dataPref(), rho.colLength(),
-			1., minusXni.dataPref(), minusXni.nRows());
+		//Process valence bands in blocks (limiting memory for real-space orbitals and pair densities):
+		int nVblock = blockSizeV(nV, nC);
+		for(int vStart=0; vStart<nV; vStart+=nVblock)
+		{	int vStop = std::min(nV, vStart+nVblock);
+			ColumnBundle rho((vStop-vStart)*nC, basis.nbasis, &basis);
+			compute(vStart, vStop, nV, nC, rho, 0);
+			//Xni += (detR)*rho*dagger(rho):
+			callPref(eblas_zgemm)(CblasNoTrans, CblasConjTrans, basis.nbasis, basis.nbasis, rho.nCols(),
+				basis.gInfo->detR, rho.dataPref(), rho.colLength(), rho.dataPref(), rho.colLength(),
+				1., minusXni.dataPref(), minusXni.nRows());
+		}
 	}
 	
 private:
-	void compute_sub(int bStart, int bStop, int nV, int nC, ColumnBundle* rho, int kOffset) const
-	{	int b = bStart;
-		int v = b / nC;
-		int c = b - v*nC;
-		complexScalarField conjICv = conj(I(state1.getColumn(v)));
-		while(b<bStop)
-		{	double sqrtEigDen = sqrt(4./(nK * (state2.eig->at(nV+c) - state1.eig->at(v))));
-			rho->setColumn(kOffset+b,0, sqrtEigDen * J(conjICv * I(state2.getColumn(nV+c))));
-			//Next cv pair:
-			b++; if(b==bStop) break;
-			c++;
-			if(c==nC) { c=0; v++; conjICv = conj(I(state1.getColumn(v))); }
+	//Number of valence orbitals to hold in real space at a time:
+	int blockSizeV(int nV, int nC) const
+	{	return nFieldsMax ? std::max(1, std::min(nV, nFieldsMax/2)) : nV;
+	}
+	
+	//Pair densities for valence bands [vStart,vStop) with all conduction bands, stored starting at column colOffset
+	//of rho (with conduction index fastest). Each orbital is transformed to real space once per block of valence
+	//bands, and the pair densities of each block of real-space orbitals are formed concurrently.
+	void compute(int vStart, int vStop, int nV, int nC, ColumnBundle& rho, int colOffset) const
+	{	static StopWatch watch("PairDensityCalculator"); watch.start();
+		int nThreads = isGpuEnabled() ? 1 : 0;
+		int nVblock = blockSizeV(vStop-vStart, nC);
+		int nCblock = nFieldsMax ? std::max(1, nFieldsMax-nVblock) : nC;
+		for(int vBlockStart=vStart; vBlockStart<vStop; vBlockStart+=nVblock)
+		{	int vBlockStop = std::min(vStop, vBlockStart+nVblock);
+			std::vector<complexScalarField> conjIv(vBlockStop-vBlockStart);
+			threadLaunch(nThreads, transform_thread, conjIv.size(), &state1, vBlockStart, true, conjIv.data());
+			for(int cStart=0; cStart<nC; cStart+=nCblock)
+			{	int cStop = std::min(nC, cStart+nCblock);
+				std::vector<complexScalarField> Ic(cStop-cStart);
+				threadLaunch(nThreads, transform_thread, Ic.size(), &state2, nV+cStart, false, Ic.data());
+				threadLaunch(nThreads, pair_thread, conjIv.size()*Ic.size(), this, nV, nC,
+					vBlockStart, int(conjIv.size()), (const complexScalarField*)conjIv.data(),
+					cStart, int(Ic.size()), (const complexScalarField*)Ic.data(),
+					&rho, colOffset + (vBlockStart-vStart)*nC);
+			}
 		}
+		watch.stop();
 	}
-	static void compute_thread(int bStart, int bStop, int nV, int nC, ColumnBundle* rho, int kOffset, const PairDensityCalculator* pdc)
-	{	pdc->compute_sub(bStart, bStop, nV, nC, rho, kOffset);
+	
+	//Transform columns [bStart,bStop) offset by bOffset of state to real space (and optionally complex conjugate):
+	static void transform_thread(int bStart, int bStop, const State* state, int bOffset, bool conjugate, complexScalarField* out)
+	{	for(int b=bStart; b<bStop; b++)
+		{	out[b] = I(state->getColumn(bOffset+b));
+			if(conjugate) out[b] = conj(out[b]);
+		}
+	}
+	
+	//Pair densities from cached real-space orbitals, for pair indices [iStart,iStop) within a block (conduction index fastest):
+	static void pair_thread(int iStart, int iStop, const PairDensityCalculator* pdc, int nV, int nC,
+		int vOffset, int nVcur, const complexScalarField* conjIv, int cOffset, int nCcur, const complexScalarField* Ic,
+		ColumnBundle* rho, int colOffset)
+	{	for(int i=iStart; i<iStop; i++)
+		{	int vCur = i / nCcur, cCur = i % nCcur;
+			int v = vOffset + vCur, c = cOffset + cCur;
+			double sqrtEigDen = sqrt(4./(pdc->nK * (pdc->state2.eig->at(nV+c) - pdc->state1.eig->at(v))));
+			rho->setColumn(colOffset + vCur*nC + c, 0, sqrtEigDen * J(conjIv[vCur] * Ic[cCur]));
+		}
 	}
 };
 
@@ -39,6 +39,7 @@ struct Polarizability
 	
 	double Ecut; //!< energy-cutoff for occupied-valence pair densities (if zero, 4*Ecut of wavefunctions)
 	int nEigs; //!< number of eigenvectors in output (if zero, output all)
+	double maxMemory; //!< memory budget (in MB) for real-space orbitals cached while forming pair densities (if zero, cache all)
 	
 	vector3<> dk; //!< k-point difference at which to obtain results
 	
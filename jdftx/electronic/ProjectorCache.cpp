@@ -0,0 +1,109 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <electronic/ProjectorCache.h>
+#include <electronic/ColumnBundle.h>
+
+ProjectorCache::ProjectorCache() : inflation(0.), evictionReported(false)
+{	ManagedMemoryBase::registerCache("ProjectorCache", &stats);
+}
+
+ProjectorCache::~ProjectorCache()
+{	ManagedMemoryBase::unregisterCache(&stats);
+}
+
+void ProjectorCache::setBudget(size_t nBytesBudget)
+{	lock.lock();
+	stats.nBytesBudget = nBytesBudget;
+	evict();
+	lock.unlock();
+}
+
+std::shared_ptr<ColumnBundle> ProjectorCache::find(const SpeciesInfo* sp, const vector3<>& k, const Basis* basis)
+{	std::shared_ptr<ColumnBundle> V;
+	lock.lock();
+	auto iter = entries.find(std::make_tuple(sp, k, basis));
+	if(iter != entries.end())
+	{	Entry& entry = iter->second;
+		entry.priority = inflation + entry.costDensity; //refresh priority on use
+		V = entry.V;
+		stats.nHits++;
+	}
+	else stats.nMisses++;
+	lock.unlock();
+	return V;
+}
+
+void ProjectorCache::add(const SpeciesInfo* sp, const vector3<>& k, const Basis* basis, std::shared_ptr<ColumnBundle> V, double cost)
+{	if(!V) return;
+	Entry entry;
+	entry.V = V;
+	entry.nBytes = V->nData() * sizeof(complex);
+	entry.costDensity = cost / std::max(entry.nBytes, size_t(1));
+	lock.lock();
+	auto iter = entries.find(std::make_tuple(sp, k, basis));
+	if(iter != entries.end()) remove(iter); //replace existing entry
+	entry.priority = inflation + entry.costDensity;
+	entries[std::make_tuple(sp, k, basis)] = entry;
+	stats.nBytes += entry.nBytes;
+	evict();
+	stats.nBytesPeak = std::max(stats.nBytesPeak, stats.nBytes);
+	lock.unlock();
+}
+
+void ProjectorCache::clear(const SpeciesInfo* sp)
+{	lock.lock();
+	for(auto iter=entries.begin(); iter!=entries.end();)
+	{	auto iterNext = std::next(iter);
+		if(std::get<0>(iter->first) == sp) remove(iter);
+		iter = iterNext;
+	}
+	lock.unlock();
+}
+
+void ProjectorCache::clear()
+{	lock.lock();
+	entries.clear();
+	stats.nBytes = 0;
+	lock.unlock();
+}
+
+void ProjectorCache::evict()
+{	if(!stats.nBytesBudget) return; //unlimited
+	while(stats.nBytes > stats.nBytesBudget && entries.size() > 1) //always retain at least one entry
+	{	//Find entry with lowest priority:
+		auto iterMin = entries.begin();
+		for(auto iter=entries.begin(); iter!=entries.end(); iter++)
+			if(iter->second.priority < iterMin->second.priority)
+				iterMin = iter;
+		inflation = iterMin->second.priority;
+		remove(iterMin);
+		stats.nEvictions++;
+		if(!evictionReported)
+		{	logPrintf("NOTE: projector cache reached its memory budget of %.1lf MB; evicting projectors (regenerated when needed).\n",
+				stats.nBytesBudget/(1024.*1024.));
+			evictionReported = true;
+		}
+	}
+}
+
+void ProjectorCache::remove(std::map<Key,Entry>::iterator iter)
+{	stats.nBytes -= iter->second.nBytes;
+	entries.erase(iter);
+}
@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#ifndef JDFTX_ELECTRONIC_PROJECTORCACHE_H
+#define JDFTX_ELECTRONIC_PROJECTORCACHE_H
+
+#include <core/ManagedMemory.h>
+#include <core/vector3.h>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <tuple>
+
+class ColumnBundle;
+class Basis;
+class SpeciesInfo;
+
+//! @addtogroup IonicSystem
+//! @{
+//! @file ProjectorCache.h Memory-budgeted cache of nonlocal projectors
+
+//! Cache of nonlocal projectors of all species, identified by species, k-point and basis.
+//! When a memory budget is set, entries are evicted using a cost-aware LRU policy (GreedyDual-Size),
+//! which preferentially retains recently used entries that are expensive to regenerate per unit memory.
+//! Evicted projectors are simply regenerated by SpeciesInfo::getV when needed again.
+class ProjectorCache
+{
+public:
+	ProjectorCache();
+	~ProjectorCache();
+	
+	void setBudget(size_t nBytesBudget); //!< set memory budget in bytes (0 => unlimited)
+	
+	//! Retrieve cached projectors (null if not in cache)
+	std::shared_ptr<ColumnBundle> find(const SpeciesInfo* sp, const vector3<>& k, const Basis* basis);
+	
+	//! Add projectors V to the cache, which took time cost (in any consistent unit) to compute
+	void add(const SpeciesInfo* sp, const vector3<>& k, const Basis* basis, std::shared_ptr<ColumnBundle> V, double cost);
+	
+	void clear(const SpeciesInfo* sp); //!< remove all projectors of a species (eg. when its atoms move)
+	void clear(); //!< remove all projectors
+	
+private:
+	typedef std::tuple<const SpeciesInfo*, vector3<>, const Basis*> Key;
+	struct Entry
+	{	std::shared_ptr<ColumnBundle> V;
+		size_t nBytes; //memory used by V
+		double costDensity; //cost per unit memory
+		double priority; //GreedyDual-Size priority: entry with lowest priority is evicted first
+	};
+	std::map<Key,Entry> entries;
+	double inflation; //priority of last evicted entry, added to priorities of new / used entries (implements aging)
+	ManagedMemoryBase::CacheStats stats;
+	bool evictionReported; //whether the start of evictions has been logged
+	std::mutex lock;
+	
+	void evict(); //evict entries till within budget (lock must be held by caller)
+	void remove(std::map<Key,Entry>::iterator iter); //remove one entry (lock must be held by caller)
+};
+
+//! @}
+#endif // JDFTX_ELECTRONIC_PROJECTORCACHE_H
@@ -36,7 +36,8 @@ void SpeciesInfo::sync_atpos()
 	//Update managed version of atpos:
 	atposManaged = ManagedArray<vector3<>>(atpos); //it will get transferred to GPU if/when necessary
 	//Invalidate cached projectors:
-	cachedV.clear();
+	if(e) e->iInfo.projectorCache.clear(this);
+	realSpaceV.clear();
 }
 
 inline bool isParallel(vector3<> x, vector3<> y)
@@ -93,6 +94,7 @@ vector3<> SpeciesInfo::Constraint::operator()(const vector3<>& grad) const
 
 SpeciesInfo::SpeciesInfo()
 {
+	e = 0;
 	Z = 0.0;
 	atomicNumber = 0;
 	Z_chargeball = 0.0; width_chargeball = 0.0;
@@ -101,6 +103,7 @@ SpeciesInfo::SpeciesInfo()
 	mass = 0.0;
 	coreRadius = 0.;
 	initialOxidationState = 0.;
+	realSpaceVgrid = 0;
 	
 	pulayfilename ="none";
 
@@ -109,7 +112,8 @@ SpeciesInfo::SpeciesInfo()
 }
 
 SpeciesInfo::~SpeciesInfo()
-{	if(atpos.size())
+{	if(e) e->iInfo.projectorCache.clear(this);
+	if(atpos.size())
 	{
 		VlocRadial.free();
 		nCoreRadial.free();
@@ -394,7 +398,8 @@ void SpeciesInfo::updateLatticeDependent()
 		nCoreRadial.updateGmax(0, nGridLoc);
 		tauCoreRadial.updateGmax(0, nGridLoc);
 		for(auto& Qijl: Qradial) Qijl.second.updateGmax(Qijl.first.l, nGridLoc);
-		cachedV.clear(); //clear any cached projectors
+		e->iInfo.projectorCache.clear(this); //clear any cached projectors
+		realSpaceV.clear();
 	}
 	
 	//Update Qradial indices, matrix and nagIndex if not previously init'd, or if R has changed:
@@ -94,6 +94,20 @@ public:
 	std::shared_ptr<ColumnBundle> getV(const ColumnBundle& Cq, const vector3<>* derivDir=0) const;
 	int nProjectors() const { return MnlAll.nRows() * atpos.size(); } //!< total number of projectors for all atoms in this species (number of columns in result of getV)
 	
+	//! Initialize real-space projectors for the wavefunction grid gInfoWfns (if not already done) and their Bloch phases for k.
+	//! Must be called (outside threaded sections) before projectRealSpace() and projectGradRealSpace().
+	void initRealSpaceProjectors(const GridInfo& gInfoWfns, const vector3<>& k) const;
+	//! Set column b of VdagCq to the projections of Ipsi (= I() of column b of Cq) using real-space projectors (non-spinor only)
+	void projectRealSpace(const complexScalarField& Ipsi, int b, matrix& VdagCq) const;
+	//! Accumulate projectors times column b of HVdagCq onto real-space X (transformed to the gradient w.r.t column b of Cq by the caller)
+	void projectGradRealSpace(const matrix& HVdagCq, int b, complexScalarField& X) const;
+	//! Compute / release the Cartesian gradients of the real-space projectors needed by projectGradPosRealSpace()
+	//! (call outside threaded sections after initRealSpaceProjectors; only kept for the duration of a force calculation)
+	void initRealSpaceProjectorGrad() const;
+	void freeRealSpaceProjectorGrad() const;
+	//! Set column b of DVdagCq[k] (k=0,1,2) to projections of Ipsi on the Cartesian gradients of the real-space projectors
+	void projectGradPosRealSpace(const complexScalarField& Ipsi, int b, matrix* DVdagCq) const;
+	
 	//! Return non-local energy for this species and quantum number q and optionally accumulate
 	//! projected electronic gradient in HVdagCq (if non-null)
 	double EnlAndGrad(const QuantumNumber& qnum, const diagMatrix& Fq, const matrix& VdagCq, matrix& HVdagCq) const;
@@ -144,7 +158,8 @@ public:
 		const ScalarFieldTilde& ccgrad_nChargeball, const ScalarFieldTilde& ccgrad_nCore, const ScalarFieldTilde& ccgrad_tauCore) const;
 
 	//! Propagate gradient with respect to atomic projections (in E_VdagC, along with additional overlap contributions from grad_CdagOC) to forces:
-	void accumNonlocalForces(const ColumnBundle& Cq, const matrix& VdagC, const matrix& E_VdagC, const matrix& grad_CdagOCq, std::vector<vector3<> >& forces) const;
+	//! If DVdagC is non-null, it must contain the three Cartesian gradients of VdagC (e.g. from projectGradPosRealSpace), else they are computed in reciprocal space.
+	void accumNonlocalForces(const ColumnBundle& Cq, const matrix& VdagC, const matrix& E_VdagC, const matrix& grad_CdagOCq, std::vector<vector3<> >& forces, const matrix* DVdagC=0) const;
 	
 	//! Spin-angle helper functions:
 	static matrix getYlmToSpinAngleMatrix(int l, int j2); //!< Get the ((2l+1)*2)x(j2+1) matrix that transforms the Ylm+spin to the spin-angle functions, where j2=2*j with j = l+/-0.5
@@ -163,7 +178,20 @@ private:
 	std::vector<matrix> Qint; //!< overlap augmentation matrix (indexed by l, empty if no augmentation)
 	matrix QintAll; //!< block matrix containing Qint for all l,m 
 	
-	std::map<std::pair<vector3<>,const Basis*>, std::shared_ptr<ColumnBundle> > cachedV; //cached projectors (identified by k-point and basis pointer)
+	//! Nonlocal projectors of one atom on the grid points within its projector sphere (real-space projector mode)
+	struct RealSpaceProjector
+	{	std::vector<int> index; //!< grid indices of points within the sphere (wrapped into the unit cell)
+		std::vector<vector3<>> x; //!< unwrapped lattice coordinates of those points (for Bloch phases)
+		matrix B; //!< projectors excluding Bloch phase (nPoints x projectors per atom)
+		matrix DB[3]; //!< Cartesian gradients of B (only initialized during force calculations)
+		std::vector<complex> phase; //!< Bloch phases exp(i k.x) at the current k-point
+	};
+	std::vector<RealSpaceProjector> realSpaceV; //!< real-space projectors for each atom (empty if uninitialized)
+	const GridInfo* realSpaceVgrid; //!< grid for which realSpaceV was initialized
+	vector3<> realSpaceVk; //!< k-point for which the Bloch phases in realSpaceV were initialized
+	std::vector<std::vector<std::vector<double>>> realSpaceF; //!< filtered radial projectors (including normalization) on a uniform grid, indexed by l and p
+	double realSpaceDx; //!< radial grid spacing of realSpaceF
+	void realSpaceProjectorValues(const vector3<>& r, complex* B, int stride) const; //!< evaluate all projectors of one atom at displacement r into B (with specified stride)
 	
 	struct QijIndex
 	{	int l1, p1; //!< Angular momentum and projector index for channel i
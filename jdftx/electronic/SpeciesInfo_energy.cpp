@@ -231,8 +231,13 @@ std::vector< vector3<double> > SpeciesInfo::getLocalForces(const ScalarFieldTild
 	return forces;
 }
 
-void SpeciesInfo::accumNonlocalForces(const ColumnBundle& Cq, const matrix& VdagC, const matrix& E_VdagC, const matrix& grad_CdagOCq, std::vector<vector3<> >& forces) const
+void SpeciesInfo::accumNonlocalForces(const ColumnBundle& Cq, const matrix& VdagC, const matrix& E_VdagC, const matrix& grad_CdagOCq, std::vector<vector3<> >& forces, const matrix* DVdagCin) const
 {	matrix DVdagC[3]; //cartesian gradient of VdagC
+	if(DVdagCin)
+	{	for(int k=0; k<3; k++)
+			DVdagC[k] = DVdagCin[k];
+	}
+	else
 	{	auto V = getV(Cq);
 		for(int k=0; k<3; k++)
 			DVdagC[k] = D(*V,k)^Cq;
@@ -256,16 +261,16 @@ void SpeciesInfo::accumNonlocalForces(const ColumnBundle& Cq, const matrix& Vdag
 std::shared_ptr<ColumnBundle> SpeciesInfo::getV(const ColumnBundle& Cq, const vector3<>* derivDir) const
 {	const QuantumNumber& qnum = *(Cq.qnum);
 	const Basis& basis = *(Cq.basis);
-	std::pair<vector3<>,const Basis*> cacheKey = std::make_pair(qnum.k, &basis);
 	int nProj = MnlAll.nRows() / e->eInfo.spinorLength();
 	if(!nProj) return 0; //purely local psp
 	//First check cache
-	if(e->cntrl.cacheProjectors && (!derivDir))
-	{	auto iter = cachedV.find(cacheKey);
-		if(iter != cachedV.end()) //found
-			return iter->second; //return cached value
+	bool useCache = e->cntrl.cacheProjectors && (!e->cntrl.realSpaceProjectors) && (!derivDir);
+	if(useCache)
+	{	std::shared_ptr<ColumnBundle> V = e->iInfo.projectorCache.find(this, qnum.k, &basis);
+		if(V) return V; //return cached value
 	}
 	//No cache / not found in cache; compute:
+	double tStart = clock_us();
 	std::shared_ptr<ColumnBundle> V = std::make_shared<ColumnBundle>(nProj*atpos.size(), basis.nbasis, &basis, &qnum, isGpuEnabled()); //not a spinor regardless of spin type
 	int iProj = 0;
 	for(int l=0; l<int(VnlRadial.size()); l++)
@@ -278,7 +283,7 @@ std::shared_ptr<ColumnBundle> SpeciesInfo::getV(const ColumnBundle& Cq, const ve
 				iProj++;
 			}
 	//Add to cache if necessary:
-	if(e->cntrl.cacheProjectors && (!derivDir))
-		((SpeciesInfo*)this)->cachedV[cacheKey] = V;
+	if(useCache)
+		e->iInfo.projectorCache.add(this, qnum.k, &basis, V, clock_us()-tStart);
 	return V;
 }
@@ -25,15 +25,56 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <atomic>
 
+//Separable structure-factor tables
+StructureFactorTable::StructureFactorTable(int nAtoms, const vector3<>* pos, const vector3<int>& nMin, const vector3<int>& nMax)
+: nAtoms(nAtoms)
+{	init(pos, nMin, nMax);
+}
+StructureFactorTable::StructureFactorTable(int nAtoms, const vector3<>* pos, const vector3<int>& S)
+: nAtoms(nAtoms)
+{	//Range of iG in THREAD_halfGspaceLoop (using the full range in all directions for simplicity)
+	vector3<int> nMin, nMax;
+	for(int j=0; j<3; j++)
+	{	nMax[j] = S[j]/2;
+		nMin[j] = nMax[j] + 1 - S[j];
+	}
+	init(pos, nMin, nMax);
+}
+StructureFactorTable::StructureFactorTable(int nAtoms, const vector3<>* pos, int nbasis, const vector3<int>* iGarr)
+: nAtoms(nAtoms)
+{	vector3<int> nMin, nMax;
+	for(int n=0; n<nbasis; n++)
+		for(int j=0; j<3; j++)
+		{	nMin[j] = std::min(nMin[j], iGarr[n][j]);
+			nMax[j] = std::max(nMax[j], iGarr[n][j]);
+		}
+	init(pos, nMin, nMax);
+}
+void StructureFactorTable::init(const vector3<>* pos, const vector3<int>& nMin, const vector3<int>& nMax)
+{	vector3<int> nCount = nMax - nMin + vector3<int>(1,1,1);
+	atomStride = nCount[0] + nCount[1] + nCount[2];
+	offset = nMin - vector3<int>(0, nCount[0], nCount[0]+nCount[1]);
+	tables.resize(nAtoms * atomStride);
+	complex* t = tables.data();
+	for(int atom=0; atom<nAtoms; atom++)
+		for(int j=0; j<3; j++)
+			for(int n=nMin[j]; n<=nMax[j]; n++)
+				*(t++) = cis((-2*M_PI) * pos[atom][j] * n);
+}
+
 //Initialize non-local projector from a radial function at a particular l,m (or its k derivatives)
 template<int l, int m>
 void Vnl(int nbasis, int atomStride, int nAtoms, const vector3<> k, const vector3<int>* iGarr,
 	const matrix3<> G, const vector3<>* pos, const RadialFunctionG& VnlRadial, complex* V, const vector3<>* derivDir)
-{	if(derivDir) //derivative w.r.t Cartesian k
+{	//Phases exp(-2 pi i pos.(k+G)) = exp(-2 pi i pos.k) * (separable table lookup for G):
+	StructureFactorTable sf(nAtoms, pos, nbasis, iGarr);
+	std::vector<complex> kPhase(nAtoms);
+	for(int atom=0; atom<nAtoms; atom++) kPhase[atom] = cis((-2*M_PI)*dot(pos[atom],k));
+	if(derivDir) //derivative w.r.t Cartesian k
 	{	const vector3<> RTdir = (2*M_PI)*(*derivDir * inv(G));
-		threadedLoop(VnlPrime_calc<l,m>, nbasis, atomStride, nAtoms, k, iGarr, G, pos, VnlRadial, *derivDir, RTdir, V);
+		threadedLoop(VnlPrime_calcTable<l,m>, nbasis, atomStride, nAtoms, k, iGarr, G, pos, &sf, kPhase.data(), VnlRadial, *derivDir, RTdir, V);
 	}
-	else threadedLoop(Vnl_calc<l,m>, nbasis, atomStride, nAtoms, k, iGarr, G, pos, VnlRadial, V);
+	else threadedLoop(Vnl_calcTable<l,m>, nbasis, atomStride, nAtoms, k, iGarr, G, &sf, kPhase.data(), VnlRadial, V);
 }
 void Vnl(int nbasis, int atomStride, int nAtoms, int l, int m, const vector3<> k, const vector3<int>* iGarr,
 	const matrix3<> G, const vector3<>* pos, const RadialFunctionG& VnlRadial, complex* V, const vector3<>* derivDir)
@@ -115,23 +156,24 @@ void nAugmentGrad(int Nlm, const vector3<int> S, const matrix3<>& G,
 
 //Structure factor
 void getSG_sub(size_t iStart, size_t iStop, const vector3<int> S,
-	int nAtoms, const vector3<>* atpos, double invVol, complex* SG)
-{	THREAD_halfGspaceLoop( SG[i] = invVol * getSG_calc(iG, nAtoms, atpos); )
+	const StructureFactorTable* sf, double invVol, complex* SG)
+{	THREAD_halfGspaceLoop( SG[i] = invVol * sf->sum(iG); )
 }
 void getSG(const vector3<int> S, int nAtoms, const vector3<>* atpos, double invVol, complex* SG)
-{	threadLaunch(getSG_sub, S[0]*S[1]*(S[2]/2+1), S, nAtoms, atpos, invVol, SG);
+{	StructureFactorTable sf(nAtoms, atpos, S);
+	threadLaunch(getSG_sub, S[0]*S[1]*(S[2]/2+1), S, &sf, invVol, SG);
 }
 
 //Local pseudopotential, ionic charge, chargeball and partial cores (CPU thread and launcher)
 void updateLocal_sub(size_t iStart, size_t iStop, const vector3<int> S, const matrix3<> GGT,
 	complex *Vlocps,  complex *rhoIon, complex *nChargeball, complex *nCore, complex* tauCore,
-	int nAtoms, const vector3<>* atpos, double invVol, const RadialFunctionG& VlocRadial,
+	const StructureFactorTable* sf, double invVol, const RadialFunctionG& VlocRadial,
 	double Z, const RadialFunctionG& nCoreRadial, const RadialFunctionG& tauCoreRadial,
 	double Zchargeball, double wChargeball)
 {	THREAD_halfGspaceLoop(
-		updateLocal_calc(i, iG, GGT,
+		updateLocal_calcSG(i, iG, GGT,
 			Vlocps, rhoIon, nChargeball, nCore, tauCore,
-			nAtoms, atpos, invVol, VlocRadial,
+			sf->sum(iG) * invVol, VlocRadial,
 			Z, nCoreRadial, tauCoreRadial, Zchargeball, wChargeball); )
 }
 void updateLocal(const vector3<int> S, const matrix3<> GGT,
@@ -139,9 +181,10 @@ void updateLocal(const vector3<int> S, const matrix3<> GGT,
 	int nAtoms, const vector3<>* atpos, double invVol, const RadialFunctionG& VlocRadial,
 	double Z, const RadialFunctionG& nCoreRadial, const RadialFunctionG& tauCoreRadial,
 	double Zchargeball, double wChargeball)
-{	threadLaunch(updateLocal_sub, S[0]*S[1]*(S[2]/2+1), S, GGT,
+{	StructureFactorTable sf(nAtoms, atpos, S);
+	threadLaunch(updateLocal_sub, S[0]*S[1]*(S[2]/2+1), S, GGT,
 		Vlocps, rhoIon, nChargeball, nCore, tauCore,
-		nAtoms, atpos, invVol, VlocRadial,
+		&sf, invVol, VlocRadial,
 		Z, nCoreRadial, tauCoreRadial, Zchargeball, wChargeball);
 }
 
@@ -171,11 +214,14 @@ void gradLocalToSG(const vector3<int> S, const matrix3<> GGT,
 }
 
 //Gradient w.r.t structure factor -> gradient w.r.t atom positions
-void gradSGtoAtpos_sub(size_t iStart, size_t iStop, const vector3<int> S, const vector3<> atpos,
+void gradSGtoAtpos_sub(size_t iStart, size_t iStop, const vector3<int> S, const StructureFactorTable* sf,
 	const complex* ccgrad_SG, vector3<complex*> grad_atpos)
-{	THREAD_halfGspaceLoop( gradSGtoAtpos_calc(i, iG, atpos, ccgrad_SG, grad_atpos); )
+{	THREAD_halfGspaceLoop(
+		complex term = complex(0,-2*M_PI) * (*sf)(0,iG) * ccgrad_SG[i].conj();
+		storeVector(iG * term, grad_atpos, i); )
 }
 void gradSGtoAtpos(const vector3<int> S, const vector3<> atpos,
 	const complex* ccgrad_SG, vector3<complex*> grad_atpos)
-{	threadLaunch(gradSGtoAtpos_sub, S[0]*S[1]*(S[2]/2+1), S, atpos, ccgrad_SG, grad_atpos);
+{	StructureFactorTable sf(1, &atpos, S);
+	threadLaunch(gradSGtoAtpos_sub, S[0]*S[1]*(S[2]/2+1), S, &sf, ccgrad_SG, grad_atpos);
 }
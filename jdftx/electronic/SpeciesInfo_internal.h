@@ -29,6 +29,38 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/RadialFunction.h>
 #include <core/SphericalHarmonics.h>
 #include <stdint.h>
+#include <vector>
+
+//! Separable structure-factor tables (used by the CPU kernels below): stores exp(-2 pi i x_j n_j) for each atom,
+//! lattice direction j and integer n_j in a range, so that exp(-2 pi i x.n) is a product of three table lookups
+//! (instead of a sincos for every atom and G-vector)
+class StructureFactorTable
+{
+public:
+	StructureFactorTable(int nAtoms, const vector3<>* pos, const vector3<int>& nMin, const vector3<int>& nMax); //!< tables for nMin <= n <= nMax
+	StructureFactorTable(int nAtoms, const vector3<>* pos, const vector3<int>& S); //!< tables covering the (half) G-space of an S grid
+	StructureFactorTable(int nAtoms, const vector3<>* pos, int nbasis, const vector3<int>* iGarr); //!< tables covering a basis
+	
+	//! exp(-2 pi i pos[atom].n)
+	inline complex operator()(int atom, const vector3<int>& n) const
+	{	const complex* t = tables.data() + atom*atomStride;
+		return t[n[0]-offset[0]] * t[n[1]-offset[1]] * t[n[2]-offset[2]];
+	}
+	
+	//! sum_atom exp(-2 pi i pos[atom].n)
+	inline complex sum(const vector3<int>& n) const
+	{	complex result(0,0);
+		for(int atom=0; atom<nAtoms; atom++) result += (*this)(atom, n);
+		return result;
+	}
+	
+private:
+	int nAtoms, atomStride; //number of atoms and table size per atom
+	vector3<int> offset; //offset[j] = nMin[j] - (start of table for direction j)
+	std::vector<complex> tables;
+	void init(const vector3<>* pos, const vector3<int>& nMin, const vector3<int>& nMax);
+};
+
 
 //! Compute Vnl at specific l and m for several atomic positions
 template<int l, int m> __hostanddev__
@@ -44,6 +76,18 @@ void Vnl_calc(int n, int atomStride, int nAtoms, const vector3<>& k, const vecto
 	for(int atom=0; atom<nAtoms; atom++)
 		Vnl[atom*atomStride+n] = prefac * cis((-2*M_PI)*dot(pos[atom],kpG));
 }
+//! Same as Vnl_calc, with phases from separable structure-factor tables (sf) and per-atom phases kPhase = exp(-2 pi i pos.k)
+template<int l, int m>
+void Vnl_calcTable(int n, int atomStride, int nAtoms, const vector3<>& k, const vector3<int>* iGarr,
+	const matrix3<>& G, const StructureFactorTable* sf, const complex* kPhase, const RadialFunctionG& VnlRadial, complex* Vnl)
+{
+	vector3<> qvec = (k + iGarr[n]) * G; //k+G in cartesian coordinates
+	double q = qvec.length();
+	vector3<> qhat = qvec * (q ? 1.0/q : 0.0); //the unit vector along qvec (set qhat to 0 for q=0 (doesn't matter))
+	double prefac = Ylm<l,m>(qhat) * VnlRadial(q); //prefactor to structure factor
+	for(int atom=0; atom<nAtoms; atom++)
+		Vnl[atom*atomStride+n] = (prefac * kPhase[atom]) * (*sf)(atom, iGarr[n]);
+}
 //! Derivative of above with respect to Cartesian k in direction iDir
 template<int l, int m> __hostanddev__
 void VnlPrime_calc(int n, int atomStride, int nAtoms, const vector3<>& k, const vector3<int>* iGarr,
@@ -70,6 +114,28 @@ void VnlPrime_calc(int n, int atomStride, int nAtoms, const vector3<>& k, const
 		Vprime[atom*atomStride+n] = predac_qDir*S + prefac*S_qDir;
 	}
 }
+//! Same as VnlPrime_calc, with phases from separable structure-factor tables (see Vnl_calcTable)
+template<int l, int m>
+void VnlPrime_calcTable(int n, int atomStride, int nAtoms, const vector3<>& k, const vector3<int>* iGarr,
+	const matrix3<>& G, const vector3<>* pos, const StructureFactorTable* sf, const complex* kPhase, const RadialFunctionG& VnlRadial,
+	const vector3<>& dir, const vector3<>& RTdir, complex* Vprime)
+{
+	vector3<> qvec = (k + iGarr[n]) * G; //k+G in cartesian coordinates
+	double q = qvec.length();
+	double qInv = (q ? 1.0/q : 0.0); //regularized 1/q
+	vector3<> qhat = qvec * qInv; //unit vector || qvec (set to 0 for q=0 (doesn't matter))
+	double qhatDir = dot(qhat, dir);
+	double Y = Ylm<l,m>(qhat);
+	double Y_qDir = dot(YlmPrime<l,m>(qhat), dir - qhat*qhatDir) * qInv;
+	double Vradial = VnlRadial(q);
+	double Vradial_qDir = VnlRadial.deriv(q) * qhatDir;
+	double prefac = Y*Vradial, predac_qDir = Y_qDir*Vradial + Y*Vradial_qDir;
+	for(int atom=0; atom<nAtoms; atom++)
+	{	complex S = kPhase[atom] * (*sf)(atom, iGarr[n]);
+		complex S_qDir = S * complex(0.,-dot(pos[atom],RTdir));
+		Vprime[atom*atomStride+n] = predac_qDir*S + prefac*S_qDir;
+	}
+}
 //! Driver routine for calculating Vnl for all basis functions
 //! If derivDir is non-null, then calculate derivative with respect to Cartesian k oprojected along *derivDir
 void Vnl(int nbasis, int atomStride, int nAtoms, int l, int m, const vector3<> k, const vector3<int>* iGarr,
@@ -227,18 +293,15 @@ void getSG(const vector3<int> S, int nAtoms, const vector3<>* atpos, double invV
 void getSG_gpu(const vector3<int> S, int nAtoms, const vector3<>* atpos, double invVol, complex* SG);
 #endif
 
-//! Calculate local pseudopotential, ionic density and chargeball due to one species at a given G-vector
-__hostanddev__ void updateLocal_calc(int i, const vector3<int>& iG, const matrix3<>& GGT,
+//! Calculate local pseudopotential, ionic density and chargeball due to one species at a given G-vector, given the structure factor / volume
+__hostanddev__ void updateLocal_calcSG(int i, const vector3<int>& iG, const matrix3<>& GGT,
 	complex *Vlocps, complex *rhoIon, complex *nChargeball, complex* nCore, complex* tauCore,
-	int nAtoms, const vector3<>* atpos, double invVol, const RadialFunctionG& VlocRadial,
+	complex SGinvVol, const RadialFunctionG& VlocRadial,
 	double Z, const RadialFunctionG& nCoreRadial, const RadialFunctionG& tauCoreRadial,
 	double Zchargeball, double wChargeball)
 {
 	double Gsq = GGT.metric_length_squared(iG);
 
-	//Compute structure factor (scaled by 1/detR):
-	complex SGinvVol = getSG_calc(iG, nAtoms, atpos) * invVol;
-
 	//Short-ranged part of Local potential (long-ranged part added on later in IonInfo.cpp):
 	Vlocps[i] += SGinvVol * VlocRadial(sqrt(Gsq));
 
@@ -253,6 +316,15 @@ __hostanddev__ void updateLocal_calc(int i, const vector3<int>& iG, const matrix
 	if(nCore) nCore[i] += SGinvVol * nCoreRadial(sqrt(Gsq));
 	if(tauCore) tauCore[i] += SGinvVol * tauCoreRadial(sqrt(Gsq));
 }
+//! Calculate local pseudopotential, ionic density and chargeball due to one species at a given G-vector
+__hostanddev__ void updateLocal_calc(int i, const vector3<int>& iG, const matrix3<>& GGT,
+	complex *Vlocps, complex *rhoIon, complex *nChargeball, complex* nCore, complex* tauCore,
+	int nAtoms, const vector3<>* atpos, double invVol, const RadialFunctionG& VlocRadial,
+	double Z, const RadialFunctionG& nCoreRadial, const RadialFunctionG& tauCoreRadial,
+	double Zchargeball, double wChargeball)
+{	updateLocal_calcSG(i, iG, GGT, Vlocps, rhoIon, nChargeball, nCore, tauCore,
+		getSG_calc(iG, nAtoms, atpos) * invVol, VlocRadial, Z, nCoreRadial, tauCoreRadial, Zchargeball, wChargeball);
+}
 void updateLocal(const vector3<int> S, const matrix3<> GGT,
 	complex *Vlocps,  complex *rhoIon, complex *n_chargeball, complex* n_core, complex* tauCore,
 	int nAtoms, const vector3<>* atpos, double invVol, const RadialFunctionG& VlocRadial,
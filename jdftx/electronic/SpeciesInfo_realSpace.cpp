@@ -0,0 +1,252 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <electronic/SpeciesInfo.h>
+#include <electronic/Everything.h>
+#include <core/SphericalHarmonics.h>
+
+//Real-space projectors: the reciprocal-space projectors are tapered smoothly to zero between the
+//wavefunction cutoff and the largest sphere that fits in the FFT box (to control aliasing),
+//transformed to real space, and truncated at a radius where they drop below a relative tolerance.
+
+void SpeciesInfo::initRealSpaceProjectors(const GridInfo& gInfoWfns, const vector3<>& k) const
+{	SpeciesInfo& sp = *((SpeciesInfo*)this); //cached quantities are logically const
+	int nProj = MnlAll.nRows();
+	if(!nProj) return;
+	
+	if(!realSpaceV.size() || realSpaceVgrid != &gInfoWfns)
+	{	static StopWatch watch("initRealSpaceProjectors"); watch.start();
+		const GridInfo& gInfo = gInfoWfns;
+		//Determine Fourier filter:
+		double qStart = sqrt(2.*e->cntrl.Ecut);
+		double qStop = DBL_MAX;
+		for(int dir=0; dir<3; dir++)
+			qStop = std::min(qStop, M_PI * gInfo.S[dir] / gInfo.R.column(dir).length());
+		qStop = std::max(qStop, 1.1*qStart);
+		double qMax = 0.; //maximum q supported by VnlRadial
+		for(const auto& Vl: VnlRadial)
+			for(const RadialFunctionG& Vlp: Vl)
+				qMax = std::max(qMax, (Vlp.nCoeff-5)/Vlp.dGinv);
+		qStop = std::min(qStop, qMax);
+		qStart = std::min(qStart, qStop);
+		const double dq = 0.02;
+		int nq = int(ceil(qStop/dq)) + 1;
+		std::vector<double> wq(nq); //filter times q^2 dq with trapezoidal weights
+		for(int iq=0; iq<nq; iq++)
+		{	double q = std::min(iq*dq, qStop);
+			double filter = (q<=qStart) ? 1. : std::pow(cos(0.5*M_PI*(q-qStart)/(qStop-qStart)), 2);
+			wq[iq] = filter * q*q * dq * ((iq==0 || iq==nq-1) ? 0.5 : 1.);
+		}
+		
+		//Radial transforms of filtered projectors (order l, p as in VnlRadial):
+		const double dx = 0.02, xMax = 10.;
+		const double prefac = gInfo.detR / (2*M_PI*M_PI);
+		int nx = int(ceil(xMax/dx)) + 1;
+		std::vector<std::vector<std::vector<double>>>& Fradial = sp.realSpaceF;
+		Fradial.assign(VnlRadial.size(), std::vector<std::vector<double>>());
+		sp.realSpaceDx = dx;
+		double Fmax = 0.;
+		for(int l=0; l<int(VnlRadial.size()); l++)
+			for(const RadialFunctionG& Vlp: VnlRadial[l])
+			{	std::vector<double> F(nx, 0.);
+				std::vector<double> fq(nq);
+				for(int iq=0; iq<nq; iq++) fq[iq] = wq[iq] * Vlp(std::min(iq*dq, qStop));
+				for(int ix=0; ix<nx; ix++)
+					for(int iq=0; iq<nq; iq++)
+						F[ix] += fq[iq] * bessel_jl(l, std::min(iq*dq, qStop)*ix*dx);
+				for(double& Fx: F) Fx *= prefac;
+				for(double Fx: F) Fmax = std::max(Fmax, fabs(Fx));
+				Fradial[l].push_back(F);
+			}
+		//Determine truncation radius:
+		int nxCut = 1;
+		for(const auto& Fl: Fradial)
+			for(const auto& F: Fl)
+				for(int ix=0; ix<nx; ix++)
+					if(fabs(F[ix]) > e->cntrl.realSpaceProjectorTol * Fmax)
+						nxCut = std::max(nxCut, ix+1);
+		double rCut = (nxCut-1)*dx;
+		
+		//Initialize projectors for each atom:
+		sp.realSpaceV.assign(atpos.size(), RealSpaceProjector());
+		vector3<int> iMin, iMax; //bounding box offsets in grid coordinates
+		for(int dir=0; dir<3; dir++)
+		{	double xExtent = rCut * sqrt(gInfo.GGT(dir,dir)) / (2*M_PI); //extent in lattice coordinates
+			iMax[dir] = int(ceil(xExtent * gInfo.S[dir]));
+			iMin[dir] = -iMax[dir];
+		}
+		size_t nPointsTot = 0;
+		for(unsigned atom=0; atom<atpos.size(); atom++)
+		{	RealSpaceProjector& rsp = sp.realSpaceV[atom];
+			vector3<int> iCenter;
+			for(int dir=0; dir<3; dir++) iCenter[dir] = int(round(atpos[atom][dir] * gInfo.S[dir]));
+			std::vector<vector3<>> rVec; //Cartesian displacements from atom
+			vector3<int> iR;
+			for(iR[0]=iCenter[0]+iMin[0]; iR[0]<=iCenter[0]+iMax[0]; iR[0]++)
+			for(iR[1]=iCenter[1]+iMin[1]; iR[1]<=iCenter[1]+iMax[1]; iR[1]++)
+			for(iR[2]=iCenter[2]+iMin[2]; iR[2]<=iCenter[2]+iMax[2]; iR[2]++)
+			{	vector3<> x; vector3<int> iWrapped;
+				for(int dir=0; dir<3; dir++)
+				{	x[dir] = iR[dir] * (1./gInfo.S[dir]);
+					iWrapped[dir] = iR[dir] % gInfo.S[dir];
+					if(iWrapped[dir] < 0) iWrapped[dir] += gInfo.S[dir];
+				}
+				vector3<> r = gInfo.R * (x - atpos[atom]);
+				if(r.length() >= rCut) continue;
+				rsp.index.push_back(gInfo.fullRindex(iWrapped));
+				rsp.x.push_back(x);
+				rVec.push_back(r);
+			}
+			int nPoints = rsp.index.size();
+			nPointsTot += nPoints;
+			rsp.B = matrix(nPoints, nProj);
+			complex* Bdata = rsp.B.data();
+			for(int i=0; i<nPoints; i++)
+				realSpaceProjectorValues(rVec[i], Bdata+i, nPoints);
+		}
+		sp.realSpaceVgrid = &gInfoWfns;
+		sp.realSpaceVk = vector3<>(NAN,NAN,NAN); //force phase initialization below
+		logPrintf("Initialized real-space projectors for species %s with radius %.2lf bohrs (%lu grid points for %lu atoms).\n",
+			name.c_str(), rCut, nPointsTot, atpos.size());
+		watch.stop();
+	}
+	
+	//Update Bloch phases if necessary:
+	if(!(k == realSpaceVk))
+	{	for(RealSpaceProjector& rsp: sp.realSpaceV)
+		{	rsp.phase.resize(rsp.x.size());
+			for(size_t i=0; i<rsp.x.size(); i++)
+				rsp.phase[i] = cis(2*M_PI*dot(k, rsp.x[i]));
+		}
+		sp.realSpaceVk = k;
+	}
+}
+
+void SpeciesInfo::realSpaceProjectorValues(const vector3<>& r, complex* B, int stride) const
+{	const double dx = realSpaceDx;
+	double rMag = r.length();
+	vector3<> rHat = r * (rMag ? 1./rMag : 0.);
+	int iProj = 0;
+	for(int l=0; l<int(realSpaceF.size()); l++)
+	{	complex il = cis(0.5*M_PI*l);
+		for(const std::vector<double>& F: realSpaceF[l])
+		{	double t = rMag/dx; int it = std::min(int(t), int(F.size())-2); t -= it; //linear interpolation
+			double Fr = F[it] + t*(F[it+1]-F[it]);
+			for(int m=-l; m<=l; m++)
+				B[stride*(iProj++)] = il * Ylm(l,m,rHat) * Fr;
+		}
+	}
+}
+
+void SpeciesInfo::initRealSpaceProjectorGrad() const
+{	SpeciesInfo& sp = *((SpeciesInfo*)this); //cached quantities are logically const
+	int nProj = MnlAll.nRows();
+	const GridInfo& gInfo = *realSpaceVgrid;
+	const double h = 1e-4; //central-difference step in bohrs (well below the interpolation grid spacing)
+	std::vector<complex> Bplus(nProj), Bminus(nProj);
+	for(unsigned atom=0; atom<realSpaceV.size(); atom++)
+	{	RealSpaceProjector& rsp = sp.realSpaceV[atom];
+		int nPoints = rsp.index.size();
+		for(int k=0; k<3; k++)
+		{	rsp.DB[k] = matrix(nPoints, nProj);
+			complex* DBdata = rsp.DB[k].data();
+			vector3<> dr; dr[k] = h;
+			for(int i=0; i<nPoints; i++)
+			{	vector3<> r = gInfo.R * (rsp.x[i] - atpos[atom]);
+				realSpaceProjectorValues(r+dr, Bplus.data(), 1);
+				realSpaceProjectorValues(r-dr, Bminus.data(), 1);
+				for(int p=0; p<nProj; p++)
+					DBdata[rsp.DB[k].index(i,p)] = (0.5/h) * (Bplus[p] - Bminus[p]);
+			}
+		}
+	}
+}
+
+void SpeciesInfo::freeRealSpaceProjectorGrad() const
+{	SpeciesInfo& sp = *((SpeciesInfo*)this); //cached quantities are logically const
+	for(RealSpaceProjector& rsp: sp.realSpaceV)
+		for(int k=0; k<3; k++)
+			rsp.DB[k] = matrix();
+}
+
+void SpeciesInfo::projectRealSpace(const complexScalarField& Ipsi, int b, matrix& VdagCq) const
+{	const complex* psiData = Ipsi->data();
+	int nProj = MnlAll.nRows();
+	double normFac = 1./Ipsi->gInfo.nr;
+	std::vector<complex> psiLocal;
+	for(unsigned atom=0; atom<realSpaceV.size(); atom++)
+	{	const RealSpaceProjector& rsp = realSpaceV[atom];
+		int nPoints = rsp.index.size();
+		psiLocal.resize(nPoints);
+		for(int i=0; i<nPoints; i++)
+			psiLocal[i] = rsp.phase[i] * psiData[rsp.index[i]];
+		const complex* Bdata = rsp.B.data();
+		for(int p=0; p<nProj; p++)
+		{	const complex* Bp = Bdata + rsp.B.index(0,p);
+			complex result = 0.;
+			for(int i=0; i<nPoints; i++)
+				result += Bp[i].conj() * psiLocal[i];
+			VdagCq.data()[VdagCq.index(atom*nProj+p, b)] = result * normFac;
+		}
+	}
+}
+
+void SpeciesInfo::projectGradRealSpace(const matrix& HVdagCq, int b, complexScalarField& X) const
+{	complex* Xdata = X->data();
+	int nProj = MnlAll.nRows();
+	std::vector<complex> Xlocal;
+	for(unsigned atom=0; atom<realSpaceV.size(); atom++)
+	{	const RealSpaceProjector& rsp = realSpaceV[atom];
+		int nPoints = rsp.index.size();
+		Xlocal.assign(nPoints, 0.);
+		const complex* Bdata = rsp.B.data();
+		for(int p=0; p<nProj; p++)
+		{	const complex* Bp = Bdata + rsp.B.index(0,p);
+			complex h = HVdagCq.data()[HVdagCq.index(atom*nProj+p, b)];
+			for(int i=0; i<nPoints; i++)
+				Xlocal[i] += Bp[i] * h;
+		}
+		for(int i=0; i<nPoints; i++)
+			Xdata[rsp.index[i]] += rsp.phase[i].conj() * Xlocal[i];
+	}
+}
+
+void SpeciesInfo::projectGradPosRealSpace(const complexScalarField& Ipsi, int b, matrix* DVdagCq) const
+{	const complex* psiData = Ipsi->data();
+	int nProj = MnlAll.nRows();
+	double normFac = 1./Ipsi->gInfo.nr;
+	std::vector<complex> psiLocal;
+	for(unsigned atom=0; atom<realSpaceV.size(); atom++)
+	{	const RealSpaceProjector& rsp = realSpaceV[atom];
+		int nPoints = rsp.index.size();
+		psiLocal.resize(nPoints);
+		for(int i=0; i<nPoints; i++)
+			psiLocal[i] = rsp.phase[i] * psiData[rsp.index[i]];
+		for(int k=0; k<3; k++)
+		{	const complex* DBdata = rsp.DB[k].data();
+			for(int p=0; p<nProj; p++)
+			{	const complex* DBp = DBdata + rsp.DB[k].index(0,p);
+				complex result = 0.;
+				for(int i=0; i<nPoints; i++)
+					result += DBp[i].conj() * psiLocal[i];
+				DVdagCq[k].data()[DVdagCq[k].index(atom*nProj+p, b)] = result * normFac;
+			}
+		}
+	}
+}
@@ -20,10 +20,11 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <electronic/TetrahedralDOS.h>
 #include <core/LatticeUtils.h>
 #include <core/Util.h>
+#include <core/Thread.h>
+#include <core/MPIUtil.h>
 #include <algorithm>
 #include <cfloat>
 #include <map>
-#include <set>
 
 TetrahedralDOS::TetrahedralDOS(std::vector<vector3<>> kmesh, std::vector<int> iReduced,
 	const matrix3<>& R, const matrix3<int>& super, int nSpins, int nBands, int nWeights, double weightSum)
@@ -114,6 +115,11 @@ void TetrahedralDOS::setWeights(int iWeight, const std::vector<diagMatrix>& weig
 			w(iWeight,q,b) = weights[q][b];
 }
 
+void TetrahedralDOS::bcast(const MPIUtil* mpiUtil, int root)
+{	mpiUtil->bcastData(eigs, root);
+	mpiUtil->bcastData(weights, root);
+}
+
 
 //Replace clusters of eigenvalues that differ by less than Etol, to a single value
 void TetrahedralDOS::weldEigenvalues(double Etol)
@@ -195,52 +201,61 @@ void TetrahedralDOS::printDOS(const Lspline& dos, string filename, string header
 
 //---- Internal implementation and private functions -----
 
-//An interval in energy
-struct Interval
-{	double eStart, eStop;
-	Interval(double eStart=0.0, double eStop=0.0):eStart(eStart),eStop(eStop) {}
-	bool operator<(const Interval& i) const { if(eStart!=i.eStart) return eStart<i.eStart; else return eStop<i.eStop; }
-};
+//Value of a cubic bezier spline with coefficients
+//b[0] (1-t)^3 + b[1] 3t(1-t)^2 + b[2] 3(1-t)t^2 + b[3] t^3
+inline double bezierValue(const double* b, double t)
+{	double c[3], d[2];
+	//deCasteljau's algorithm for cubic bezier:
+	for(int k=0; k<3; k++) c[k] = b[k] + t*(b[k+1]-b[k]);
+	for(int k=0; k<2; k++) d[k] = c[k] + t*(c[k+1]-c[k]);
+	return d[0]+t*(d[1]-d[0]);
+}
 
-//Coefficient set in an interval for an array of cubic splines, corresponding to
-//b[0] (1-t)^3 + b[1] 3t(1-t)^2 + b[2] 3(1-t)t^2 + b[3] t^3 for each b in bArr
-struct CsplineElem
-{	typedef std::array<double,4> double4;
-	std::vector<double4> bArr;
-	
-	//Allocate and initializie to zero if unallocated, otherwise leave unchanged
-	void nullToZero(int nWeights)
-	{	double4 zero4 = {{0.,0.,0.,0.}};
-		if(!bArr.size()) bArr.assign(nWeights, zero4);
-	}
+//Derivative with respect to t of a cubic bezier spline with coefficients b
+inline double bezierDeriv(const double* b, double t)
+{	double c[3], d[2];
+	//Derivative is a bezier spline of degree 2 with coefficients:
+	for(int k=0; k<3; k++) c[k] = 3.0*(b[k+1]-b[k]);
+	//deCasteljau's algorithm for the quadtratic bezier:
+	for(int k=0; k<2; k++) d[k] = c[k] + t*(c[k+1]-c[k]);
+	return d[0]+t*(d[1]-d[0]);
+}
+
+//Flat buffer of arbitrarily overlapping cubic spline pieces (one for each weight function) and delta functions.
+//Each piece occupies stride = 2+4*nWeights entries: eStart, eStop followed by the bezier coefficients
+//(4 per weight function), or for a delta function (eStart == eStop), its weights in the first nWeights slots.
+struct CsplinePieces
+{	int nWeights, stride;
+	std::vector<double> data;
 	
-	double value(double t, int i) const
-	{	double4 b = bArr[i];
-		double c[3], d[2];
-		//deCasteljau's algorithm for cubic bezier:
-		for(int k=0; k<3; k++) c[k] = b[k] + t*(b[k+1]-b[k]);
-		for(int k=0; k<2; k++) d[k] = c[k] + t*(c[k+1]-c[k]);
-		return d[0]+t*(d[1]-d[0]);
-	}
+	void init(int nWeights) { this->nWeights = nWeights; stride = 2+4*nWeights; data.clear(); }
+	size_t size() const { return data.size() / stride; }
 	
-	double deriv(double t, int i) const
-	{	double4 b = bArr[i];
-		double c[3], d[2];
-		//Derivative is a bezier spline of degree 2 with coefficients:
-		for(int k=0; k<3; k++) c[k] = 3.0*(b[k+1]-b[k]);
-		//deCasteljau's algorithm for the quadtratic bezier:
-		for(int k=0; k<2; k++) d[k] = c[k] + t*(c[k+1]-c[k]);
-		return d[0]+t*(d[1]-d[0]);
+	//Append a zero-initialized piece and return its offset into data
+	size_t add(double eStart, double eStop)
+	{	size_t offset = data.size();
+		data.resize(offset + stride, 0.);
+		data[offset] = eStart;
+		data[offset+1] = eStop;
+		return offset;
 	}
 };
 
-struct Cspline : public std::map<Interval,CsplineElem> //array of piecewise cubic splines (one for each weight function)
-{	std::map<double, std::vector<double> > deltas; //additional delta functions (from tetrahedra with same energy for all vertices)
+//Regular piecewise cubic splines (one for each weight function) on a sorted set of energy nodes
+struct Cspline
+{	int nWeights;
+	std::vector<double> nodes; //sorted energy nodes
+	std::vector<double> b; //bezier coefficients (interval outer, weight function middle, coefficient inner)
+	std::vector<double> deltas; //weights of delta functions at each node (node outer, weight function inner)
+	
+	size_t nIntervals() const { return nodes.size()-1; }
+	double* bArr(size_t j, int i) { return b.data() + 4*(j*nWeights + i); }
+	const double* bArr(size_t j, int i) const { return b.data() + 4*(j*nWeights + i); }
 };
 
 //Accumulate contribution from one tetrahedron (exactly a cubic spline for linear interpolation)
 //to the weighted DOS for all weight functions (from a single band)
-void TetrahedralDOS::accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin, Cspline& wdos) const
+void TetrahedralDOS::accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin, CsplinePieces& pieces) const
 {	//sort vertices in ascending order of energy:
 	std::array<int,4> q = t.q;
 	struct EnergyCmp
@@ -258,8 +273,7 @@ void TetrahedralDOS::accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin
 	//Area coefficient
 	if(e3==e0)
 	{	//Implies e0=e1=e2=e3, and the corresponding density of states is a delta function
-		std::vector<double>& wDelta = wdos.deltas[e0];
-		if(!wDelta.size()) wDelta.resize(nWeights, 0.);
+		double* wDelta = pieces.data.data() + pieces.add(e0, e0) + 2;
 		for(int i=0; i<nWeights; i++)
 			wDelta[i] += t.V * (1./4) * (w0[i] + w1[i] + w2[i] + w3[i]);
 		return;
@@ -272,11 +286,14 @@ void TetrahedralDOS::accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin
 	double E12_0 = 0., E21_3 = 0.;
 	if(e2>e0) E12_0 = (e1-e0)/(e2-e0);
 	if(e3>e1) E21_3 = (e3-e2)/(e3-e1);
-	//Create the coefficients:
-	CsplineElem *c01=0, *c12=0, *c23=0;
-	if(e1>e0) { c01 = &wdos[Interval(e0,e1)]; c01->nullToZero(nWeights); }
-	if(e2>e1) { c12 = &wdos[Interval(e1,e2)]; c12->nullToZero(nWeights); }
-	if(e3>e2) { c23 = &wdos[Interval(e2,e3)]; c23->nullToZero(nWeights); }
+	//Create the coefficients (offsets first, since adding pieces may reallocate):
+	const size_t none = string::npos;
+	size_t o01 = (e1>e0) ? pieces.add(e0,e1) : none;
+	size_t o12 = (e2>e1) ? pieces.add(e1,e2) : none;
+	size_t o23 = (e3>e2) ? pieces.add(e2,e3) : none;
+	double* c01 = (o01==none) ? 0 : pieces.data.data()+o01+2;
+	double* c12 = (o12==none) ? 0 : pieces.data.data()+o12+2;
+	double* c23 = (o23==none) ? 0 : pieces.data.data()+o23+2;
 	for(int i=0; i<nWeights; i++)
 	{	double w0i=w0[i], w1i=w1[i], w2i=w2[i], w3i=w3[i];
 		double wai = w0i + (w3i-w0i)*E13_0;
@@ -284,140 +301,143 @@ void TetrahedralDOS::accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin
 		double wci = w3i + (w0i-w3i)*E20_3;
 		double wdi = w3i + (w1i-w3i)*E21_3;
 		if(c01)
-		{	CsplineElem::double4& b = c01->bArr[i];
+		{	double* b = c01 + 4*i;
 			b[2] += A*E12_0*w0i;
 			b[3] += A*E12_0*(w1i+wbi+wai);
 		}
 		if(c12)
-		{	CsplineElem::double4& b = c12->bArr[i];
+		{	double* b = c12 + 4*i;
 			b[0] += A*E12_0*(w1i+wbi+wai);
 			b[1] += A*(w1i + (1.0/3)*(2*wai+wbi + E12_0*(2*w2i+wci)));
 			b[2] += A*(w2i + (1.0/3)*(2*wci+wdi + E21_3*(2*w1i+wai)));
 			b[3] += A*E21_3*(w2i+wci+wdi);
 		}
 		if(c23)
-		{	CsplineElem::double4& b = c23->bArr[i];
+		{	double* b = c23 + 4*i;
 			b[0] += A*E21_3*(w2i+wci+wdi);
 			b[1] += A*E21_3*w3i;
 		}
 	}
 }
 
-//Coalesce overlapping splines: convert an arbitrary set of spline pieces into a regular ordered piecewise spline
-void TetrahedralDOS::coalesceIntervals(Cspline& cspline) const
-{	//Create a list of nodes for the splines:
-	std::set<double> e;
-	for(Cspline::const_iterator i=cspline.begin(); i!=cspline.end(); i++)
-	{	e.insert(i->first.eStart);
-		e.insert(i->first.eStop);
+void TetrahedralDOS::accumTetrahedra_thread(size_t iChunkStart, size_t iChunkStop, const TetrahedralDOS* td,
+	size_t iTetStart, size_t iTetStop, size_t chunkSize, int iBand, int iSpin, CsplinePieces* pieces)
+{	for(size_t iChunk=iChunkStart; iChunk<iChunkStop; iChunk++)
+	{	CsplinePieces& chunkPieces = pieces[iChunk];
+		chunkPieces.init(td->nWeights); //retains capacity from previous blocks
+		size_t tStart = std::min(iTetStart + iChunk*chunkSize, iTetStop);
+		size_t tStop = std::min(tStart + chunkSize, iTetStop);
+		for(size_t t=tStart; t<tStop; t++)
+			td->accumTetrahedron(td->tetrahedra[t], iBand, iSpin, chunkPieces);
 	}
-	for(auto iter: cspline.deltas)
-		e.insert(iter.first);
-	//Now break each original spline piece down to the intervals in e
+}
+
+//Coalesce overlapping splines: convert an arbitrary set of spline pieces into a regular ordered piecewise spline
+void TetrahedralDOS::coalesceIntervals_thread(size_t jStart, size_t jStop, const TetrahedralDOS* td,
+	const std::vector<CsplinePieces>* pieces, Cspline* cspline)
+{	if(jStart >= jStop) return; //no nodes for this thread (when there are fewer nodes than threads)
+	int nWeights = td->nWeights;
+	const std::vector<double>& nodes = cspline->nodes;
+	//Energy range of nodes and intervals handled by this thread:
+	double eNodeMin = nodes[jStart], eNodeMax = nodes[jStop-1];
+	double eIntervalMax = nodes[std::min(jStop, nodes.size()-1)];
 	std::vector<double> v(nWeights), d(nWeights); //temporary storage for values and derivatives
-	std::map<Interval, CsplineElem> combined;
-	for(Cspline::const_iterator cIter=cspline.begin(); cIter!=cspline.end(); cIter++)
-	{	const double& eStart = cIter->first.eStart;
-		const double& eStop = cIter->first.eStop;
-		double inv_de = 1.0/(eStop-eStart);
-		const CsplineElem& celem = cIter->second;
-		std::set<double>::iterator j=e.find(eStart), jStop=e.find(eStop);
-		double e = *j;
-		double t = (e-eStart)*inv_de;
-		for(int i=0; i<nWeights; i++)
-		{	v[i] = celem.value(t, i);
-			d[i] = celem.deriv(t, i)*inv_de;
-		}
-		while(j!=jStop)
-		{	j++;
-			double eNext = *j;
-			double tNext = (eNext-eStart)*inv_de;
-			CsplineElem& c = combined[Interval(e,eNext)];
-			c.nullToZero(nWeights);
+	for(const CsplinePieces& chunkPieces: *pieces)
+	{	const double* piece = chunkPieces.data.data();
+		for(size_t iPiece=0; iPiece<chunkPieces.size(); iPiece++, piece+=chunkPieces.stride)
+		{	const double& eStart = piece[0];
+			const double& eStop = piece[1];
+			const double* coeff = piece+2;
+			if(eStart == eStop)
+			{	//Delta function: add to owning node if in range
+				if(eStart<eNodeMin || eStart>eNodeMax) continue;
+				size_t j = std::lower_bound(nodes.begin(), nodes.end(), eStart) - nodes.begin();
+				double* wDelta = cspline->deltas.data() + j*nWeights;
+				for(int i=0; i<nWeights; i++) wDelta[i] += coeff[i];
+				continue;
+			}
+			if(eStop<=eNodeMin || eStart>=eIntervalMax) continue; //no overlap with intervals of this thread
+			//Break piece down to the intervals between nodes within this thread's range:
+			size_t jPieceStart = std::lower_bound(nodes.begin(), nodes.end(), eStart) - nodes.begin();
+			size_t jPieceStop = std::lower_bound(nodes.begin()+jPieceStart, nodes.end(), eStop) - nodes.begin();
+			size_t j = std::max(jPieceStart, jStart);
+			size_t jEnd = std::min(jPieceStop, jStop);
+			double inv_de = 1.0/(eStop-eStart);
+			double e = nodes[j];
+			double t = (e-eStart)*inv_de;
 			for(int i=0; i<nWeights; i++)
-			{	double viNext = celem.value(tNext, i);
-				double diNext = celem.deriv(tNext, i)*inv_de;
-				CsplineElem::double4& bi = c.bArr[i];
-				bi[0] += v[i];
-				bi[1] += v[i] + (1.0/3)*(eNext-e)*d[i];
-				bi[2] += viNext - (1.0/3)*(eNext-e)*diNext;
-				bi[3] += viNext;
-				v[i] = viNext;
-				d[i] = diNext;
+			{	v[i] = bezierValue(coeff+4*i, t);
+				d[i] = bezierDeriv(coeff+4*i, t)*inv_de;
+			}
+			for(; j<jEnd; j++)
+			{	double eNext = nodes[j+1];
+				double tNext = (eNext-eStart)*inv_de;
+				for(int i=0; i<nWeights; i++)
+				{	double viNext = bezierValue(coeff+4*i, tNext);
+					double diNext = bezierDeriv(coeff+4*i, tNext)*inv_de;
+					double* bi = cspline->bArr(j, i);
+					bi[0] += v[i];
+					bi[1] += v[i] + (1.0/3)*(eNext-e)*d[i];
+					bi[2] += viNext - (1.0/3)*(eNext-e)*diNext;
+					bi[3] += viNext;
+					v[i] = viNext;
+					d[i] = diNext;
+				}
+				e=eNext;
 			}
-			e=eNext;
-			t=tNext;
 		}
 	}
-	//Fix interior discontinuities and incorporate interior deltas:
-	auto cIter = combined.begin();
-	double h = cIter->first.eStop - cIter->first.eStart;
-	auto cIterNext = cIter; cIterNext++;
-	while(cIterNext != combined.end())
-	{	double hNext = cIterNext->first.eStop - cIterNext->first.eStart;
-		assert(cIterNext->first.eStart == cIter->first.eStop);
-		//Check for a delta at the intersection of the two intervals:
-		std::vector<double>* deltaPtr = 0;
-		auto dIter = cspline.deltas.find(cIter->first.eStop);
-		if(dIter != cspline.deltas.end())
-			deltaPtr = &(dIter->second);
+}
+
+//Fix interior discontinuities and incorporate deltas
+void TetrahedralDOS::incorporateDeltas(Cspline& cspline) const
+{	size_t nIntervals = cspline.nIntervals();
+	const std::vector<double>& nodes = cspline.nodes;
+	//Interior nodes:
+	for(size_t j=0; j+1<nIntervals; j++)
+	{	double h = nodes[j+1] - nodes[j];
+		double hNext = nodes[j+2] - nodes[j+1];
+		const double* delta = cspline.deltas.data() + (j+1)*nWeights; //delta at the intersection of the two intervals
 		//Update weights at the interval intersection:
 		for(int i=0; i<nWeights; i++)
-		{	double integral = h*cIter->second.bArr[i][3] + hNext*cIterNext->second.bArr[i][0];
-			if(deltaPtr) integral += 4*deltaPtr->at(i);
+		{	double* b = cspline.bArr(j, i);
+			double* bNext = cspline.bArr(j+1, i);
+			double integral = h*b[3] + hNext*bNext[0] + 4*delta[i];
 			double wMean = integral/(h + hNext);
-			cIter->second.bArr[i][3] = wMean;
-			cIterNext->second.bArr[i][0] = wMean;
+			b[3] = wMean;
+			bNext[0] = wMean;
 		}
-		//Advance to next interval
-		h = hNext;
-		cIter = cIterNext;
-		cIterNext++;
 	}
-	//Incorporate deltas at the extrema:
-	if(cspline.deltas.size())
-	{	//Delta at bottom of band:
-		auto cIter = combined.begin();
-		auto dIter = cspline.deltas.begin();
-		if(dIter->first == cIter->first.eStart)
-		{	double h = cIter->first.eStop - cIter->first.eStart;
-			for(int i=0; i<nWeights; i++)
-				cIter->second.bArr[i][0] += dIter->second[i]*(4./h);
-		}
-		//Delta at top of band:
-		cIter = combined.end(); cIter--; //iterator to last entry
-		dIter = cspline.deltas.end(); dIter--; //iterator to last entry
-		if(dIter->first == cIter->first.eStop)
-		{	double h = cIter->first.eStop - cIter->first.eStart;
-			for(int i=0; i<nWeights; i++)
-				cIter->second.bArr[i][3] += dIter->second[i]*(4./h);
-		}
+	//Deltas at the extrema:
+	double hFirst = nodes[1] - nodes[0];
+	double hLast = nodes[nIntervals] - nodes[nIntervals-1];
+	const double* deltaFirst = cspline.deltas.data();
+	const double* deltaLast = cspline.deltas.data() + nIntervals*nWeights;
+	for(int i=0; i<nWeights; i++)
+	{	cspline.bArr(0, i)[0] += deltaFirst[i]*(4./hFirst); //bottom of band
+		cspline.bArr(nIntervals-1, i)[3] += deltaLast[i]*(4./hLast); //top of band
 	}
-	//Set results:
-	cspline.clear();
-	cspline.insert(combined.begin(), combined.end());
 	cspline.deltas.clear(); //deltas incorporated in above
 }
 
-static bool LsplineCmp(const TetrahedralDOS::LsplineElem& l1, const TetrahedralDOS::LsplineElem& l2) { return l1.first < l2.first; }
-
 //Convert cubic splines to integrated linear splines which handle discontinuities and singularities better:
 //The Cspline object must be coalesced before passing to this function
 TetrahedralDOS::Lspline TetrahedralDOS::convertLspline(const Cspline& cspline) const
 {	//Convert each cubic-spline interval into three linear spline ones:
-	int nIntervals = cspline.size();
+	size_t nIntervals = cspline.nIntervals();
 	Lspline lspline(1+3*nIntervals);
 	auto lIter = lspline.begin();
-	for(auto cIter = cspline.begin(); cIter != cspline.end(); cIter++) //loop over c-spline intervals
-	{	const double& e0 = cIter->first.eStart;
-		const double& e3 = cIter->first.eStop;
-		const CsplineElem& ce = cIter->second;
+	for(size_t j=0; j<nIntervals; j++) //loop over c-spline intervals
+	{	const double& e0 = cspline.nodes[j];
+		const double& e3 = cspline.nodes[j+1];
 		//Macro to add interval:
 		#define ADD_interval(e, wiCode) \
 		{	lIter->first = e; \
 			lIter->second.resize(nWeights); \
 			for(int i=0; i<nWeights; i++) \
+			{	const double* b = cspline.bArr(j, i); \
 				lIter->second[i] = (wiCode); \
+			} \
 			lIter++; \
 		}
 		//Add intervals:
@@ -427,48 +447,66 @@ TetrahedralDOS::Lspline TetrahedralDOS::convertLspline(const Cspline& cspline) c
 		const double a11 = 0.60;
 		const double a12 = 0.15;
 		const double a13 = 1./30;
-		if(cIter==cspline.begin()) ADD_interval(e0, ce.bArr[i][0]) //only need at start of spline
-		ADD_interval(e1, a10*ce.bArr[i][0] + a11*ce.bArr[i][1] + a12*ce.bArr[i][2] + a13*ce.bArr[i][3])
-		ADD_interval(e2, a10*ce.bArr[i][3] + a11*ce.bArr[i][2] + a12*ce.bArr[i][1] + a13*ce.bArr[i][0])
-		ADD_interval(e3, ce.bArr[i][3])
+		if(j==0) ADD_interval(e0, b[0]) //only need at start of spline
+		ADD_interval(e1, a10*b[0] + a11*b[1] + a12*b[2] + a13*b[3])
+		ADD_interval(e2, a10*b[3] + a11*b[2] + a12*b[1] + a13*b[0])
+		ADD_interval(e3, b[3])
+		#undef ADD_interval
 	}
 	assert(lIter == lspline.end());
 	return lspline;
 }
 
+//Sort and remove duplicates from a flat array:
+inline void sortUnique(std::vector<double>& v)
+{	std::sort(v.begin(), v.end());
+	v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+//Lookup value in sorted array v and return corresponding entry in array w
+inline double sortedLookup(const std::vector<double>& v, const std::vector<double>& w, double e)
+{	return w[std::lower_bound(v.begin(), v.end(), e) - v.begin()];
+}
+
+static bool LsplineCmp(const TetrahedralDOS::LsplineElem& l1, const TetrahedralDOS::LsplineElem& l2) { return l1.first < l2.first; }
+
 //Collect contributions from multiple linear splines (one for each band)
 TetrahedralDOS::Lspline TetrahedralDOS::mergeLsplines(const std::vector<Lspline>& lsplines) const
 {	//Collect list of energy nodes and interval boundaries:
-	std::set<double> eSet, leftBoundarySet, rightBoundarySet;
+	std::vector<double> eSet, leftBoundarySet, rightBoundarySet;
 	for(const Lspline& lspline: lsplines)
-	{	leftBoundarySet.insert(lspline.front().first);
-		rightBoundarySet.insert(lspline.back().first);
-		for(unsigned j=0; j<lspline.size(); j++)
-			eSet.insert(lspline[j].first);
+	{	leftBoundarySet.push_back(lspline.front().first);
+		rightBoundarySet.push_back(lspline.back().first);
+		for(const LsplineElem& l: lspline)
+			eSet.push_back(l.first);
 	}
-	std::set<double> boundarySet; //points that are in left or right boundaries, but not both
+	sortUnique(eSet);
+	sortUnique(leftBoundarySet);
+	sortUnique(rightBoundarySet);
+	std::vector<double> boundarySet; //points that are in left or right boundaries, but not both
 	std::set_symmetric_difference( //this eliminates edge-discontinuities in DOS from bands that meet at one energy
 		leftBoundarySet.begin(), leftBoundarySet.end(),
 		rightBoundarySet.begin(), rightBoundarySet.end(),
-		std::inserter(boundarySet, boundarySet.end()) );
+		std::back_inserter(boundarySet) );
+	auto isBoundary = [&](double e) { return std::binary_search(boundarySet.begin(), boundarySet.end(), e); };
 	//Compute merging weights for the left and right boundary weights:
-	std::map<double,double> startScale, stopScale;
+	std::vector<double> startScale, stopScale;
 	for(double e: leftBoundarySet)
-	{	if(boundarySet.count(e)) startScale[e] = 1.; //unmerged boundary
+	{	if(isBoundary(e)) startScale.push_back(1.); //unmerged boundary
 		else //merge weighted by interval length (preserves integral under trapezoidal rule):
-		{	auto eIter = eSet.find(e);
-			auto eIterMinus = eIter; eIterMinus--; double eMinus = *eIterMinus;
-			auto eIterPlus = eIter; eIterPlus++; double ePlus = *eIterPlus;
-			startScale[e] = (ePlus-e) / (ePlus-eMinus);
+		{	auto eIter = std::lower_bound(eSet.begin(), eSet.end(), e);
+			double eMinus = *(eIter-1);
+			double ePlus = *(eIter+1);
+			startScale.push_back((ePlus-e) / (ePlus-eMinus));
 		}
 	}
 	for(double e: rightBoundarySet)
-	{	if(boundarySet.count(e)) stopScale[e] = 1.; //unmerged boundary
+	{	if(isBoundary(e)) stopScale.push_back(1.); //unmerged boundary
 		else //merge weighted by interval length (preserves integral under trapezoidal rule):
-		{	auto eIter = eSet.find(e);
-			auto eIterMinus = eIter; eIterMinus--; double eMinus = *eIterMinus;
-			auto eIterPlus = eIter; eIterPlus++; double ePlus = *eIterPlus;
-			stopScale[e] = (e-eMinus) / (ePlus-eMinus);
+		{	auto eIter = std::lower_bound(eSet.begin(), eSet.end(), e);
+			double eMinus = *(eIter-1);
+			double ePlus = *(eIter+1);
+			stopScale.push_back((e-eMinus) / (ePlus-eMinus));
 		}
 	}
 	//Create output linear spline with duplicate nodes for each boundary node (to represent discontinuities)
@@ -476,50 +514,84 @@ TetrahedralDOS::Lspline TetrahedralDOS::mergeLsplines(const std::vector<Lspline>
 	Lspline::iterator cIter = combined.begin();
 	for(double e: eSet)
 	{	(cIter++)->first = e;
-		if(boundarySet.count(e))
+		if(isBoundary(e))
 			(cIter++)->first = e;
 	}
 	assert(cIter == combined.end());
-	//Collect contributions from each linear spline:
-	for(const Lspline& lspline: lsplines)
-	{	Lspline::iterator cIter = std::upper_bound(combined.begin(), combined.end(), lspline.front(), LsplineCmp);
-		cIter--; //Now this points to the last of the possibly duplicate entries for the starting energy
-		double eStart = lspline.front().first; //start energy of current input spline
+	//Collect contributions from each linear spline (threaded over output nodes):
+	threadLaunch(mergeLsplines_thread, combined.size(), this, &lsplines,
+		&leftBoundarySet, &startScale, &rightBoundarySet, &stopScale, &combined);
+	return combined;
+}
+
+void TetrahedralDOS::mergeLsplines_thread(size_t cStart, size_t cStop, const TetrahedralDOS* td, const std::vector<Lspline>* lsplines,
+	const std::vector<double>* leftBoundaries, const std::vector<double>* startScale,
+	const std::vector<double>* rightBoundaries, const std::vector<double>* stopScale, Lspline* combined)
+{	int nWeights = td->nWeights;
+	for(const Lspline& lspline: *lsplines)
+	{	double eStart = lspline.front().first; //start energy of current input spline
 		double eStop = lspline.back().first; //end energy of current input spline
-		Lspline::const_iterator leftIter = lspline.begin();
-		Lspline::const_iterator rightIter = leftIter + 1;
-		double e = eStart;
-		while(true)
-		{	double t = (e - leftIter->first) / (rightIter->first - leftIter->first);
-			double endpointScale = 1.;
-			if(e == eStart) endpointScale = startScale[eStart];
-			if(e == eStop) endpointScale = stopScale[eStop];
-			for(int i=0; i<nWeights; i++)
-				cIter->second[i] += endpointScale * ((1.-t) * leftIter->second[i] + t * rightIter->second[i]);
-			//Check for end of input spline:
-			if(e == eStop) break; //note this ends at the first of the possibly duplicate entries for the ending energy
-			//Advance and update input interval if required:
-			cIter++;
-			e = cIter->first;
-			if(e > rightIter->first)
+		//Range of output nodes: from the last of the possibly duplicate entries for the starting energy,
+		//to the first of the possibly duplicate entries for the ending energy
+		size_t cSplineStart = std::upper_bound(combined->begin(), combined->end(), lspline.front(), LsplineCmp) - combined->begin() - 1;
+		size_t cSplineStop = std::lower_bound(combined->begin(), combined->end(), lspline.back(), LsplineCmp) - combined->begin() + 1;
+		size_t cBegin = std::max(cSplineStart, cStart);
+		size_t cEnd = std::min(cSplineStop, cStop);
+		if(cBegin >= cEnd) continue; //no overlap with output nodes of this thread
+		//Initialize input interval:
+		Lspline::const_iterator rightIter = std::max(lspline.begin()+1,
+			std::lower_bound(lspline.begin(), lspline.end(), combined->at(cBegin), LsplineCmp));
+		Lspline::const_iterator leftIter = rightIter - 1;
+		for(size_t c=cBegin; c<cEnd; c++)
+		{	LsplineElem& out = combined->at(c);
+			double e = out.first;
+			if(e > rightIter->first) //advance input interval
 			{	leftIter++;
 				rightIter++;
 			}
+			double t = (e - leftIter->first) / (rightIter->first - leftIter->first);
+			double endpointScale = 1.;
+			if(e == eStart) endpointScale = sortedLookup(*leftBoundaries, *startScale, eStart);
+			if(e == eStop) endpointScale = sortedLookup(*rightBoundaries, *stopScale, eStop);
+			for(int i=0; i<nWeights; i++)
+				out.second[i] += endpointScale * ((1.-t) * leftIter->second[i] + t * rightIter->second[i]);
 		}
 	}
-	return combined;
 }
 
 //Generate the density of states for a given state offset:
-TetrahedralDOS::Lspline TetrahedralDOS::getDOS(int iSpin, double Etol) const
-{	std::vector<Lspline> lsplines(nBands);
+TetrahedralDOS::Lspline TetrahedralDOS::getDOS(int iSpin, double Etol, const MPIUtil* mpiUtil) const
+{	//Divide tetrahedra over processes (if any), and process them in blocks of chunks (one per thread):
+	size_t iTetStart = 0, iTetStop = tetrahedra.size();
+	if(mpiUtil) TaskDivision(tetrahedra.size(), mpiUtil).myRange(iTetStart, iTetStop);
+	const size_t chunkSize = 4096; //tetrahedra per chunk
+	const size_t nChunks = nProcsAvailable;
+	const size_t blockSize = chunkSize * nChunks;
+	std::vector<CsplinePieces> pieces(nChunks); //piece buffers, reused across blocks and bands
+	
+	std::vector<Lspline> lsplines(nBands);
 	for(int iBand=0; iBand<nBands; iBand++)
-	{	Cspline wdos;
-		for(const Tetrahedron& t: tetrahedra)
-			accumTetrahedron(t, iBand, iSpin, wdos);
-		if(wdos.size()==0 && wdos.deltas.size()==1) // band is a single delta function
-		{	double eDelta = wdos.deltas.begin()->first;
-			const std::vector<double>& wDelta = wdos.deltas.begin()->second;
+	{	//Nodes of the coalesced spline are the distinct vertex energies of this band:
+		Cspline wdos;
+		wdos.nWeights = nWeights;
+		wdos.nodes.assign(eigs.begin() + nStates*iBand + nReduced*iSpin, eigs.begin() + nStates*iBand + nReduced*(iSpin+1));
+		sortUnique(wdos.nodes);
+		wdos.b.assign(4*nWeights*wdos.nIntervals(), 0.);
+		wdos.deltas.assign(nWeights*wdos.nodes.size(), 0.);
+		//Accumulate and coalesce tetrahedron contributions block by block:
+		for(size_t iBlockStart=iTetStart; iBlockStart<iTetStop; iBlockStart+=blockSize)
+		{	size_t iBlockStop = std::min(iBlockStart+blockSize, iTetStop);
+			threadLaunch(accumTetrahedra_thread, nChunks, (const TetrahedralDOS*)this, iBlockStart, iBlockStop, chunkSize, iBand, iSpin, pieces.data());
+			threadLaunch(std::min(nProcsAvailable, int(wdos.nodes.size())), coalesceIntervals_thread, wdos.nodes.size(), (const TetrahedralDOS*)this, (const std::vector<CsplinePieces>*)&pieces, &wdos);
+		}
+		if(mpiUtil)
+		{	mpiUtil->allReduceData(wdos.b, MPIUtil::ReduceSum);
+			mpiUtil->allReduceData(wdos.deltas, MPIUtil::ReduceSum);
+		}
+		//Convert to linear spline:
+		if(wdos.nodes.size()==1) // band is a single delta function
+		{	double eDelta = wdos.nodes[0];
+			const double* wDelta = wdos.deltas.data();
 			lsplines[iBand].resize(3, std::make_pair(eDelta, std::vector<double>(nWeights, 0.)));
 			lsplines[iBand][0].first = eDelta-0.5*Etol;
 			lsplines[iBand][2].first = eDelta+0.5*Etol;
@@ -527,7 +599,7 @@ TetrahedralDOS::Lspline TetrahedralDOS::getDOS(int iSpin, double Etol) const
 				lsplines[iBand][1].second[i] = wDelta[i] * (2./Etol);
 		}
 		else
-		{	coalesceIntervals(wdos);
+		{	incorporateDeltas(wdos);
 			lsplines[iBand] = convertLspline(wdos);
 		}
 	}
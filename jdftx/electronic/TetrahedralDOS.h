@@ -59,9 +59,14 @@ public:
 	typedef std::pair<double, std::vector<double> > LsplineElem; //!< Single rnergy and DOS values with all weights at that energy
 	typedef std::vector<LsplineElem> Lspline; //!< Set of all energy and DOS values as a linear spline
 
+	//! Broadcast eigenvalues and weights from process root of mpiUtil to all its processes
+	void bcast(const class MPIUtil* mpiUtil, int root=0);
+	
 	//! Generate the density of states for a given spin channel
 	//! Etol sets the width of the delta-function DOS of bands that are completely flat (potentially welded within Etol)
-	Lspline getDOS(int iSpin, double Etol) const;
+	//! If mpiUtil is provided, the tetrahedra are divided over its processes, which must all call this function
+	//! with identical eigenvalues and weights (see bcast), and the result is available on all of them.
+	Lspline getDOS(int iSpin, double Etol, const class MPIUtil* mpiUtil=0) const;
 
 	//! Apply gaussian smoothing of width Esigma
 	Lspline gaussSmooth(const Lspline& in, double Esigma) const;
@@ -81,18 +86,32 @@ private:
 	
 	
 	//! Accumulate contribution from one tetrahedron (exactly a cubic spline for linear interpolation)
-	//! to the weighted DOS for all weight functions (from a single band)
-	void accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin, struct Cspline& wdos) const;
-
-	//! Coalesce overlapping splines: convert an arbitrary set of spline pieces into a regular ordered piecewise spline
-	void coalesceIntervals(struct Cspline& cspline) const;
-
+	//! to the weighted DOS for all weight functions (from a single band), appending pieces to a flat buffer
+	void accumTetrahedron(const Tetrahedron& t, int iBand, int iSpin, struct CsplinePieces& pieces) const;
+	
+	//! Accumulate tetrahedra [iTetStart,iTetStop) in chunks of chunkSize, each chunk into its own piece buffer (thread function)
+	static void accumTetrahedra_thread(size_t iChunkStart, size_t iChunkStop, const TetrahedralDOS* td,
+		size_t iTetStart, size_t iTetStop, size_t chunkSize, int iBand, int iSpin, struct CsplinePieces* pieces);
+	
+	//! Coalesce overlapping splines: add arbitrary spline pieces onto the regular ordered piecewise spline
+	//! defined on the sorted nodes of cspline, restricted to nodes [jStart,jStop) (thread function)
+	static void coalesceIntervals_thread(size_t jStart, size_t jStop, const TetrahedralDOS* td,
+		const std::vector<struct CsplinePieces>* pieces, struct Cspline* cspline);
+	
+	//! Fix interior discontinuities of a coalesced spline and incorporate its delta functions
+	void incorporateDeltas(struct Cspline& cspline) const;
+	
 	//! Convert cubic splines to integrated linear splines which handle discontinuities and singularities better.
-	//! The Cspline object must be coalesced before passing to this function
+	//! The Cspline object must be coalesced with deltas incorporated before passing to this function
 	Lspline convertLspline(const struct Cspline& cspline) const;
 
 	//! Collect contributions from multiple linear splines (one for each band)
 	Lspline mergeLsplines(const std::vector<Lspline>& lsplines) const;
+	
+	//! Add contributions of lsplines to output nodes [cStart,cStop) of combined (thread function)
+	static void mergeLsplines_thread(size_t cStart, size_t cStop, const TetrahedralDOS* td, const std::vector<Lspline>* lsplines,
+		const std::vector<double>* leftBoundaries, const std::vector<double>* startScale,
+		const std::vector<double>* rightBoundaries, const std::vector<double>* stopScale, Lspline* combined);
 };
 
 #endif //JDFTX_ELECTRONIC_TETRAHEDRALDOS_H
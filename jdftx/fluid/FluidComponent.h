@@ -106,6 +106,7 @@ struct FluidComponent
 		Fourier
 	}
 	translationMode; //!< type of translation operator used for sampling rigid molecule geometry
+	double orientationCacheMB; //!< memory budget per process (in MB) for orientation-loop thread accumulators and for caching orientation densities between free energy and gradient passes (default 0)
 	
 	//Bulk solvent properties (used by various PCM's):
 	double epsBulk; //!< bulk dielectric constant
@@ -205,7 +205,7 @@ void FluidMixture::initState(double scale, double Elo, double Ehi)
 		for(unsigned ic=0; ic<component.size(); ic++)
 		{	const FluidComponent& c = *(component[ic]);
 			ScalarFieldArray N(c.molecule.sites.size()); vector3<> P0c;
-			c.idealGas->getDensities(&state[c.offsetIndep], &N[0], P0c);
+			c.idealGas->getDensities(&state[c.offsetIndep], &N[0], P0c, false);
 			Prot0 += P0c;
 			for(unsigned i=0; i<c.molecule.sites.size(); i++)
 			{	const Molecule::Site& s = *(c.molecule.sites[i]);
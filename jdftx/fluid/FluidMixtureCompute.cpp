@@ -274,80 +274,33 @@ double FluidMixture::operator()(const ScalarFieldArray& indep, ScalarFieldArray&
 	}
 	
 	//--------- Hard sphere mixture and bonding -------------
-	{	//Compute the FMT weighted densities:
-		ScalarFieldTilde n0tilde, n1tilde, n2tilde, n3tilde, n1vTilde, n2mTilde;
-		std::vector<ScalarField> n0mol(component.size(), 0); //partial n0 for molecules that need bonding corrections
-		std::vector<int> n0mult(component.size(), 0); //number of sites which contribute to n0 for each molecule
-		std::vector<std::map<double,int> > bond(component.size()); //sets of bonds for each molecule
-		bool bondsPresent = false; //whether bonds are present for any molecule
+	{	//Collect hard sphere sites and bonds:
+		std::vector<FMTsite> sites;
+		std::vector<FMTbond> bonds;
+		int nMol = 0; //number of molecules that need bonding corrections
 		for(unsigned ic=0; ic<component.size(); ic++)
 		{	const FluidComponent& c = *component[ic];
-			bond[ic] = c.molecule.getBonds();
-			ScalarFieldTilde n0molTilde;
+			std::map<double,int> bond = c.molecule.getBonds(); //set of bonds for this molecule
+			int iMol = bond.size() ? nMol++ : -1;
+			int n0mult = 0; //number of sites which contribute to n0 for this molecule
 			for(unsigned i=0; i<c.molecule.sites.size(); i++)
 			{	const Molecule::Site& s = *(c.molecule.sites[i]);
 				if(s.Rhs)
-				{	const ScalarFieldTilde& Nsite = Ntilde[c.offsetDensity+i];
-					n0mult[ic] += s.positions.size();
-					n0molTilde += s.w0  * Nsite;
-					n1tilde    += s.w1  * Nsite;
-					n2tilde    += s.w2  * Nsite;
-					n3tilde    += s.w3  * Nsite;
-					n1vTilde   += s.w1v * Nsite;
-					n2mTilde   += s.w2m * Nsite;
+				{	FMTsite site = { &s.w0, &s.w1, &s.w2, &s.w3, &s.w1v, &s.w2m, iMol, &Ntilde[c.offsetDensity+i], &Phi_Ntilde[c.offsetDensity+i] };
+					sites.push_back(site);
+					n0mult += s.positions.size();
 				}
 			}
-			if(n0molTilde) n0tilde += n0molTilde;
-			if(bond[ic].size())
-			{	n0mol[ic] = I(n0molTilde);
-				bondsPresent = true;
+			for(const auto& b: bond)
+			{	FMTbond fmtBond = { iMol, b.first, b.second*1./n0mult };
+				bonds.push_back(fmtBond);
 			}
 		}
-		if(n0tilde) //at least one sphere in the mixture
-		{	ScalarField n0 = I(n0tilde); n0tilde=0;
-			ScalarField n1 = I(n1tilde); n1tilde=0;
-			ScalarField n2 = I(n2tilde); n2tilde=0;
-			ScalarField Phi_n0, Phi_n1, Phi_n2; ScalarFieldTilde Phi_n3tilde, Phi_n1vTilde, Phi_n2mTilde;
-			//Compute the sphere mixture free energy:
-			Phi["MixedFMT"] += T * PhiFMT(n0, n1, n2, n3tilde, n1vTilde, n2mTilde,
-				Phi_n0, Phi_n1, Phi_n2, Phi_n3tilde, Phi_n1vTilde, Phi_n2mTilde);
-			//Bonding corrections if required
-			if(bondsPresent)
-			{	for(unsigned ic=0; ic<component.size(); ic++)
-				{	const FluidComponent& c = *component[ic];
-					ScalarField Phi_n0mol;
-					for(const auto& b: bond[ic])
-						Phi["Bonding"] += T * PhiBond(b.first, b.second*1./n0mult[ic],
-							n0mol[ic], n2, n3tilde, Phi_n0mol, Phi_n2, Phi_n3tilde);
-					if(Phi_n0mol)
-					{	//Propagate gradient w.r.t n0mol[ic] to the site densities:
-						ScalarFieldTilde Phi_n0molTilde = Idag(Phi_n0mol);
-						for(unsigned i=0; i<c.molecule.sites.size(); i++)
-						{	const Molecule::Site& s = *(c.molecule.sites[i]);
-							if(s.Rhs)
-								Phi_Ntilde[c.offsetDensity+i] += T * (s.w0  * Phi_n0molTilde);
-						}
-					}
-				}
-			}
-			//Accumulate gradients w.r.t weighted densities to site densities:
-			ScalarFieldTilde Phi_n0tilde = Idag(Phi_n0); Phi_n0=0;
-			ScalarFieldTilde Phi_n1tilde = Idag(Phi_n1); Phi_n1=0;
-			ScalarFieldTilde Phi_n2tilde = Idag(Phi_n2); Phi_n2=0;
-			for(const FluidComponent* c: component)
-			{	for(unsigned i=0; i<c->molecule.sites.size(); i++)
-				{	const Molecule::Site& s = *(c->molecule.sites[i]);
-					if(s.Rhs)
-					{	ScalarFieldTilde& Phi_Nsite = Phi_Ntilde[c->offsetDensity+i];
-						Phi_Nsite += T * (s.w0  * Phi_n0tilde);
-						Phi_Nsite += T * (s.w1  * Phi_n1tilde);
-						Phi_Nsite += T * (s.w2  * Phi_n2tilde);
-						Phi_Nsite += T * (s.w3  * Phi_n3tilde);
-						Phi_Nsite += T * (s.w1v * Phi_n1vTilde);
-						Phi_Nsite += T * (s.w2m * Phi_n2mTilde);
-					}
-				}
-			}
+		if(sites.size()) //at least one sphere in the mixture
+		{	//Compute the sphere mixture free energy, bonding corrections and gradients (all weighted densities fused):
+			double PhiBonding = 0.;
+			Phi["MixedFMT"] += T * PhiFMTmixture(sites, nMol, bonds, T, PhiBonding);
+			if(bonds.size()) Phi["Bonding"] += T * PhiBonding;
 		}
 	}
 
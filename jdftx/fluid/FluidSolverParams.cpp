@@ -24,7 +24,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 FluidSolverParams::FluidSolverParams()
 : T(298*Kelvin), P(1.01325*Bar), epsBulkOverride(0.), epsInfOverride(0.), verboseLog(false), solveFrequency(FluidFreqDefault),
 components(components_), solvents(solvents_), cations(cations_), anions(anions_),
-vdwScale(0.75), pCavity(0.), lMax(3), cavityScale(1.), ionSpacing(0.),
+vdwScale(0.75), pCavity(0.), lMax(3), multigridLevels(0), cavityScale(1.), ionSpacing(0.),
 zMask0(0.), zMaskH(0.), zMaskIonH(0.), zMaskSigma(0.5),
 linearDielectric(false), linearScreening(false), nonlinearSCF(false), screenOverride(0.)
 {
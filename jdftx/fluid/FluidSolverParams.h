@@ -132,6 +132,9 @@ struct FluidSolverParams
 	//For SaLSA alone:
 	int lMax;
 	
+	//For LinearPCM (including the inner solves of NonlinearPCM's SCF) and SaLSA:
+	int multigridLevels; //!< number of coarse levels in the multigrid preconditioner (0 => diagonal preconditioner alone)
+	
 	//For soft sphere model alone:
 	double getAtomicRadius(const class SpeciesInfo& sp) const; //!< get the solute atom radius for the soft-sphere solvation model given species
 	double cavityScale; //!< radius scale factor
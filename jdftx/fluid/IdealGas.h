@@ -50,7 +50,9 @@ public:
 	virtual void initState(const ScalarField* Vex, ScalarField* indep, double scale, double Elo=-DBL_MAX, double Ehi=+DBL_MAX) const=0;
 
 	//! Given the independent variables indep, compute the site densities N and G=0 component of polarization density P
-	virtual void getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0) const=0;
+	//! With gradientFollows=true, intermediates may be cached for the next convertGradients(), which must then be
+	//! called with the same, unmodified indep; set gradientFollows=false if convertGradients() will not be called for this indep
+	virtual void getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0, bool gradientFollows=true) const=0;
 
 	//! Return the ideal gas free energy PhiNI = T Int N - T S + (V-mu).N (where S is implementation dependent)
 	//! and accumulate the gradients w.r.t the site densities
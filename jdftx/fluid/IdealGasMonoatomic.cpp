@@ -37,7 +37,7 @@ void IdealGasMonoatomic::initState(const ScalarField* Vex, ScalarField* psi, dou
 	psi[0] = (-scale/T)*Veff;
 }
 
-void IdealGasMonoatomic::getDensities(const ScalarField* psi, ScalarField* N, vector3<>& P0) const
+void IdealGasMonoatomic::getDensities(const ScalarField* psi, ScalarField* N, vector3<>& P0, bool gradientFollows) const
 {	N[0] = Nbulk * exp(psi[0]);
 	P0 = vector3<>();
 }
@@ -33,7 +33,7 @@ public:
 	IdealGasMonoatomic(const FluidMixture*, const FluidComponent*);
 
 	void initState(const ScalarField* Vex, ScalarField* psi, double scale, double Elo, double Ehi) const;
-	void getDensities(const ScalarField* psi, ScalarField* N, vector3<>& P0) const;
+	void getDensities(const ScalarField* psi, ScalarField* N, vector3<>& P0, bool gradientFollows=true) const;
 	double compute(const ScalarField* psi, const ScalarField* N, ScalarField* Phi_N, const double Nscale, double& Phi_Nscale) const;
 	void convertGradients(const ScalarField* psi, const ScalarField* N, const ScalarField* Phi_N, const vector3<>&  Phi_P0, ScalarField* Phi_psi, const double Nscale) const;
 };
@@ -18,12 +18,26 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 -------------------------------------------------------------------*/
 
 #include <fluid/IdealGasPomega.h>
+#include <fluid/FluidComponent.h>
 #include <fluid/Euler.h>
+#include <core/Thread.h>
 
 IdealGasPomega::IdealGasPomega(const FluidMixture* fluidMixture, const FluidComponent* comp, const SO3quad& quad, const TranslationOperator& trans, unsigned nIndepOverride)
 : IdealGas(nIndepOverride ? nIndepOverride : quad.nOrientations(), fluidMixture, comp), quad(quad), trans(trans), pMol(molecule.getDipole())
 {
 	TaskDivision(quad.nOrientations(), mpiWorld).myRange(oStart, oStop);
+	int nLocal = oStop-oStart;
+	double bytesBudget = comp->orientationCacheMB * 1024*1024;
+	//Determine how many threads fit in the budget; each thread beyond the first accumulates
+	//N (and P) in getDensities(), and Phi_indep in convertGradients() for compressed representations
+	//(Pomega itself has a separate indep per orientation, so threads never share those):
+	int nAccumulators = std::max(int(molecule.sites.size()) + (pMol.length_squared() ? 3 : 0), nIndepOverride ? nIndep : 0);
+	double bytesPerThread = nAccumulators * gInfo.nr * sizeof(double);
+	nThreadsMax = isGpuEnabled() ? 1 : std::max(1, std::min(std::min(nProcsAvailable, nLocal), 1 + int(floor(bytesBudget / bytesPerThread))));
+	bytesBudget -= (nThreadsMax-1) * bytesPerThread;
+	//Determine how many orientations can be cached in the rest (logPomega_o and N_o for each):
+	double bytesPerOrientation = 2. * gInfo.nr * sizeof(double);
+	nCachedMax = std::min(nLocal, int(floor(bytesBudget / bytesPerOrientation)));
 }
 
 string IdealGasPomega::representationName() const
@@ -54,10 +68,14 @@ void IdealGasPomega::initState(const ScalarField* Vex, ScalarField* indep, doubl
 	for(int o=oStart; o<oStop; o++)
 	{	matrix3<> rot = matrixFromEuler(quad.euler(o));
 		ScalarField Emolecule;
-		//Sum the potentials collected over sites for each orientation:
+		//Sum the potentials collected over sites for each orientation (in one batched pass):
+		std::vector< vector3<> > t; std::vector<const ScalarField*> x;
 		for(unsigned i=0; i<molecule.sites.size(); i++)
 			for(vector3<> pos: molecule.sites[i]->positions)
-				trans.taxpy(-(rot*pos), 1., Veff[i], Emolecule);
+			{	t.push_back(-(rot*pos));
+				x.push_back(&Veff[i]);
+			}
+		trans.taxpyBatched(t, std::vector<double>(t.size(), 1.), x, Emolecule);
 		//Accumulate stats and cap:
 		Emean += quad.weight(o) * sum(Emolecule)/gInfo.nr;
 		double Emin_o, Emax_o;
@@ -80,31 +98,43 @@ void IdealGasPomega::initState(const ScalarField* Vex, ScalarField* indep, doubl
 		   representationName().c_str(), molecule.name.c_str(), Emin, Emax, Emean);
 }
 
-void IdealGasPomega::getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0) const
+void IdealGasPomega::getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0, bool gradientFollows) const
 {	for(unsigned i=0; i<molecule.sites.size(); i++) N[i]=0;
-	double& S = ((IdealGasPomega*)this)->S;
+	IdealGasPomega* cache = ((IdealGasPomega*)this);
+	double& S = cache->S;
 	S=0.0;
 	VectorField P;
-	//Loop over orientations:
-	for(int o=oStart; o<oStop; o++)
-	{	matrix3<> rot = matrixFromEuler(quad.euler(o));
-		ScalarField logPomega_o; getDensities_o(o, rot, indep,logPomega_o);
-		ScalarField N_o = (quad.weight(o) * Nbulk) * exp(logPomega_o); //contribution form this orientation
-		//Accumulate N_o to each site density with appropriate translations:
-		for(unsigned i=0; i<molecule.sites.size(); i++)
-			for(vector3<> pos: molecule.sites[i]->positions)
-				trans.taxpy(rot*pos, 1., N_o, N[i]);
-		//Accumulate contributions to the entropy:
-		S += gInfo.dV*dot(N_o, logPomega_o);
-		//Accumulate the polarization density:
-		if(pMol.length_squared()) P += (rot * pMol) * N_o;
+	//Prepare cache (only if a gradient evaluation will follow):
+	int nCached = gradientFollows ? nCachedMax : 0;
+	cache->logPomegaCache.assign(nCached, ScalarField());
+	cache->NoCache.assign(nCached, ScalarField());
+	cache->cacheIndep.clear();
+	//Loop over orientations (split over threads, with separate accumulators per thread):
+	int nThreads = nOrientationThreads();
+	std::vector<ScalarFieldArray> Nthread(nThreads, ScalarFieldArray(molecule.sites.size()));
+	std::vector<VectorField> Pthread(nThreads);
+	std::vector<double> Sthread(nThreads, 0.);
+	threadLaunch(nThreads, getDensities_thread, 0, cache, indep, Nthread.data(), Pthread.data(), Sthread.data());
+	for(int t=0; t<nThreads; t++) //collect in fixed order for reproducibility (first thread's accumulators reused as output)
+	{	for(unsigned i=0; i<molecule.sites.size(); i++)
+		{	if(t) N[i] += Nthread[t][i];
+			else N[i] = Nthread[t][i];
+		}
+		if(pMol.length_squared())
+		{	if(t) P += Pthread[t];
+			else P = Pthread[t];
+		}
+		S += Sthread[t];
 	}
+	Nthread.clear(); Pthread.clear();
+	if(nCached)
+		for(int k=0; k<nIndep; k++)
+			cache->cacheIndep.push_back(indep[k].get());
 	//MPI collect:
 	for(unsigned i=0; i<molecule.sites.size(); i++) { nullToZero(N[i],gInfo); N[i]->allReduceData(mpiWorld, MPIUtil::ReduceSum); }
 	mpiWorld->allReduce(S, MPIUtil::ReduceSum);
 	if(pMol.length_squared()) for(int k=0; k<3; k++) { nullToZero(P[k],gInfo); P[k]->allReduceData(mpiWorld, MPIUtil::ReduceSum); }
 	//Compute and cache dipole correlation correction:
-	IdealGasPomega* cache = ((IdealGasPomega*)this);
 	if(pMol.length_squared())
 	{	P0 = sumComponents(P) / gInfo.nr;
 		cache->Ecorr_P = I(molecule.mfKernel*(molecule.mfKernel*(corrPrefac*J(P))));
@@ -137,23 +167,107 @@ double IdealGasPomega::compute(const ScalarField* indep, const ScalarField* N, S
 
 void IdealGasPomega::convertGradients(const ScalarField* indep, const ScalarField* N, const ScalarField* Phi_N, const vector3<>& Phi_P0, ScalarField* Phi_indep, const double Nscale) const
 {	for(int k=0; k<nIndep; k++) Phi_indep[k]=0;
-	//Loop over orientations:
-	for(int o=oStart; o<oStop; o++)
-	{	matrix3<> rot = matrixFromEuler(quad.euler(o));
-		ScalarField logPomega_o; getDensities_o(o, rot, indep, logPomega_o);
-		ScalarField N_o = (quad.weight(o) * Nbulk * Nscale) * exp(logPomega_o);
+	//Check that cached orientation densities were computed for this indep
+	//(getDensities() with gradientFollows=true guarantees that indep is unmodified until this call):
+	IdealGasPomega* cache = ((IdealGasPomega*)this);
+	bool cacheValid = (int(cacheIndep.size()) == nIndep);
+	for(int k=0; k<nIndep && cacheValid; k++)
+		if(cacheIndep[k] != indep[k].get())
+			cacheValid = false;
+	if(!cacheValid)
+	{	cache->logPomegaCache.clear(); //recompute all orientations
+		cache->NoCache.clear();
+	}
+	//Loop over orientations (split over threads, with separate accumulators per thread):
+	int nThreads = nOrientationThreads();
+	std::vector<ScalarFieldArray> Phi_indepThread(nThreads, ScalarFieldArray(nIndep));
+	threadLaunch(nThreads, convertGradients_thread, 0, this, indep, Phi_N, &Phi_P0, Phi_indepThread.data(), Nscale);
+	for(int t=0; t<nThreads; t++) //collect in fixed order for reproducibility (first thread's accumulators reused as output)
+		for(int k=0; k<nIndep; k++)
+		{	if(t) Phi_indep[k] += Phi_indepThread[t][k];
+			else Phi_indep[k] = Phi_indepThread[t][k];
+		}
+	Phi_indepThread.clear();
+	//Release cache (valid only for one gradient evaluation):
+	cache->logPomegaCache.clear();
+	cache->NoCache.clear();
+	cache->cacheIndep.clear();
+	//MPI collect:
+	for(int k=0; k<nIndep; k++) { nullToZero(Phi_indep[k],gInfo); Phi_indep[k]->allReduceData(mpiWorld, MPIUtil::ReduceSum); }
+}
+
+int IdealGasPomega::nOrientationThreads() const
+{	if(isGpuEnabled() || !shouldThreadOperators()) return 1;
+	return nThreadsMax;
+}
+
+void IdealGasPomega::getDensities_sub(int iThread, int nThreads, const ScalarField* indep, ScalarFieldArray* Nthread, VectorField* Pthread, double* Sthread)
+{	ScalarFieldArray& N = Nthread[iThread];
+	VectorField& P = Pthread[iThread];
+	double& S = Sthread[iThread];
+	int nLocal = oStop-oStart;
+	for(int iLocal=(iThread*nLocal)/nThreads; iLocal<((iThread+1)*nLocal)/nThreads; iLocal++)
+	{	int o = oStart + iLocal;
+		matrix3<> rot = matrixFromEuler(quad.euler(o));
+		ScalarField logPomega_o; getDensities_o(o, rot, indep,logPomega_o);
+		ScalarField N_o = (quad.weight(o) * Nbulk) * exp(logPomega_o); //contribution form this orientation
+		//Accumulate N_o to each site density with appropriate translations (in one batched pass):
+		std::vector< vector3<> > t; std::vector<ScalarField*> y;
+		for(unsigned i=0; i<molecule.sites.size(); i++)
+			for(vector3<> pos: molecule.sites[i]->positions)
+			{	t.push_back(rot*pos);
+				y.push_back(&N[i]);
+			}
+		trans.taxpyBatched(t, std::vector<double>(t.size(), 1.), N_o, y);
+		//Accumulate contributions to the entropy:
+		S += gInfo.dV*dot(N_o, logPomega_o);
+		//Accumulate the polarization density:
+		if(pMol.length_squared()) P += (rot * pMol) * N_o;
+		//Cache for convertGradients:
+		if(iLocal < int(NoCache.size()))
+		{	logPomegaCache[iLocal] = logPomega_o;
+			NoCache[iLocal] = N_o;
+		}
+	}
+}
+
+void IdealGasPomega::convertGradients_sub(int iThread, int nThreads, const ScalarField* indep, const ScalarField* Phi_N, const vector3<>* Phi_P0, ScalarFieldArray* Phi_indepThread, double Nscale) const
+{	ScalarField* Phi_indep = Phi_indepThread[iThread].data();
+	int nLocal = oStop-oStart;
+	for(int iLocal=(iThread*nLocal)/nThreads; iLocal<((iThread+1)*nLocal)/nThreads; iLocal++)
+	{	int o = oStart + iLocal;
+		matrix3<> rot = matrixFromEuler(quad.euler(o));
+		ScalarField logPomega_o, N_o;
+		if(iLocal < int(NoCache.size()) && NoCache[iLocal])
+		{	logPomega_o = logPomegaCache[iLocal];
+			N_o = Nscale * NoCache[iLocal];
+		}
+		else //recompute (not cached due to memory budget)
+		{	getDensities_o(o, rot, indep, logPomega_o);
+			N_o = (quad.weight(o) * Nbulk * Nscale) * exp(logPomega_o);
+		}
 		ScalarField Phi_N_o; //gradient w.r.t N_o (as calculated in getDensities)
-		//Collect the contributions from each Phi_N in Phi_N_o
+		//Collect the contributions from each Phi_N in Phi_N_o (in one batched pass):
+		std::vector< vector3<> > t; std::vector<const ScalarField*> x;
 		for(unsigned i=0; i<molecule.sites.size(); i++)
 			for(vector3<> pos: molecule.sites[i]->positions)
-				trans.taxpy(-rot*pos, 1., Phi_N[i], Phi_N_o);
+			{	t.push_back(-rot*pos);
+				x.push_back(&Phi_N[i]);
+			}
+		trans.taxpyBatched(t, std::vector<double>(t.size(), 1.), x, Phi_N_o);
 		//Collect the contributions from the entropy:
 		Phi_N_o += T*logPomega_o;
 		//Collect the contribution from Phi_P0 and Ecorr_P:
-		if(pMol.length_squared()) Phi_N_o += dot(rot * pMol, Nscale*Ecorr_P) + dot(rot * pMol, Phi_P0);
+		if(pMol.length_squared()) Phi_N_o += dot(rot * pMol, Nscale*Ecorr_P) + dot(rot * pMol, *Phi_P0);
 		//Propagate Phi_N_o to Phi_logPomega_o and then to Phi_indep:
 		convertGradients_o(o, rot, N_o*Phi_N_o, Phi_indep);
 	}
-	for(int k=0; k<nIndep; k++) { nullToZero(Phi_indep[k],gInfo); Phi_indep[k]->allReduceData(mpiWorld, MPIUtil::ReduceSum); }
 }
 
+void IdealGasPomega::getDensities_thread(int iThread, int nThreads, IdealGasPomega* igp, const ScalarField* indep, ScalarFieldArray* N, VectorField* P, double* S)
+{	igp->getDensities_sub(iThread, nThreads, indep, N, P, S);
+}
+
+void IdealGasPomega::convertGradients_thread(int iThread, int nThreads, const IdealGasPomega* igp, const ScalarField* indep, const ScalarField* Phi_N, const vector3<>* Phi_P0, ScalarFieldArray* Phi_indep, double Nscale)
+{	igp->convertGradients_sub(iThread, nThreads, indep, Phi_N, Phi_P0, Phi_indep, Nscale);
+}
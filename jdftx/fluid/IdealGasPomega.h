@@ -38,7 +38,7 @@ public:
 	IdealGasPomega(const FluidMixture*, const FluidComponent*, const SO3quad& quad, const TranslationOperator& trans, unsigned nIndepOverride=0);
 
 	void initState(const ScalarField* Vex, ScalarField* indep, double scale, double Elo, double Ehi) const;
-	void getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0) const;
+	void getDensities(const ScalarField* indep, ScalarField* N, vector3<>& P0, bool gradientFollows=true) const;
 	double compute(const ScalarField* indep, const ScalarField* N, ScalarField* Phi_N, const double Nscale, double& Phi_Nscale) const;
 	void convertGradients(const ScalarField* indep, const ScalarField* N, const ScalarField* Phi_N, const vector3<>& Phi_P0, ScalarField* Phi_indep, const double Nscale) const;
 
@@ -58,6 +58,20 @@ protected:
 private:
 	double S; //!< cache the entropy, because it is most efficiently computed during getDensities()
 	double Ecorr; VectorField Ecorr_P; //!< cache the correlation correction and its derivatives, since they are most efficiently computed during getDensities()
+	
+	//Thread accumulators and orientation-resolved quantities cached by getDensities() for reuse in convertGradients(),
+	//both within the memory budget FluidComponent::orientationCacheMB:
+	int nThreadsMax; //!< number of threads whose accumulators fit in the budget
+	int nCachedMax; //!< number of local orientations that fit in the remaining budget
+	std::vector<ScalarField> logPomegaCache, NoCache; //!< logPomega_o and N_o (without Nscale) for the first nCachedMax local orientations
+	std::vector<const ScalarFieldData*> cacheIndep; //!< indep for which the cache was built by the preceding getDensities() (empty if none)
+	
+	int nOrientationThreads() const; //!< number of threads to split the local orientations over
+	//Process local orientations of thread iThread out of nThreads, and accumulate into the thread's output:
+	void getDensities_sub(int iThread, int nThreads, const ScalarField* indep, ScalarFieldArray* N, VectorField* P, double* S);
+	void convertGradients_sub(int iThread, int nThreads, const ScalarField* indep, const ScalarField* Phi_N, const vector3<>* Phi_P0, ScalarFieldArray* Phi_indep, double Nscale) const;
+	static void getDensities_thread(int iThread, int nThreads, IdealGasPomega* igp, const ScalarField* indep, ScalarFieldArray* N, VectorField* P, double* S);
+	static void convertGradients_thread(int iThread, int nThreads, const IdealGasPomega* igp, const ScalarField* indep, const ScalarField* Phi_N, const vector3<>* Phi_P0, ScalarFieldArray* Phi_indep, double Nscale);
 };
 
 //! @}
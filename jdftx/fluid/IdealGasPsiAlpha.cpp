@@ -47,13 +47,21 @@ void IdealGasPsiAlpha::initState(const ScalarField* Vex, ScalarField* psi, doubl
 }
 
 void IdealGasPsiAlpha::getDensities_o(int o, const matrix3<>& rot, const ScalarField* psi, ScalarField& logPomega_o) const
-{	for(unsigned i=0; i<molecule.sites.size(); i++)
+{	std::vector< vector3<> > t; std::vector<const ScalarField*> x;
+	for(unsigned i=0; i<molecule.sites.size(); i++)
 		for(vector3<> pos: molecule.sites[i]->positions)
-			trans.taxpy(-rot*pos, 1., psi[i], logPomega_o);
+		{	t.push_back(-rot*pos);
+			x.push_back(&psi[i]);
+		}
+	trans.taxpyBatched(t, std::vector<double>(t.size(), 1.), x, logPomega_o);
 }
 
 void IdealGasPsiAlpha::convertGradients_o(int o, const matrix3<>& rot, const ScalarField& Phi_logPomega_o, ScalarField* Phi_psi) const
-{	for(unsigned i=0; i<molecule.sites.size(); i++)
+{	std::vector< vector3<> > t; std::vector<ScalarField*> y;
+	for(unsigned i=0; i<molecule.sites.size(); i++)
 		for(vector3<> pos: molecule.sites[i]->positions)
-			trans.taxpy(rot*pos, 1., Phi_logPomega_o, Phi_psi[i]);
+		{	t.push_back(rot*pos);
+			y.push_back(&Phi_psi[i]);
+		}
+	trans.taxpyBatched(t, std::vector<double>(t.size(), 1.), Phi_logPomega_o, y);
 }
@@ -20,6 +20,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <electronic/Everything.h>
 #include <fluid/LinearPCM.h>
 #include <fluid/PCM_internal.h>
+#include <fluid/PCMmultigrid.h>
 #include <core/VectorField.h>
 #include <core/ScalarFieldIO.h>
 #include <core/Thread.h>
@@ -28,6 +29,7 @@ LinearPCM::LinearPCM(const Everything& e, const FluidSolverParams& fsp)
 : PCM(e, fsp)
 {
 	assert(!useGummel()); //Non-variational energy: cannot use Gummel loop!
+	if(fsp.multigridLevels) multigrid = std::make_shared<PCMmultigrid>(gInfo, fsp.multigridLevels);
 }
 
 LinearPCM::~LinearPCM()
@@ -54,7 +56,8 @@ ScalarFieldTilde LinearPCM::hessian(const ScalarFieldTilde& phiTilde) const
 }
 
 ScalarFieldTilde LinearPCM::precondition(const ScalarFieldTilde& rTilde) const
-{	return Kkernel*(J(epsInv*I(Kkernel*rTilde)));
+{	if(multigrid) return (*multigrid)(rTilde, *this, Kkernel, epsInv);
+	return Kkernel*(J(epsInv*I(Kkernel*rTilde)));
 }
 
 //Initialize Kkernel to square-root of the inverse kinetic operator
@@ -84,6 +87,7 @@ void LinearPCM::updatePreconditioner(const ScalarField& epsilon, const ScalarFie
 	double epsMean = sum(epsilon) / gInfo.nr;
 	double kappaSqMean = (kappaSq ? sum(kappaSq) : 0.) / gInfo.nr;
 	Kkernel.init(0, 0.02, gInfo.GmaxGrid, setPreconditionerKernel, epsMean, sqrt(kappaSqMean/epsMean));
+	if(multigrid) multigrid->update(epsilon, kappaSq);
 }
 
 void LinearPCM::override(const ScalarField& epsilon, const ScalarField& kappaSq)
@@ -163,3 +163,220 @@ double phiBondUniform(double Rhm, double scale, double n0mol, double n2, double
 	std::vector<const double*> constZeroArr(3,&constzero); //dummy arrays for zero vector weighted densities
 	return phiBond_calc(0, Rhm, scale, &n0mol, &n2, &n3, constZeroArr, &grad_n0mol, &grad_n2, &grad_n3, zeroArr);
 }
+
+
+//------------------------- Fused weighted densities for a mixture ---------------------------
+
+//Channels of the fused weighted densities: scalars n0 to n3, vectors n1v and n2v, and tensor n2m (in that order)
+enum FMTchannel { FMT_n0, FMT_n1, FMT_n2, FMT_n3, FMT_n1v, FMT_n2v=FMT_n1v+3, FMT_n2m=FMT_n2v+3, FMT_nChannels=FMT_n2m+5 };
+typedef ScalarFieldMultiplet<ScalarFieldData,FMT_nChannels> FMTfield;
+typedef ScalarFieldMultiplet<ScalarFieldTildeData,FMT_nChannels> FMTfieldTilde;
+
+//Raw-data version of FMTsite for the kernels below
+struct FMTsiteData
+{	const RadialFunctionG *w0, *w1, *w2, *w3, *w1v, *w2m;
+	int iMol;
+	const complex* N;
+	complex* Phi_N;
+};
+
+//All weighted densities (and partial n0 of bonded molecules) from all sites at one G-vector:
+inline void fmtWeightedDensities_calc(int i, const vector3<int>& iG, bool nyq, const matrix3<>& G, const matrix3<>& GGT,
+	int nSites, const FMTsiteData* sites, int nMol, complex* const* n0mol, complex* const* n)
+{	double Gmag = sqrt(GGT.metric_length_squared(iG));
+	for(int iMol=0; iMol<nMol; iMol++) n0mol[iMol][i] = 0.;
+	complex n0, n1, n2, n3, n1vScalar, n2mScalar;
+	for(int iSite=0; iSite<nSites; iSite++)
+	{	const FMTsiteData& s = sites[iSite];
+		const complex N = s.N[i];
+		const complex w0N = (*s.w0)(Gmag) * N;
+		n0 += w0N;
+		if(s.iMol >= 0) n0mol[s.iMol][i] += w0N;
+		n1 += (*s.w1)(Gmag) * N;
+		n2 += (*s.w2)(Gmag) * N;
+		n3 += (*s.w3)(Gmag) * N;
+		n1vScalar += (*s.w1v)(Gmag) * N;
+		n2mScalar += (*s.w2m)(Gmag) * N;
+	}
+	n[FMT_n0][i] = n0;
+	n[FMT_n1][i] = n1;
+	n[FMT_n2][i] = n2;
+	n[FMT_n3][i] = n3;
+	//Vector weighted densities n1v = gradient(n1vScalar) and n2v = -gradient(n3):
+	vector3<> Gvec = iG*G;
+	complex iota(0.0, nyq ? 0.0 : 1.0); //zero nyquist frequencies
+	for(int k=0; k<3; k++)
+	{	n[FMT_n1v+k][i] = Gvec[k] * (iota*n1vScalar);
+		n[FMT_n2v+k][i] = Gvec[k] * (iota*(-n3));
+	}
+	//Tensor weighted density (same as tensorKernel_calc):
+	complex minus_n2mScalar = nyq ? complex(0,0) : -n2mScalar;
+	double Gsq = Gvec.length_squared();
+	n[FMT_n2m+0][i] = minus_n2mScalar*Gvec.x()*Gvec.y();
+	n[FMT_n2m+1][i] = minus_n2mScalar*Gvec.y()*Gvec.z();
+	n[FMT_n2m+2][i] = minus_n2mScalar*Gvec.z()*Gvec.x();
+	n[FMT_n2m+3][i] = minus_n2mScalar*(Gvec.x()*Gvec.x() - (1.0/3)*Gsq);
+	n[FMT_n2m+4][i] = minus_n2mScalar*(Gvec.y()*Gvec.y() - (1.0/3)*Gsq);
+}
+inline void fmtWeightedDensities_sub(size_t iStart, size_t iStop, const vector3<int> S, const matrix3<> G, const matrix3<> GGT,
+	int nSites, const FMTsiteData* sites, int nMol, complex* const* n0mol, complex* const* n)
+{	THREAD_halfGspaceLoop( fmtWeightedDensities_calc(i, iG, IS_NYQUIST, G, GGT, nSites, sites, nMol, n0mol, n); )
+}
+
+//Propagate gradients w.r.t all weighted densities (and partial n0 of bonded molecules) to all sites at one G-vector:
+inline void fmtWeightedDensities_grad_calc(int i, const vector3<int>& iG, bool nyq, const matrix3<>& G, const matrix3<>& GGT,
+	int nSites, const FMTsiteData* sites, const complex* const* Phi_n0mol, const complex* const* Phi_n, double gradScale)
+{	double Gmag = sqrt(GGT.metric_length_squared(iG));
+	vector3<> Gvec = iG*G;
+	complex iota(0.0, nyq ? 0.0 : 1.0); //zero nyquist frequencies
+	vector3<complex> Phi_n1v, Phi_n2v;
+	for(int k=0; k<3; k++)
+	{	Phi_n1v[k] = Phi_n[FMT_n1v+k][i];
+		Phi_n2v[k] = Phi_n[FMT_n2v+k][i];
+	}
+	//Gradients w.r.t scalar convolutions underlying the vector and tensor weighted densities:
+	const complex Phi_n1 = Phi_n[FMT_n1][i];
+	const complex Phi_n2 = Phi_n[FMT_n2][i];
+	const complex Phi_n3 = Phi_n[FMT_n3][i] + iota * dot(Gvec, Phi_n2v);
+	const complex Phi_n1vScalar = -(iota * dot(Gvec, Phi_n1v));
+	complex Phi_n2mScalar; //same as tensorKernel_grad_calc:
+	if(!nyq)
+	{	double Gsq = Gvec.length_squared();
+		Phi_n2mScalar -= Phi_n[FMT_n2m+0][i]*Gvec.x()*Gvec.y();
+		Phi_n2mScalar -= Phi_n[FMT_n2m+1][i]*Gvec.y()*Gvec.z();
+		Phi_n2mScalar -= Phi_n[FMT_n2m+2][i]*Gvec.z()*Gvec.x();
+		Phi_n2mScalar -= Phi_n[FMT_n2m+3][i]*(Gvec.x()*Gvec.x() - (1.0/3)*Gsq);
+		Phi_n2mScalar -= Phi_n[FMT_n2m+4][i]*(Gvec.y()*Gvec.y() - (1.0/3)*Gsq);
+	}
+	//Accumulate to sites:
+	for(int iSite=0; iSite<nSites; iSite++)
+	{	const FMTsiteData& s = sites[iSite];
+		complex Phi_n0 = Phi_n[FMT_n0][i];
+		if(s.iMol >= 0 && Phi_n0mol[s.iMol]) Phi_n0 += Phi_n0mol[s.iMol][i];
+		s.Phi_N[i] += gradScale * ( (*s.w0)(Gmag) * Phi_n0
+			+ (*s.w1)(Gmag) * Phi_n1
+			+ (*s.w2)(Gmag) * Phi_n2
+			+ (*s.w3)(Gmag) * Phi_n3
+			+ (*s.w1v)(Gmag) * Phi_n1vScalar
+			+ (*s.w2m)(Gmag) * Phi_n2mScalar );
+	}
+}
+inline void fmtWeightedDensities_grad_sub(size_t iStart, size_t iStop, const vector3<int> S, const matrix3<> G, const matrix3<> GGT,
+	int nSites, const FMTsiteData* sites, const complex* const* Phi_n0mol, const complex* const* Phi_n, double gradScale)
+{	THREAD_halfGspaceLoop( fmtWeightedDensities_grad_calc(i, iG, IS_NYQUIST, G, GGT, nSites, sites, Phi_n0mol, Phi_n, gradScale); )
+}
+
+double PhiFMTmixture(const std::vector<FMTsite>& sites, int nMol, const std::vector<FMTbond>& bonds,
+	double gradScale, double& PhiBonding)
+{	static StopWatch watch("PhiFMTmixture"); watch.start();
+	assert(sites.size());
+	const GridInfo& gInfo = (*sites[0].N)->gInfo;
+	PhiBonding = 0.;
+#ifdef GPU_ENABLED
+	//Channel-by-channel evaluation (fused kernels below are CPU only):
+	ScalarFieldTilde n0tilde, n1tilde, n2tilde, n3tilde, n1vTilde, n2mTilde;
+	std::vector<ScalarFieldTilde> n0molTilde(nMol);
+	for(const FMTsite& s: sites)
+	{	const ScalarFieldTilde& N = *s.N;
+		ScalarFieldTilde w0N = (*s.w0) * N;
+		if(s.iMol >= 0) n0molTilde[s.iMol] += w0N;
+		n0tilde += w0N;
+		n1tilde += (*s.w1) * N;
+		n2tilde += (*s.w2) * N;
+		n3tilde += (*s.w3) * N;
+		n1vTilde += (*s.w1v) * N;
+		n2mTilde += (*s.w2m) * N;
+	}
+	ScalarField n0 = I(n0tilde); n0tilde=0;
+	ScalarField n1 = I(n1tilde); n1tilde=0;
+	ScalarField n2 = I(n2tilde); n2tilde=0;
+	ScalarField Phi_n0, Phi_n1, Phi_n2; ScalarFieldTilde Phi_n3tilde, Phi_n1vTilde, Phi_n2mTilde;
+	double Phi = PhiFMT(n0, n1, n2, n3tilde, n1vTilde, n2mTilde, Phi_n0, Phi_n1, Phi_n2, Phi_n3tilde, Phi_n1vTilde, Phi_n2mTilde);
+	std::vector<ScalarField> Phi_n0mol(nMol);
+	for(const FMTbond& b: bonds)
+		PhiBonding += PhiBond(b.Rhm, b.scale, I(n0molTilde[b.iMol]), n2, n3tilde, Phi_n0mol[b.iMol], Phi_n2, Phi_n3tilde);
+	ScalarFieldTilde Phi_n0tilde = Idag(Phi_n0); Phi_n0=0;
+	ScalarFieldTilde Phi_n1tilde = Idag(Phi_n1); Phi_n1=0;
+	ScalarFieldTilde Phi_n2tilde = Idag(Phi_n2); Phi_n2=0;
+	std::vector<ScalarFieldTilde> Phi_n0molTilde(nMol);
+	for(int iMol=0; iMol<nMol; iMol++)
+		if(Phi_n0mol[iMol]) Phi_n0molTilde[iMol] = Idag(Phi_n0mol[iMol]);
+	for(const FMTsite& s: sites)
+	{	ScalarFieldTilde& Phi_N = *s.Phi_N;
+		if(s.iMol >= 0 && Phi_n0molTilde[s.iMol]) Phi_N += gradScale * ((*s.w0) * Phi_n0molTilde[s.iMol]);
+		Phi_N += gradScale * ((*s.w0)  * Phi_n0tilde);
+		Phi_N += gradScale * ((*s.w1)  * Phi_n1tilde);
+		Phi_N += gradScale * ((*s.w2)  * Phi_n2tilde);
+		Phi_N += gradScale * ((*s.w3)  * Phi_n3tilde);
+		Phi_N += gradScale * ((*s.w1v) * Phi_n1vTilde);
+		Phi_N += gradScale * ((*s.w2m) * Phi_n2mTilde);
+	}
+#else
+	//Raw site data:
+	std::vector<FMTsiteData> siteData(sites.size());
+	for(size_t iSite=0; iSite<sites.size(); iSite++)
+	{	const FMTsite& s = sites[iSite];
+		FMTsiteData& sd = siteData[iSite];
+		sd.w0 = s.w0; sd.w1 = s.w1; sd.w2 = s.w2; sd.w3 = s.w3; sd.w1v = s.w1v; sd.w2m = s.w2m;
+		sd.iMol = s.iMol;
+		sd.N = (*s.N)->data();
+		nullToZero(*s.Phi_N, gInfo);
+		sd.Phi_N = (*s.Phi_N)->data();
+	}
+	
+	//All weighted densities in one pass over G-space, followed by batched transforms to real space:
+	FMTfieldTilde nTilde(gInfo);
+	std::vector<ScalarFieldTilde> n0molTilde(nMol);
+	std::vector<complex*> n0molTildeData(nMol);
+	for(int iMol=0; iMol<nMol; iMol++)
+	{	n0molTilde[iMol] = ScalarFieldTildeData::alloc(gInfo);
+		n0molTildeData[iMol] = n0molTilde[iMol]->data();
+	}
+	std::vector<complex*> nTildeData = nTilde.data();
+	threadLaunch(fmtWeightedDensities_sub, gInfo.nG, gInfo.S, gInfo.G, gInfo.GGT,
+		int(siteData.size()), siteData.data(), nMol, n0molTildeData.data(), nTildeData.data());
+	FMTfield n = I((FMTfieldTilde&&)nTilde);
+	std::vector<ScalarField> n0mol(nMol);
+	for(int iMol=0; iMol<nMol; iMol++)
+		n0mol[iMol] = I((ScalarFieldTilde&&)n0molTilde[iMol]);
+	n0molTilde.clear();
+	
+	//Free energies and gradients in real space:
+	FMTfield Phi_n; nullToZero(Phi_n, gInfo);
+	std::vector<const double*> nData = n.const_data();
+	std::vector<double*> Phi_nData = Phi_n.data();
+	vector3<const double*> n1vData(nData[FMT_n1v], nData[FMT_n1v+1], nData[FMT_n1v+2]);
+	vector3<const double*> n2vData(nData[FMT_n2v], nData[FMT_n2v+1], nData[FMT_n2v+2]);
+	tensor3<const double*> n2mData(nData[FMT_n2m], nData[FMT_n2m+1], nData[FMT_n2m+2], nData[FMT_n2m+3], nData[FMT_n2m+4]);
+	vector3<double*> Phi_n1vData(Phi_nData[FMT_n1v], Phi_nData[FMT_n1v+1], Phi_nData[FMT_n1v+2]);
+	vector3<double*> Phi_n2vData(Phi_nData[FMT_n2v], Phi_nData[FMT_n2v+1], Phi_nData[FMT_n2v+2]);
+	tensor3<double*> Phi_n2mData(Phi_nData[FMT_n2m], Phi_nData[FMT_n2m+1], Phi_nData[FMT_n2m+2], Phi_nData[FMT_n2m+3], Phi_nData[FMT_n2m+4]);
+	double Phi = gInfo.dV*threadedAccumulate(phiFMT_calc, gInfo.nr,
+		nData[FMT_n0], nData[FMT_n1], nData[FMT_n2], nData[FMT_n3], n1vData, n2vData, n2mData,
+		Phi_nData[FMT_n0], Phi_nData[FMT_n1], Phi_nData[FMT_n2], Phi_nData[FMT_n3], Phi_n1vData, Phi_n2vData, Phi_n2mData);
+	std::vector<ScalarField> Phi_n0mol(nMol);
+	for(const FMTbond& b: bonds)
+	{	nullToZero(Phi_n0mol[b.iMol], gInfo);
+		PhiBonding += gInfo.dV*threadedAccumulate(phiBond_calc, gInfo.nr, b.Rhm, b.scale,
+			(const double*)n0mol[b.iMol]->data(), nData[FMT_n2], nData[FMT_n3], n2vData,
+			Phi_n0mol[b.iMol]->data(), Phi_nData[FMT_n2], Phi_nData[FMT_n3], Phi_n2vData);
+	}
+	n = FMTfield(); n0mol.clear(); //no longer need weighted densities (clean up)
+	
+	//Batched transforms of gradients to reciprocal space, followed by propagation to all sites in one pass over G-space:
+	FMTfieldTilde Phi_nTilde = Idag(Phi_n); Phi_n = FMTfield();
+	std::vector<ScalarFieldTilde> Phi_n0molTilde(nMol);
+	std::vector<const complex*> Phi_n0molTildeData(nMol, 0);
+	for(int iMol=0; iMol<nMol; iMol++)
+		if(Phi_n0mol[iMol])
+		{	Phi_n0molTilde[iMol] = Idag(Phi_n0mol[iMol]);
+			Phi_n0molTildeData[iMol] = Phi_n0molTilde[iMol]->data();
+		}
+	std::vector<const complex*> Phi_nTildeData = Phi_nTilde.const_data();
+	threadLaunch(fmtWeightedDensities_grad_sub, gInfo.nG, gInfo.S, gInfo.G, gInfo.GGT,
+		int(siteData.size()), (const FMTsiteData*)siteData.data(), (const complex* const*)Phi_n0molTildeData.data(),
+		(const complex* const*)Phi_nTildeData.data(), gradScale);
+#endif
+	watch.stop();
+	return Phi;
+}
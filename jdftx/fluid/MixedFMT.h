@@ -59,5 +59,29 @@ double PhiBond(double Rhm, double scale, const ScalarField& n0mol, const ScalarF
 double phiBondUniform(double Rhm, double scale, double n0mol, double n2, double n3,
 	double& grad_n0mol, double& grad_n2, double& grad_n3);
 
+
+//! Hard-sphere site density with its weight functions (input to PhiFMTmixture)
+struct FMTsite
+{	const RadialFunctionG *w0, *w1, *w2, *w3, *w1v, *w2m; //!< FMT weight functions of the site
+	int iMol; //!< index of the site's molecule in FMTbond::iMol (-1 if the molecule has no bonds)
+	const ScalarFieldTilde* N; //!< site density
+	ScalarFieldTilde* Phi_N; //!< gradient w.r.t site density (accumulated)
+};
+
+//! Tangential bond between hard spheres of a molecule (input to PhiFMTmixture)
+struct FMTbond
+{	int iMol; //!< index of molecule (see FMTsite::iMol)
+	double Rhm; //!< harmonic sum of the sphere radii (see PhiBond)
+	double scale; //!< ratio of bond multiplicity to number of hard sphere sites in molecule
+};
+
+//! Fused evaluation of PhiFMT and PhiBond for a mixture directly from the site densities.
+//! All scalar, vector and tensor weighted densities of all sites (and the partial n0 of each of the nMol bonded molecules)
+//! are computed in one pass over reciprocal space and transformed to real space together, and the gradients are
+//! propagated back the same way. Returns the sphere-mixture free energy/T, sets the bonding free energy/T in PhiBonding,
+//! and accumulates the gradients w.r.t each site density scaled by gradScale to its Phi_N.
+double PhiFMTmixture(const std::vector<FMTsite>& sites, int nMol, const std::vector<FMTbond>& bonds,
+	double gradScale, double& PhiBonding);
+
 //! @}
 #endif // JDFTX_FLUID_MIXEDFMT_H
@@ -0,0 +1,203 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <fluid/PCMmultigrid.h>
+#include <core/Operators.h>
+#include <core/VectorField.h>
+#include <core/LoopMacros.h>
+#include <core/Thread.h>
+
+static const int nCoarseMin = 8; //!< minimum number of samples along each direction on the coarse grids
+static const int nPowerIterations = 10; //!< power iterations used to estimate the largest eigenvalue of the smoothed operator
+static const double dampingMargin = 1.2; //!< safety factor on the estimated largest eigenvalue for the smoother damping
+static const int nCoarseSweeps = 20; //!< number of damped smoother sweeps on the coarsest level
+
+//Square-root of the inverse kinetic operator (same as the diagonal preconditioner of LinearPCM)
+inline double multigridKernel(double G, double epsMean, double kRMS)
+{	return (G || kRMS) ? 1./(epsMean*hypot(G, kRMS)) : 0.;
+}
+
+//Full-weighting restriction of a real-space field to a grid with half the samples along each direction
+void fullWeight_sub(size_t iStart, size_t iStop, const vector3<int>& S, const vector3<int>& Sfine, const double* in, double* out)
+{	THREAD_rLoop
+	(	double result = 0.;
+		for(int d0=-1; d0<=1; d0++)
+		{	int i0 = (2*iv[0] + d0 + Sfine[0]) % Sfine[0];
+			double w0 = d0 ? 0.25 : 0.5;
+			for(int d1=-1; d1<=1; d1++)
+			{	int i1 = (2*iv[1] + d1 + Sfine[1]) % Sfine[1];
+				double w01 = w0 * (d1 ? 0.25 : 0.5);
+				for(int d2=-1; d2<=1; d2++)
+				{	int i2 = (2*iv[2] + d2 + Sfine[2]) % Sfine[2];
+					result += w01 * (d2 ? 0.25 : 0.5) * in[(i0*Sfine[1] + i1)*Sfine[2] + i2];
+				}
+			}
+		}
+		out[i] = result;
+	)
+}
+ScalarField fullWeight(const ScalarField& in, const GridInfo& gInfoCoarse)
+{	ScalarField out(ScalarFieldData::alloc(gInfoCoarse));
+	threadLaunch(fullWeight_sub, gInfoCoarse.nr, gInfoCoarse.S, in->gInfo.S, in->data(), out->data());
+	return out;
+}
+
+//Estimate the damping factor for Richardson smoothing of operator A with preconditioner S,
+//using a few power iterations for the largest eigenvalue of S A
+template<typename Hessian, typename Smoother>
+double smootherDamping(const GridInfo& gInfo, const Hessian& hessian, const Smoother& smooth)
+{	//Deterministic (and hence identical on all processes) pseudo-random start vector:
+	ScalarField v0(ScalarFieldData::alloc(gInfo));
+	double* v0data = v0->data();
+	for(int i=0; i<gInfo.nr; i++)
+	{	double x = sin(12.9898*i + 78.233) * 43758.5453;
+		v0data[i] = x - floor(x) - 0.5;
+	}
+	ScalarFieldTilde v = J(v0);
+	double lambda = 0.;
+	for(int iter=0; iter<nPowerIterations; iter++)
+	{	ScalarFieldTilde SAv = smooth(hessian(v));
+		double vNorm = sqrt(dot(v,v)), SAvNorm = sqrt(dot(SAv,SAv));
+		if(!SAvNorm) break;
+		lambda = SAvNorm / vNorm;
+		v = (1./SAvNorm) * SAv;
+	}
+	return lambda ? 1./(dampingMargin*lambda) : 1.;
+}
+
+
+PCMmultigrid::PCMmultigrid(const GridInfo& gInfo, int nLevels)
+: gInfo(gInfo), nLevelsMax(nLevels), omegaFine(0.)
+{	setupLevels();
+	logPrintf("   Multigrid preconditioner with %d coarse level(s):", int(levels.size()));
+	for(const auto& level: levels)
+		logPrintf(" [ %d %d %d ]", level->gInfo.S[0], level->gInfo.S[1], level->gInfo.S[2]);
+	logPrintf("\n");
+	if(int(levels.size()) < nLevels)
+		logPrintf("   WARNING: fluid grid dimensions only allow %d of %d requested coarse levels.\n", int(levels.size()), nLevels);
+}
+
+void PCMmultigrid::setupLevels()
+{	levels.clear();
+	vector3<int> S = gInfo.S;
+	for(int iLevel=0; iLevel<nLevelsMax; iLevel++)
+	{	//Check if grid can be halved further along all directions:
+		bool canCoarsen = true;
+		for(int k=0; k<3; k++)
+			if(S[k]%2 || S[k]/2<nCoarseMin || !fftSuitable(S[k]/2))
+				canCoarsen = false;
+		if(!canCoarsen) break;
+		for(int k=0; k<3; k++) S[k] /= 2;
+		//Create coarse grid with same lattice vectors:
+		auto level = std::make_shared<Level>();
+		level->gInfo.R = gInfo.R;
+		level->gInfo.S = S;
+		level->gInfo.initialize(true);
+		level->omega = 0.;
+		levels.push_back(level);
+	}
+}
+
+PCMmultigrid::Level::~Level()
+{	Kkernel.free();
+}
+
+ScalarFieldTilde PCMmultigrid::Level::hessian(const ScalarFieldTilde& phiTilde) const
+{	ScalarFieldTilde rhoTilde = divergence(J(epsilon * I(gradient(phiTilde))));
+	if(kappaSq) rhoTilde -= J(kappaSq * I(phiTilde));
+	return (-1./(4*M_PI)) * rhoTilde;
+}
+
+ScalarFieldTilde PCMmultigrid::Level::smooth(const ScalarFieldTilde& rTilde) const
+{	return Kkernel*(J(epsInv*I(Kkernel*rTilde)));
+}
+
+void PCMmultigrid::update(const ScalarField& epsilon, const ScalarField& kappaSq)
+{	if(!levels.size()) return;
+	if(!(levels[0]->gInfo.R == gInfo.R)) //lattice vectors changed
+	{	setupLevels();
+		omegaFine = 0.; //re-estimate on next use
+	}
+	//Coarsen model coefficients level by level:
+	ScalarField epsFine = epsilon, kappaSqFine = kappaSq;
+	for(auto& level: levels)
+	{	level->epsilon = fullWeight(epsFine, level->gInfo);
+		level->kappaSq = kappaSqFine ? fullWeight(kappaSqFine, level->gInfo) : ScalarField();
+		level->epsInv = inv(level->epsilon);
+		double epsMean = sum(level->epsilon) / level->gInfo.nr;
+		double kappaSqMean = (level->kappaSq ? sum(level->kappaSq) : 0.) / level->gInfo.nr;
+		level->Kkernel.init(0, 0.02, level->gInfo.GmaxGrid, multigridKernel, epsMean, sqrt(kappaSqMean/epsMean));
+		//Smoother damping (estimated once per lattice: the smoother scales with 1/epsilon and the operator with epsilon,
+		//so the largest eigenvalue of their product varies little as epsilon is updated, and dampingMargin covers that):
+		const Level& l = *level;
+		if(!level->omega)
+			level->omega = smootherDamping(l.gInfo,
+				[&](const ScalarFieldTilde& x) { return l.hessian(x); },
+				[&](const ScalarFieldTilde& x) { return l.smooth(x); } );
+		epsFine = level->epsilon;
+		kappaSqFine = level->kappaSq;
+	}
+}
+
+ScalarFieldTilde PCMmultigrid::operator()(const ScalarFieldTilde& rTilde, const LinearSolvable<ScalarFieldTilde>& fine,
+	const RadialFunctionG& Kkernel, const ScalarField& epsInv) const
+{	auto hessian = [&](const ScalarFieldTilde& x) { return fine.hessian(x); };
+	auto smooth = [&](const ScalarFieldTilde& x) { return Kkernel*(J(epsInv*I(Kkernel*x))); };
+	if(!levels.size()) return smooth(rTilde);
+	if(!omegaFine) omegaFine = smootherDamping(gInfo, hessian, smooth);
+	//Pre-smooth, coarse-grid correction, post-smooth:
+	ScalarFieldTilde zTilde = omegaFine * smooth(rTilde);
+	zTilde += prolong(vcycle(0, restrict(rTilde - hessian(zTilde), levels[0]->gInfo)), gInfo);
+	zTilde += omegaFine * smooth(rTilde - hessian(zTilde));
+	return zTilde;
+}
+
+ScalarFieldTilde PCMmultigrid::vcycle(int iLevel, const ScalarFieldTilde& rTilde) const
+{	const Level& level = *levels[iLevel];
+	if(iLevel+1 == int(levels.size()))
+		return coarseSolve(level, rTilde);
+	ScalarFieldTilde zTilde = level.omega * level.smooth(rTilde);
+	zTilde += prolong(vcycle(iLevel+1, restrict(rTilde - level.hessian(zTilde), levels[iLevel+1]->gInfo)), level.gInfo);
+	zTilde += level.omega * level.smooth(rTilde - level.hessian(zTilde));
+	return zTilde;
+}
+
+ScalarFieldTilde PCMmultigrid::coarseSolve(const Level& level, const ScalarFieldTilde& rTilde) const
+{	//A fixed number of sweeps from zero applies a fixed polynomial of the smoothed operator, so that the V-cycle
+	//stays a linear (symmetric positive-definite) operator, as required by the Fletcher-Reeves CG in LinearSolvable
+	//(an inner CG to a tolerance would make the preconditioner depend on the residual)
+	ScalarFieldTilde xTilde = level.omega * level.smooth(rTilde);
+	for(int iSweep=1; iSweep<nCoarseSweeps; iSweep++)
+		xTilde += level.omega * level.smooth(rTilde - level.hessian(xTilde));
+	return xTilde;
+}
+
+//Restriction and prolongation by Fourier truncation and zero-padding; the coarse-grid Nyquist
+//components are dropped in both so that prolongation is exactly the adjoint of restriction
+ScalarFieldTilde PCMmultigrid::restrict(const ScalarFieldTilde& xTilde, const GridInfo& gInfoCoarse) const
+{	ScalarFieldTilde out = changeGrid(xTilde, gInfoCoarse);
+	zeroNyquist(out);
+	return out;
+}
+
+ScalarFieldTilde PCMmultigrid::prolong(const ScalarFieldTilde& xTilde, const GridInfo& gInfoFine) const
+{	ScalarFieldTilde in = clone(xTilde);
+	zeroNyquist(in);
+	return changeGrid(in, gInfoFine);
+}
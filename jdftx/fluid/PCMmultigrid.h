@@ -0,0 +1,73 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#ifndef JDFTX_FLUID_PCMMULTIGRID_H
+#define JDFTX_FLUID_PCMMULTIGRID_H
+
+#include <core/ScalarField.h>
+#include <core/RadialFunction.h>
+#include <core/Minimize.h>
+
+//! @addtogroup Solvation
+//! @{
+
+//! Geometric multigrid (symmetric V-cycle) preconditioner for the dielectric Poisson-like equations of PCM solvers.
+//! The coarse levels are Fourier-coarsened copies of the fluid grid (half the samples along each direction, same lattice),
+//! on which the local model operator -(1/4pi) (div(epsilon grad) - kappaSq) is rediscretized using fully-weighted
+//! restrictions of epsilon and kappaSq. The finest level uses the solver's own hessian, and its diagonal preconditioner
+//! as a damped Richardson smoother, so that the V-cycle remains a symmetric positive-definite preconditioner for CG.
+class PCMmultigrid
+{
+public:
+	PCMmultigrid(const GridInfo& gInfo, int nLevels); //!< Use upto nLevels coarse levels (fewer if the grid dimensions do not allow)
+	void update(const ScalarField& epsilon, const ScalarField& kappaSq); //!< Update the model operator on the coarse levels (kappaSq may be null); smoother damping is only re-estimated if the lattice changed
+	
+	//! Apply one V-cycle to residual rTilde, where fine.hessian is the fine-level operator,
+	//! and Kkernel*J(epsInv*I(Kkernel*r)) is the fine-level diagonal preconditioner used as the smoother
+	ScalarFieldTilde operator()(const ScalarFieldTilde& rTilde, const LinearSolvable<ScalarFieldTilde>& fine,
+		const RadialFunctionG& Kkernel, const ScalarField& epsInv) const;
+	
+	int nLevels() const { return levels.size(); } //!< number of coarse levels in use
+
+private:
+	const GridInfo& gInfo; //!< fluid grid (finest level)
+	int nLevelsMax; //!< requested number of coarse levels
+	
+	//! Model operator and smoother on a coarse level
+	struct Level
+	{	GridInfo gInfo;
+		ScalarField epsilon, kappaSq, epsInv;
+		RadialFunctionG Kkernel;
+		double omega; //!< damping factor of Richardson smoother
+		~Level();
+		ScalarFieldTilde hessian(const ScalarFieldTilde&) const;
+		ScalarFieldTilde smooth(const ScalarFieldTilde&) const;
+	};
+	std::vector< std::shared_ptr<Level> > levels;
+	mutable double omegaFine; //!< smoother damping on the finest level (determined on first use for each lattice)
+	
+	void setupLevels(); //!< (re)create coarse grids for current lattice vectors
+	ScalarFieldTilde restrict(const ScalarFieldTilde&, const GridInfo& gInfoCoarse) const;
+	ScalarFieldTilde prolong(const ScalarFieldTilde&, const GridInfo& gInfoFine) const;
+	ScalarFieldTilde vcycle(int iLevel, const ScalarFieldTilde& rTilde) const; //!< V-cycle starting at coarse level iLevel
+	ScalarFieldTilde coarseSolve(const Level& level, const ScalarFieldTilde& rTilde) const; //!< approximate solve by a fixed number of smoother sweeps on coarsest level
+};
+
+//! @}
+#endif // JDFTX_FLUID_PCMMULTIGRID_H
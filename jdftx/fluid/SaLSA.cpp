@@ -24,6 +24,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 #include <core/SphericalHarmonics.h>
 #include <fluid/SaLSA.h>
 #include <fluid/PCM_internal.h>
+#include <fluid/PCMmultigrid.h>
 #include <gsl/gsl_linalg.h>
 #include <cstring>
 
@@ -179,6 +180,8 @@ SaLSA::SaLSA(const Everything& e, const FluidSolverParams& fsp)
 	
 	//MPI division:
 	TaskDivision(response.size(), mpiWorld).myRange(rStart, rStop);
+	
+	if(fsp.multigridLevels) multigrid = std::make_shared<PCMmultigrid>(gInfo, fsp.multigridLevels);
 }
 
 SaLSA::~SaLSA()
@@ -205,7 +208,8 @@ ScalarFieldTilde SaLSA::hessian(const ScalarFieldTilde& phiTilde) const
 }
 
 ScalarFieldTilde SaLSA::precondition(const ScalarFieldTilde& rTilde) const
-{	return Kkernel*(J(epsInv*I(Kkernel*rTilde)));
+{	if(multigrid) return (*multigrid)(rTilde, *this, Kkernel, epsInv);
+	return Kkernel*(J(epsInv*I(Kkernel*rTilde)));
 }
 
 double SaLSA::sync(double x) const
@@ -227,7 +231,10 @@ void SaLSA::set_internal(const ScalarFieldTilde& rhoExplicitTilde, const ScalarF
 		siteShape[iSite] = I(Sf[iSite] * J(shape[0]));
 	
 	//Update the inhomogeneity factor of the preconditioner
-	epsInv = inv(1. + (epsBulk-1.)*shape[0]);
+	ScalarField epsilon = 1. + (epsBulk-1.)*shape[0];
+	epsInv = inv(epsilon);
+	if(multigrid) //coarse levels use the local (linear PCM) model with the same bulk response
+		multigrid->update(epsilon, k2factor ? k2factor*shape.back() : ScalarField());
 	
 	//Initialize the state if it hasn't been loaded:
 	if(!state) nullToZero(state, gInfo);
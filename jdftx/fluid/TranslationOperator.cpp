@@ -45,13 +45,22 @@ void constantSplineTaxpy_gpu(const vector3<int> S,
 void linearSplineTaxpy_gpu(const vector3<int> S,
 	double alpha, const double* x, double* y, const vector3<int> Tint, const vector3<> Tfrac);
 #endif
-void TranslationOperatorSpline::taxpy(const vector3<>& t, double alpha, const ScalarField& x, ScalarField& y) const
+void TranslationOperator::taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const std::vector<const ScalarField*>& x, ScalarField& y) const
+{	assert(t.size()==alpha.size() && t.size()==x.size());
+	for(size_t j=0; j<t.size(); j++)
+		taxpy(t[j], alpha[j], *x[j], y);
+}
+
+void TranslationOperator::taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const ScalarField& x, const std::vector<ScalarField*>& y) const
+{	assert(t.size()==alpha.size() && t.size()==y.size());
+	for(size_t j=0; j<t.size(); j++)
+		taxpy(t[j], alpha[j], x, *y[j]);
+}
+
+void TranslationOperatorSpline::getShift(const vector3<>& t, vector3<int>& Tint, vector3<>& Tfrac) const
 {	//Perform a gather with the inverse translation (hence negate t),
 	//instead of scatter which is less efficient to parallelize
-	vector3<> Tfrac = Diag(gInfo.S) * inv(gInfo.R) * (-t); //now in grid point units
-	vector3<int> Tint;
-	//Prepare output:
-	nullToZero(y, gInfo);
+	Tfrac = Diag(gInfo.S) * inv(gInfo.R) * (-t); //now in grid point units
 	switch(splineType)
 	{	case Constant:
 		{	for(int k=0; k<3; k++)
@@ -61,12 +70,7 @@ void TranslationOperatorSpline::taxpy(const vector3<>& t, double alpha, const Sc
 				Tint[k] = Tint[k] % gInfo.S[k];
 				if(Tint[k]<0) Tint[k] += gInfo.S[k];
 			}
-			//Launch threads/gpu kernels:
-			#ifdef GPU_ENABLED
-			constantSplineTaxpy_gpu(gInfo.S, alpha*x->scale, x->dataGpu(false), y->dataGpu(), Tint);
-			#else
-			threadLaunch(constantSplineTaxpy_sub, gInfo.nr, gInfo.S, alpha*x->scale, x->data(false), y->data(), Tint);
-			#endif
+			Tfrac = vector3<>();
 			break;
 		}
 		case Linear:
@@ -79,7 +83,28 @@ void TranslationOperatorSpline::taxpy(const vector3<>& t, double alpha, const Sc
 				Tfrac[k] -= Tint[k];
 				Tint[k] = Tint[k] % gInfo.S[k];
 			}
-			//Launch threads/gpu kernels:
+			break;
+		}
+	}
+}
+
+void TranslationOperatorSpline::taxpy(const vector3<>& t, double alpha, const ScalarField& x, ScalarField& y) const
+{	vector3<> Tfrac; vector3<int> Tint;
+	getShift(t, Tint, Tfrac);
+	//Prepare output:
+	nullToZero(y, gInfo);
+	switch(splineType)
+	{	case Constant:
+		{	//Launch threads/gpu kernels:
+			#ifdef GPU_ENABLED
+			constantSplineTaxpy_gpu(gInfo.S, alpha*x->scale, x->dataGpu(false), y->dataGpu(), Tint);
+			#else
+			threadLaunch(constantSplineTaxpy_sub, gInfo.nr, gInfo.S, alpha*x->scale, x->data(false), y->data(), Tint);
+			#endif
+			break;
+		}
+		case Linear:
+		{	//Launch threads/gpu kernels:
 			#ifdef GPU_ENABLED
 			linearSplineTaxpy_gpu(gInfo.S, alpha*x->scale, x->dataGpu(false), y->dataGpu(), Tint, Tfrac);
 			#else
@@ -90,6 +115,77 @@ void TranslationOperatorSpline::taxpy(const vector3<>& t, double alpha, const Sc
 	}
 }
 
+//Term of a batched spline translation: y[iy] += alpha * x[iy + Tint + Tfrac] (interpolated)
+struct SplineTerm
+{	const double* x; double* y;
+	double alpha;
+	vector3<int> Tint; vector3<> Tfrac;
+};
+
+void splineTaxpyBatched_sub(size_t iStart, size_t iStop, const vector3<int> S, bool linear, const std::vector<SplineTerm>* terms)
+{	for(size_t iLine=iStart; iLine<iStop; iLine++) //each line along the contiguous (z) direction
+	{	int i0 = iLine / S[1];
+		int i1 = iLine - i0*S[1];
+		size_t lineOffset = iLine * S[2];
+		for(const SplineTerm& term: *terms)
+		{	double* yLine = term.y + lineOffset;
+			if(linear)
+			{	const double w0[] = {1-term.Tfrac[0], term.Tfrac[0]};
+				const double w1[] = {1-term.Tfrac[1], term.Tfrac[1]};
+				for(int d0=0; d0<2; d0++)
+				for(int d1=0; d1<2; d1++)
+				{	int j0 = i0+term.Tint[0]+d0; if(j0>=S[0]) j0-=S[0];
+					int j1 = i1+term.Tint[1]+d1; if(j1>=S[1]) j1-=S[1];
+					linearSplineLine(S[2], term.Tint[2], term.Tfrac[2], term.alpha*w0[d0]*w1[d1], term.x + (size_t(j0)*S[1]+j1)*S[2], yLine);
+				}
+			}
+			else
+			{	int j0 = i0+term.Tint[0]; if(j0>=S[0]) j0-=S[0];
+				int j1 = i1+term.Tint[1]; if(j1>=S[1]) j1-=S[1];
+				constantSplineLine(S[2], term.Tint[2], term.alpha, term.x + (size_t(j0)*S[1]+j1)*S[2], yLine);
+			}
+		}
+	}
+}
+
+void TranslationOperatorSpline::taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const std::vector<const ScalarField*>& x, ScalarField& y) const
+{
+	#ifdef GPU_ENABLED
+	TranslationOperator::taxpyBatched(t, alpha, x, y);
+	#else
+	assert(t.size()==alpha.size() && t.size()==x.size());
+	nullToZero(y, gInfo);
+	std::vector<SplineTerm> terms(t.size());
+	for(size_t j=0; j<t.size(); j++)
+	{	SplineTerm& term = terms[j];
+		getShift(t[j], term.Tint, term.Tfrac);
+		term.alpha = alpha[j] * (*x[j])->scale;
+		term.x = (*x[j])->data(false);
+		term.y = y->data();
+	}
+	threadLaunch(splineTaxpyBatched_sub, gInfo.S[0]*gInfo.S[1], gInfo.S, splineType==Linear, &terms);
+	#endif
+}
+
+void TranslationOperatorSpline::taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const ScalarField& x, const std::vector<ScalarField*>& y) const
+{
+	#ifdef GPU_ENABLED
+	TranslationOperator::taxpyBatched(t, alpha, x, y);
+	#else
+	assert(t.size()==alpha.size() && t.size()==y.size());
+	std::vector<SplineTerm> terms(t.size());
+	for(size_t j=0; j<t.size(); j++)
+	{	SplineTerm& term = terms[j];
+		getShift(t[j], term.Tint, term.Tfrac);
+		term.alpha = alpha[j] * x->scale;
+		term.x = x->data(false);
+		nullToZero(*y[j], gInfo);
+		term.y = (*y[j])->data();
+	}
+	threadLaunch(splineTaxpyBatched_sub, gInfo.S[0]*gInfo.S[1], gInfo.S, splineType==Linear, &terms);
+	#endif
+}
+
 TranslationOperatorFourier::TranslationOperatorFourier(const GridInfo& gInfo)
 : TranslationOperator(gInfo)
 {
@@ -26,6 +26,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <core/GridInfo.h>
 #include <core/ScalarField.h>
+#include <vector>
 
 //! Abstract base class for translation operators
 class TranslationOperator
@@ -41,6 +42,14 @@ public:
 	//! T must conserve integral(x) and satisfy @f$ T^{\dagger}_t = T_{-t} @f$ exactly for gradient correctness
 	//! Note that @f$ T^{-1}_t = T_{-t} @f$ may only be approximately true for some implementations.
 	virtual void taxpy(const vector3<>& t, double alpha, const ScalarField& x, ScalarField& y) const=0;
+	
+	//! Batched translation of several sources into one output: @f$ y += \sum_j alpha_j T_{t_j}(x_j) @f$.
+	//! The default implementation calls taxpy() once per term; derived classes may fuse all terms into a single pass.
+	virtual void taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const std::vector<const ScalarField*>& x, ScalarField& y) const;
+	
+	//! Batched translation of one source into several outputs: @f$ y_j += alpha_j T_{t_j}(x) @f$,
+	//! which is the adjoint of the above (with t negated). Entries of y may repeat.
+	virtual void taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const ScalarField& x, const std::vector<ScalarField*>& y) const;
 };
 
 //! Translation operator which works in real space using interpolating splines
@@ -55,6 +64,13 @@ public:
 
 	TranslationOperatorSpline(const GridInfo& gInfo, SplineType splineType);
 	void taxpy(const vector3<>& t, double alpha, const ScalarField& x, ScalarField& y) const;
+	
+	//Single pass over the grid, one z-line at a time (with contiguous, vectorizable inner loops):
+	void taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const std::vector<const ScalarField*>& x, ScalarField& y) const;
+	void taxpyBatched(const std::vector< vector3<> >& t, const std::vector<double>& alpha, const ScalarField& x, const std::vector<ScalarField*>& y) const;
+
+private:
+	void getShift(const vector3<>& t, vector3<int>& Tint, vector3<>& Tfrac) const; //!< Split gather shift (-t) into integer grid offset and fractional weights
 };
 
 //! The exact translation operator in PW basis, although much slower and with potential ringing issues
@@ -64,6 +64,24 @@ void linearSplineTaxpy_calc(int yIndex, const vector3<int> iy, const vector3<int
 	y[yIndex] += alpha * temp0;
 }
 
+//Translate one line along the contiguous direction (length S2, integer offset 0 <= T2 < S2) by constant spline:
+//yLine[i2] += alpha * xRow[(i2+T2) mod S2], split into two wrap-free segments so that the loops vectorize
+inline void constantSplineLine(int S2, int T2, double alpha, const double* xRow, double* yLine)
+{	int iSplit = S2-T2; //first i2 for which i2+T2 wraps around
+	for(int i2=0; i2<iSplit; i2++) yLine[i2] += alpha * xRow[i2+T2];
+	for(int i2=iSplit; i2<S2; i2++) yLine[i2] += alpha * xRow[i2+T2-S2];
+}
+
+//Translate one line along the contiguous direction (length S2, offset T2+f2 with 0 <= T2 < S2) by linear spline:
+//yLine[i2] += alpha * ((1-f2) xRow[(i2+T2) mod S2] + f2 xRow[(i2+T2+1) mod S2])
+inline void linearSplineLine(int S2, int T2, double f2, double alpha, const double* xRow, double* yLine)
+{	double wa = alpha*(1.-f2), wb = alpha*f2;
+	int iSplit = S2-T2; //first i2 for which i2+T2 wraps around
+	for(int i2=0; i2<iSplit-1; i2++) yLine[i2] += wa*xRow[i2+T2] + wb*xRow[i2+T2+1];
+	yLine[iSplit-1] += wa*xRow[S2-1] + wb*xRow[0]; //only the second point wraps
+	for(int i2=iSplit; i2<S2; i2++) yLine[i2] += wa*xRow[i2+T2-S2] + wb*xRow[i2+T2+1-S2];
+}
+
 __hostanddev__
 void fourierTranslate_calc(int i, const vector3<int> iG, const vector3<int> S, const vector3<> Gt, complex* xTilde)
 {	xTilde[i] *= cis(-dot(iG,Gt));
@@ -0,0 +1,175 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <electronic/Everything.h>
+#include <electronic/ColumnBundle.h>
+#include <electronic/Dump.h>
+#include <electronic/Calculation.h>
+#include <core/RadialFunction.h>
+#include <core/Util.h>
+#include <commands/parser.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+//! A calculation listed in the batch manifest
+struct BatchJob
+{	string inFile; //!< input file (path relative to working directory of batch)
+	string outFile; //!< output log file (default: input file with extension replaced by .out)
+};
+
+//Read manifest with one job per line: <inputFile> [<outputFile>]  (blank lines and # comments ignored)
+std::vector<BatchJob> readManifest(string filename)
+{	std::vector<BatchJob> jobs;
+	ifstream ifs(filename.c_str());
+	if(!ifs.is_open()) die("Could not open batch manifest '%s' for reading.\n", filename.c_str());
+	string line;
+	while(getline(ifs, line))
+	{	line = line.substr(0, line.find('#')); //strip comments
+		istringstream iss(line);
+		BatchJob job;
+		iss >> job.inFile >> job.outFile;
+		if(!job.inFile.length()) continue; //blank line
+		if(!job.outFile.length())
+		{	size_t lastDot = job.inFile.find_last_of(".");
+			size_t lastSlash = job.inFile.find_last_of("\\/");
+			job.outFile = ((lastDot!=string::npos && (lastSlash==string::npos || lastDot>lastSlash))
+				? job.inFile.substr(0, lastDot) : job.inFile) + ".out";
+		}
+		jobs.push_back(job);
+	}
+	return jobs;
+}
+
+//Split path into directory (empty if none) and file name
+void splitPath(const string& path, string& dir, string& name)
+{	size_t lastSlash = path.find_last_of("\\/");
+	if(lastSlash == string::npos) { dir.clear(); name = path; }
+	else { dir = path.substr(0, lastSlash+1); name = path.substr(lastSlash+1); }
+}
+
+//Program entry point
+int main(int argc, char** argv)
+{	//Parse command line, initialize system and logs:
+	InitParams ip("Performs a batch of JDFTx calculations listed in a manifest file (specified using -i),\n"
+		"\twith one line per calculation: <inputFile> [<outputFile>=<inputFile basename>.out].\n"
+		"\tEach calculation runs in the directory containing its input file, one after the other\n"
+		"\twithin each process group (-G), with different groups running different calculations.\n"
+		"\tPseudopotential transforms and FFT plans are shared between all calculations in a process.");
+	initSystemCmdline(argc, argv, ip);
+	if(!ip.inputFilename.length()) die("Batch manifest file must be specified using -i.\n");
+	std::vector<BatchJob> jobs = readManifest(ip.inputFilename);
+	int nJobs = jobs.size();
+	
+	//Enable sharing of setup between calculations:
+	RadialFunctionR::cacheTransforms = true;
+	GridInfo::sharePlans = true;
+	
+	//Each process group runs its share of jobs as an independent world:
+	MPIUtil* batchWorld = mpiWorld;
+	MPIUtil* batchGroup = mpiGroup;
+	MPIUtil* batchGroupHead = mpiGroupHead;
+	MPIUtil* jobGroup = new MPIUtil(0,0, MPIUtil::ProcDivision(batchGroup, batchGroup->nProcesses())); //one process per group within job
+	MPIUtil* jobGroupHead = new MPIUtil(0,0, MPIUtil::ProcDivision(batchGroup, 0, jobGroup->iProcess()));
+	int nGroups = batchGroup->procDivision.nGroups;
+	int iGroup = batchGroup->procDivision.iGroup;
+	logPrintf("\nRunning %d calculations in %d process group(s).\n", nJobs, nGroups);
+	logFlush();
+	
+	//Run jobs:
+	char cwdBuf[4096];
+	if(!getcwd(cwdBuf, sizeof(cwdBuf))) die("Could not determine current working directory.\n");
+	string cwd(cwdBuf);
+	std::vector<double> tSetup(nJobs, 0.), tTotal(nJobs, 0.); //timing of each job (accumulated only on group head, and then reduced)
+	Citations::save(); //citations common to all jobs (the rest are cleared after each job)
+	for(int iJob=iGroup; iJob<nJobs; iJob+=nGroups)
+	{	const BatchJob& job = jobs[iJob];
+		//Redirect log:
+		FILE* fpJob = nullLog;
+		if(batchGroup->isHead())
+		{	fpJob = fopen(job.outFile.c_str(), "w");
+			if(!fpJob) die_alone("Could not open '%s' for writing the log of calculation %d.\n", job.outFile.c_str(), iJob+1);
+		}
+		FILE* fpBatch = logRedirect(fpJob);
+		mpiWorld = batchGroup;
+		mpiGroup = jobGroup;
+		mpiGroupHead = jobGroupHead;
+		//Switch to job directory:
+		string jobDir, jobInput;
+		splitPath(job.inFile, jobDir, jobInput);
+		if(jobDir.length() && chdir(jobDir.c_str())) die("Could not change to directory '%s'.\n", jobDir.c_str());
+		inputBasename = jobInput.substr(0, jobInput.find_last_of("."));
+		//Run job:
+		Citations::restore();
+		printVersionBanner(&ip);
+		logPrintf("Calculation %d of %d in batch '%s' with input file '%s'.\n", iJob+1, nJobs, ip.inputFilename.c_str(), job.inFile.c_str());
+		double tStart = clock_sec();
+		{	Everything e;
+			parse(readInputFile(jobInput), e, ip.printDefaults);
+			if(ip.dryRun) e.eVars.skipWfnsInit = true;
+			e.setup();
+			e.dump(DumpFreq_Init, 0);
+			Citations::print();
+			double tSetupCur = clock_sec() - tStart;
+			if(batchGroup->isHead()) tSetup[iJob] = tSetupCur;
+			logPrintf("Initialization completed successfully in %.2lf s.\n\n", tSetupCur);
+			logFlush();
+			if(!ip.dryRun) runCalculation(e);
+		}
+		double tTotalCur = clock_sec() - tStart;
+		if(batchGroup->isHead()) tTotal[iJob] = tTotalCur;
+		logPrintf("Calculation completed in %.2lf s.\nDone!\n", tTotalCur);
+		printAndResetStopWatches(); //report timings of this job alone
+		//Restore batch state:
+		if(jobDir.length() && chdir(cwd.c_str())) die_alone("Could not change back to directory '%s'.\n", cwd.c_str());
+		mpiWorld = batchWorld;
+		mpiGroup = batchGroup;
+		mpiGroupHead = batchGroupHead;
+		logRedirect(fpBatch);
+		if(fpJob != nullLog) fclose(fpJob);
+		logPrintf("Calculation %d ('%s') completed in %.2lf s (setup %.2lf s); log in '%s'.\n",
+			iJob+1, job.inFile.c_str(), tTotal[iJob], tSetup[iJob], job.outFile.c_str());
+		logFlush();
+		if(killFlag) break;
+	}
+	delete jobGroupHead;
+	delete jobGroup;
+	
+	//Summarize:
+	mpiWorld->allReduceData(tSetup, MPIUtil::ReduceSum);
+	mpiWorld->allReduceData(tTotal, MPIUtil::ReduceSum);
+	double secSaved[2] = { RadialFunctionR::transformSecSaved, GridInfo::planSecSaved };
+	size_t nReused[2] = { RadialFunctionR::nTransformsReused, GridInfo::nPlansReused };
+	mpiGroupHead->allReduce(secSaved, 2, MPIUtil::ReduceSum); //sum over groups (identical within each group)
+	mpiGroupHead->allReduce(nReused, 2, MPIUtil::ReduceSum);
+	logPrintf("\nBatch summary:\n");
+	logPrintf("%6s %12s %12s  %s\n", "#Job", "Setup[s]", "Total[s]", "Input");
+	double tSetupTot = 0., tTotalTot = 0.;
+	for(int iJob=0; iJob<nJobs; iJob++)
+	{	logPrintf("%6d %12.2lf %12.2lf  %s\n", iJob+1, tSetup[iJob], tTotal[iJob], jobs[iJob].inFile.c_str());
+		tSetupTot += tSetup[iJob];
+		tTotalTot += tTotal[iJob];
+	}
+	logPrintf("Total setup time %.2lf s of %.2lf s in all calculations.\n", tSetupTot, tTotalTot);
+	logPrintf("Setup time saved by reusing %lu pseudopotential transforms: %.2lf s\n", nReused[0], secSaved[0]);
+	logPrintf("Setup time saved by reusing %lu FFT plans: %.2lf s\n", nReused[1], secSaved[1]);
+	
+	finalizeSystem();
+	return 0;
+}
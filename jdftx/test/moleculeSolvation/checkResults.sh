@@ -1,7 +1,14 @@
 #!/bin/bash
 
-echo "3"  #number of checks
+echo "5"  #number of checks
 
 awk '/IonicMinimize: Iter/ { E = $5 } END { print E, "-17.2681 0.0001 Vacuum energy [Eh]" }' vacuum.out
 awk '/IonicMinimize: Iter/ { E = $5 } END { print E, "-17.2793 0.0001 LinearPCM energy [Eh]" }' LinearPCM.out
 awk '/IonicMinimize: Iter/ { E = $5 } END { print E, "-17.2807 0.0001 CANDLE energy [Eh]" }' CANDLE.out
+awk '/IonicMinimize: Iter/ { E = $5 } END { print E, "-17.2793 0.0001 Multigrid LinearPCM energy [Eh]" }' LinearPCMmultigrid.out
+
+#Total fluid solver iterations with multigrid relative to the diagonal preconditioner
+#(must be less than half; reported as -1 and failed if either iteration count is missing):
+nIterDiag=$(awk '/Completed after/ { n += $3 } END { print n+0 }' LinearPCM.out)
+nIterMG=$(awk '/Completed after/ { n += $3 } END { print n+0 }' LinearPCMmultigrid.out)
+echo "$nIterMG $nIterDiag" | awk '{ print (($1>0 && $2>0) ? $1/$2 : -1), "0.25 0.24 Multigrid / diagonal fluid iterations (" $1 " / " $2 ")" }'
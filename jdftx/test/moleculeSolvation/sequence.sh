@@ -1,3 +1,3 @@
 #!/bin/bash
-export runs="vacuum LinearPCM CANDLE"
+export runs="vacuum LinearPCMmultigrid LinearPCM CANDLE"
 export nProcs="1"
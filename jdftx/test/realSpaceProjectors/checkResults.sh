@@ -0,0 +1,23 @@
+#!/bin/bash
+
+echo "2"  #number of checks
+
+#Energy and forces with real-space projectors should agree with reciprocal-space ones
+#up to the projector truncation (real-space-projectors tolerance 1e-4 by default):
+EREC=$(awk '/IonicMinimize: Iter/ { E = $5 } END { print E }' reciprocal.out)
+awk -v EREC=$EREC '/IonicMinimize: Iter/ { E = $5 } END { print E-EREC, "0 0.0001 Real-space - reciprocal projector energy [Eh]" }' realSpace.out
+
+awk '
+/# Forces in/ { nAtoms = 0 }
+$1=="force" { nAtoms++; for(i=3; i<=5; i++) F[FILENAME,nAtoms,i] = $i; n[FILENAME] = nAtoms }
+END {
+	dFmax = 0
+	for(atom=1; atom<=n["reciprocal.out"]; atom++)
+		for(i=3; i<=5; i++)
+		{	dF = F["realSpace.out",atom,i] - F["reciprocal.out",atom,i]
+			if(dF<0) dF = -dF
+			if(dF>dFmax) dFmax = dF
+		}
+	if(n["realSpace.out"] != n["reciprocal.out"] || n["reciprocal.out"] != 3) dFmax = 1
+	print dFmax, "0 0.001 Max real-space - reciprocal projector force difference [Eh/a0]"
+}' reciprocal.out realSpace.out
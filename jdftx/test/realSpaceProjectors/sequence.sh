@@ -0,0 +1,3 @@
+#!/bin/bash
+export runs="reciprocal realSpace"
+export nProcs="1"
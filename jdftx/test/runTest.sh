@@ -11,6 +11,7 @@ testRunDir="$testsuiteRunDir/$testName"
 mkdir -p $testRunDir
 cd $testRunDir
 export SRCDIR="$testSrcDir"
+export BUILDDIR="$jdftxBuildDir"
 
 #Run JDFTx on all the runs that belong to this test (don't rerun tests which have succeeded)
 source $testSrcDir/sequence.sh
@@ -21,8 +22,14 @@ else
 fi
 echo "launch=\"$LAUNCH\""
 for run in $runs; do
+	#Runs specified as <executable>:<run> use executables other than jdftx (eg. wannier):
+	executable="jdftx"
+	if [[ "$run" == *:* ]]; then
+		executable="${run%%:*}"
+		run="${run#*:}"
+	fi
 	if [[ ! ( ( -f $run.out ) && ( "$(awk '/End date and time:/ {endLine=NR+1} NR==endLine {print}' $run.out)" == "Done!" ) ) ]]; then
-		$LAUNCH $jdftxBuildDir/jdftx$JDFTX_SUFFIX -i $testSrcDir/$run.in -d -o $run.out
+		$LAUNCH $jdftxBuildDir/$executable$JDFTX_SUFFIX -i $testSrcDir/$run.in -d -o $run.out
 		if [ "$?" -ne "0" ]; then
 			echo "" > results
 			echo "FAILED: error running $run" > summary
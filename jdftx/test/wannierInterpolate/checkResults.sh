@@ -0,0 +1,26 @@
+#!/bin/bash
+
+echo "2"  #number of checks
+
+#Interpolate the Wannier Hamiltonian back to the original k-point mesh:
+$BUILDDIR/wannierInterpolate$JDFTX_SUFFIX -c wannier.mlwfCellMap -H wannier.mlwfH -k 4x4x4 -o wannierInterpolate.out > wannierInterpolate.log
+
+#Compare interpolated eigenvalues to the Kohn-Sham ones for each band (totalE eigenvalues are
+#at the symmetry-reduced k-points, so compare as sets: maximum distance from each value in
+#either list to the nearest value of the same band in the other):
+nBands="4"
+( od -A n -v -t f8 -w8 totalE.eigenvals | awk -v nBands=$nBands '{ print "DFT", (NR-1)%nBands, $1 }'
+  od -A n -v -t f8 -w8 wannierInterpolate.out | awk -v nBands=$nBands '{ i=(NR-1)%(3+nBands); if(i>=3) print "MLWF", i-3, $1 }'
+) | awk '
+	$1=="DFT" { nD[$2]++; D[$2,nD[$2]] = $3 }
+	$1=="MLWF" { nW[$2]++; W[$2,nW[$2]] = $3; nWtot++ }
+	function nearest(x, A, n, b,   i, dMin, d) { dMin = 1e300; for(i=1; i<=n; i++) { d = x-A[b,i]; if(d<0) d=-d; if(d<dMin) dMin=d; }; return dMin; }
+	END {
+		errMax = 0.;
+		for(b in nW)
+		{	for(i=1; i<=nW[b]; i++) { d = nearest(W[b,i], D, nD[b], b); if(d>errMax) errMax=d; }
+			for(i=1; i<=nD[b]; i++) { d = nearest(D[b,i], W, nW[b], b); if(d>errMax) errMax=d; }
+		}
+		print nWtot+0, "256 0 Interpolated eigenvalues (4x4x4 x 4)";
+		print errMax, "0 1e-4 Max interpolation error [Eh]";
+	}'
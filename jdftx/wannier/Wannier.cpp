@@ -25,7 +25,7 @@ Wannier::Wannier() : needAtomicOrbitals(false), localizationMeasure(LM_FiniteDif
 	bStart(0), outerWindow(false), innerWindow(false), nFrozen(0),
 	saveWfns(false), saveWfnsRealSpace(false), saveMomenta(false),
 	z0(0.), zH(0.), zSigma(0.),
-	loadRotations(false), numericalOrbitalsOffset(0.5,0.5,0.5), rSmooth(1.), wrapWS(false), spinMode(SpinAll)
+	loadRotations(false), numericalOrbitalsOffset(0.5,0.5,0.5), rSmooth(1.), wrapWS(false), wfnsCacheMB(0.), spinMode(SpinAll)
 {
 }
 
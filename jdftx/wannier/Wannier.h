@@ -85,6 +85,7 @@ public:
 	vector3<int> phononSup; //!< phonon supercell (process e-ph matrix elements on this supercell if non-zero)
 	double rSmooth; //!< supercell boundary width over which matrix elements are smoothed
 	bool wrapWS; //!< whether to wrap Wannier centers (and phonon atom perturbations) to a Wigner-Seitz cell
+	double wfnsCacheMB; //!< memory budget (in MB per process) for caching transformed wavefunctions while computing overlaps (at least one k-point neighbour set is always cached)
 	
 	enum SpinMode
 	{	SpinUp,
@@ -0,0 +1,166 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <wannier/WannierInterpolator.h>
+#include <core/BlasExtra.h>
+#include <core/Thread.h>
+#include <core/Util.h>
+
+WannierInterpolator::WannierInterpolator(string cellMapFilename, string hamiltonianFilename)
+{
+	//Read cell map (lattice and Cartesian coordinates of each cell):
+	logPrintf("Reading '%s' ... ", cellMapFilename.c_str()); logFlush();
+	FILE* fp = fopen(cellMapFilename.c_str(), "r");
+	if(!fp) die("could not open file for reading.\n");
+	char line[256];
+	while(fgets(line, sizeof(line), fp))
+	{	if(line[0]=='#') continue; //skip comments
+		vector3<int> iCell; vector3<> rCell;
+		if(sscanf(line, "%d %d %d %lg %lg %lg", &iCell[0], &iCell[1], &iCell[2], &rCell[0], &rCell[1], &rCell[2]) == 6)
+		{	iCells.push_back(iCell);
+			rCells.push_back(rCell);
+		}
+	}
+	fclose(fp);
+	nCells = iCells.size();
+	if(!nCells) die("no cells found in cell map.\n");
+	logPrintf("done. Read %d cells.\n", nCells);
+	
+	//Read Hamiltonian:
+	Hcells = loadCellMatrices(hamiltonianFilename, 1, nCenters);
+	logPrintf("Hamiltonian has %d Wannier centers.\n", nCenters);
+}
+
+void WannierInterpolator::addOperator(string filename, int nMatrices, complex prefactor)
+{	int nCentersOp = 0;
+	opCells.push_back(loadCellMatrices(filename, nMatrices, nCentersOp));
+	if(nCentersOp != nCenters)
+		die("Operator in '%s' has %d centers, but Hamiltonian has %d.\n", filename.c_str(), nCentersOp, nCenters);
+	opNmatrices.push_back(nMatrices);
+	opPrefactors.push_back(prefactor);
+}
+
+int WannierInterpolator::nOperatorMatrices() const
+{	int nMatricesTot = 0;
+	for(int nMatrices: opNmatrices) nMatricesTot += nMatrices;
+	return nMatricesTot;
+}
+
+matrix WannierInterpolator::loadCellMatrices(string fname, int nMatrices, int& nCentersOut) const
+{	logPrintf("Reading '%s' ... ", fname.c_str()); logFlush();
+	off_t fsize = fileSize(fname.c_str());
+	if(fsize <= 0) die("file not found or empty.\n");
+	//Determine whether file contains real or complex matrices, and the number of centers:
+	//(both cannot be consistent simultaneously since sqrt(2) is irrational)
+	size_t nElemPerMatrix = fsize / (sizeof(double) * nCells * nMatrices);
+	if(nElemPerMatrix * sizeof(double) * nCells * nMatrices != size_t(fsize))
+		die("file size is not a multiple of the expected matrix dimensions.\n");
+	bool realPartOnly = true;
+	nCentersOut = int(round(sqrt(nElemPerMatrix)));
+	if(size_t(nCentersOut*nCentersOut) != nElemPerMatrix)
+	{	realPartOnly = false;
+		nCentersOut = int(round(sqrt(nElemPerMatrix/2)));
+		if(size_t(2*nCentersOut*nCentersOut) != nElemPerMatrix)
+			die("file size is inconsistent with square matrices.\n");
+	}
+	//Read on head and broadcast:
+	matrix M(nCentersOut*nCentersOut*nMatrices, nCells);
+	if(mpiWorld->isHead())
+	{	FILE* fp = fopen(fname.c_str(), "rb");
+		if(!fp) die_alone("could not open file for reading.\n");
+		if(realPartOnly) M.read_real(fp);
+		else M.read(fp);
+		fclose(fp);
+	}
+	mpiWorld->bcastData(M);
+	logPrintf("done.\n"); logFlush();
+	return M;
+}
+
+void WannierInterpolator::compute(const std::vector<vector3<>>& k, Result& result, bool needVelocity, bool needU) const
+{	static StopWatch watch("WannierInterpolator::compute"); watch.start();
+	int nk = k.size();
+	//Fourier transform phases (nCells x nk):
+	matrix phase(nCells, nk);
+	complex* phaseData = phase.data();
+	for(int ik=0; ik<nk; ik++)
+		for(int iCell=0; iCell<nCells; iCell++)
+			phaseData[phase.index(iCell,ik)] = cis(2*M_PI*dot(k[ik], iCells[iCell]));
+	//Interpolate all k in batch with one matrix product over cells for each operator:
+	matrix Hk = Hcells * phase; //nCenters^2 x nk
+	matrix HkDeriv[3]; //Cartesian derivatives of Hk
+	if(needVelocity)
+	{	for(int iDir=0; iDir<3; iDir++)
+		{	matrix phaseDir = phase;
+			complex* phaseDirData = phaseDir.data();
+			for(int ik=0; ik<nk; ik++)
+				for(int iCell=0; iCell<nCells; iCell++)
+					phaseDirData[phaseDir.index(iCell,ik)] *= complex(0., rCells[iCell][iDir]);
+			HkDeriv[iDir] = Hcells * phaseDir;
+			HkDeriv[iDir].data(); //ensure on CPU before threads
+		}
+	}
+	std::vector<matrix> opK;
+	for(size_t iOp=0; iOp<opCells.size(); iOp++)
+	{	opK.push_back(opPrefactors[iOp] * (opCells[iOp] * phase));
+		opK.back().data(); //ensure on CPU before threads
+	}
+	phase = 0;
+	Hk.data(); //ensure on CPU before threads
+	//Diagonalize and transform to eigen-basis (threaded over k):
+	result.E.resize(nk);
+	result.U.resize(needU ? nk : 0);
+	result.v.resize(needVelocity ? nk : 0);
+	result.ops.resize(nk);
+	threadLaunch(isGpuEnabled()?1:0, diagonalize_thread, nk, this, &Hk, HkDeriv, &opK, &result, needVelocity, needU);
+	watch.stop();
+}
+
+//Extract nCenters x nCenters matrix at specified row offset from column ik of M
+inline matrix extractMatrix(const matrix& M, int ik, int offset, int nCenters)
+{	matrix result(nCenters, nCenters);
+	eblas_copy(result.data(), M.data()+M.index(offset,ik), nCenters*nCenters);
+	return result;
+}
+
+void WannierInterpolator::diagonalize_thread(size_t ikStart, size_t ikStop, const WannierInterpolator* wi,
+	const matrix* Hk, const matrix* HkDeriv, const std::vector<matrix>* opK, Result* result, bool needVelocity, bool needU)
+{	int nCenters = wi->nCenters;
+	int nSq = nCenters*nCenters;
+	for(size_t ik=ikStart; ik<ikStop; ik++)
+	{	matrix U; diagMatrix& E = result->E[ik];
+		extractMatrix(*Hk, ik, 0, nCenters).diagonalize(U, E);
+		//Band velocities (Hellmann-Feynman):
+		if(needVelocity)
+		{	std::vector<vector3<>>& v = result->v[ik];
+			v.assign(nCenters, vector3<>());
+			for(int iDir=0; iDir<3; iDir++)
+			{	diagMatrix vDir = diag(dagger(U) * extractMatrix(HkDeriv[iDir], ik, 0, nCenters) * U);
+				for(int b=0; b<nCenters; b++) v[b][iDir] = vDir[b];
+			}
+		}
+		//Band-diagonal operator expectation values:
+		std::vector<diagMatrix>& ops = result->ops[ik];
+		ops.clear();
+		for(size_t iOp=0; iOp<opK->size(); iOp++)
+			for(int iMatrix=0; iMatrix<wi->opNmatrices[iOp]; iMatrix++)
+				ops.push_back(diag(dagger(U) * extractMatrix(opK->at(iOp), ik, iMatrix*nSq, nCenters) * U));
+		if(needU) result->U[ik] = U;
+	}
+}
@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#ifndef JDFTX_WANNIER_WANNIERINTERPOLATOR_H
+#define JDFTX_WANNIER_WANNIERINTERPOLATOR_H
+
+#include <core/matrix.h>
+#include <vector>
+
+//! @addtogroup Output
+//! @{
+
+//! Interpolate Wannierized matrices output by wannier (cell-mapped real-space matrices such
+//! as mlwfH, mlwfP, mlwfS or mlwfImSigma_ee, along with mlwfCellMap) to arbitrary k-points.
+//! Each batch of k-points is handled with one matrix product over cells per operator,
+//! followed by threaded diagonalization of the interpolated Hamiltonians.
+class WannierInterpolator
+{
+public:
+	//! Load cell map and Hamiltonian (the number of Wannier centers is determined from the file sizes)
+	WannierInterpolator(string cellMapFilename, string hamiltonianFilename);
+	
+	//! Add an operator, whose band-diagonal expectation values will be evaluated by compute().
+	//! Each cell contains nMatrices (eg. 3 for mlwfP or mlwfS) nCenters x nCenters matrices,
+	//! and the interpolated values are multiplied by prefactor (eg. -i for mlwfP, whose output drops the -i).
+	void addOperator(string filename, int nMatrices, complex prefactor=1.);
+	
+	int nCenters; //!< number of Wannier centers (bands in output)
+	int nCells; //!< number of unit cells in the cell map
+	
+	//! Results of interpolation for a batch of k-points
+	struct Result
+	{	std::vector<diagMatrix> E; //!< energy eigenvalues for each k
+		std::vector<matrix> U; //!< eigenvectors for each k (only if requested)
+		std::vector<std::vector<vector3<>>> v; //!< Cartesian band velocities dE/dk for each k and band (only if requested)
+		std::vector<std::vector<diagMatrix>> ops; //!< for each k, band-diagonal values of each added operator (nMatrices entries per operator)
+	};
+	
+	//! Interpolate to k-points (in reciprocal lattice coordinates) in batch
+	void compute(const std::vector<vector3<>>& k, Result& result, bool needVelocity, bool needU=false) const;
+	
+	//! Number of matrices per cell, summed over all added operators
+	int nOperatorMatrices() const;
+	
+private:
+	std::vector<vector3<int>> iCells; //!< cells in lattice coordinates
+	std::vector<vector3<>> rCells; //!< cells in Cartesian coordinates
+	matrix Hcells; //!< Hamiltonian (nCenters^2 x nCells)
+	std::vector<matrix> opCells; //!< additional operators ((nCenters^2 * nMatrices) x nCells)
+	std::vector<int> opNmatrices; //!< number of matrices per cell for each operator
+	std::vector<complex> opPrefactors; //!< prefactors for each operator
+	
+	matrix loadCellMatrices(string fname, int nMatrices, int& nCentersOut) const; //!< load real or complex cell-mapped matrices
+	
+	static void diagonalize_thread(size_t ikStart, size_t ikStop, const WannierInterpolator* wi,
+		const matrix* Hk, const matrix* HkDeriv, const std::vector<matrix>* opK, Result* result, bool needVelocity, bool needU);
+};
+
+//! @}
+#endif // JDFTX_WANNIER_WANNIERINTERPOLATOR_H
@@ -336,8 +336,39 @@ ColumnBundle WannierMinimizer::trialWfns(const WannierMinimizer::Kpoint& kpoint)
 matrix WannierMinimizer::overlap(const ColumnBundle& C1, const ColumnBundle& C2, const std::vector<matrix>* VdagC1ptr, const std::vector<matrix>* VdagC2ptr) const
 {	static StopWatch watch("WannierMinimizer::overlap"); watch.start();
 	const GridInfo& gInfo = *(C1.basis->gInfo);
-	const IonInfo& iInfo = *(C1.basis->iInfo);
 	matrix ret = gInfo.detR * (C1 ^ C2);
+	augmentOverlap(ret, C1, C2, VdagC1ptr, VdagC2ptr);
+	watch.stop();
+	return ret;
+}
+
+std::vector<matrix> WannierMinimizer::overlap(const ColumnBundle& C1, const std::vector<const ColumnBundle*>& C2arr,
+	const std::vector<matrix>* VdagC1ptr, const std::vector<const std::vector<matrix>*>& VdagC2arr) const
+{	static StopWatch watch("WannierMinimizer::overlapBatched"); watch.start();
+	const GridInfo& gInfo = *(C1.basis->gInfo);
+	std::vector<matrix> ret(C2arr.size());
+	if(!C2arr.size()) { watch.stop(); return ret; }
+	//Stack C2arr into a single ColumnBundle (assumes all in the same basis):
+	int nCols2 = C2arr[0]->nCols();
+	ColumnBundle C2all(nCols2*C2arr.size(), C1.colLength(), C1.basis, C1.qnum, isGpuEnabled());
+	for(size_t i=0; i<C2arr.size(); i++)
+	{	assert(C2arr[i]->nCols() == nCols2);
+		C2all.setSub(i*nCols2, *C2arr[i]);
+	}
+	//Plane-wave part with one matrix product:
+	matrix retAll = gInfo.detR * (C1 ^ C2all);
+	C2all.free();
+	for(size_t i=0; i<C2arr.size(); i++)
+	{	ret[i] = retAll(0,C1.nCols(), i*nCols2,(i+1)*nCols2);
+		augmentOverlap(ret[i], C1, *C2arr[i], VdagC1ptr, VdagC1ptr ? VdagC2arr[i] : 0);
+	}
+	watch.stop();
+	return ret;
+}
+
+void WannierMinimizer::augmentOverlap(matrix& ret, const ColumnBundle& C1, const ColumnBundle& C2, const std::vector<matrix>* VdagC1ptr, const std::vector<matrix>* VdagC2ptr) const
+{	const GridInfo& gInfo = *(C1.basis->gInfo);
+	const IonInfo& iInfo = *(C1.basis->iInfo);
 	//k-point difference:
 	vector3<> dkVec = C2.qnum->k - C1.qnum->k;
 	double dk = sqrt(gInfo.GGT.metric_length_squared(dkVec));
@@ -382,6 +413,4 @@ matrix WannierMinimizer::overlap(const ColumnBundle& C1, const ColumnBundle& C2,
 		matrix VdagC2 = VdagC2ptr ? VdagC2ptr->at(iSp) : (*sp.getV(C2)) ^ C2;
 		ret += dagger(VdagC1) * (tiledBlockMatrix(Qk, sp.atpos.size(), &phaseArr) * VdagC2);
 	}
-	watch.stop();
-	return ret;
 }
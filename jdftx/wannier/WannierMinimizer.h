@@ -161,6 +161,14 @@ protected:
 	//! If provided, use the cached projections instead of recomputing them.
 	matrix overlap(const ColumnBundle& C1, const ColumnBundle& C2, const std::vector<matrix>* VdagC1ptr=0, const std::vector<matrix>* VdagC2ptr=0) const;
 	
+	//! Overlaps of C1 with several ColumnBundles (of different k-points) using a single matrix product for the plane-wave part.
+	//! Augmentation and cached projections are handled as in overlap(); VdagC2arr may be empty if VdagC1ptr is null.
+	std::vector<matrix> overlap(const ColumnBundle& C1, const std::vector<const ColumnBundle*>& C2arr,
+		const std::vector<matrix>* VdagC1ptr=0, const std::vector<const std::vector<matrix>*>& VdagC2arr=std::vector<const std::vector<matrix>*>()) const;
+	
+	//! Add ultrasoft augmentation contributions to overlap ret between C1 and C2 (see overlap)
+	void augmentOverlap(matrix& ret, const ColumnBundle& C1, const ColumnBundle& C2, const std::vector<matrix>* VdagC1ptr, const std::vector<matrix>* VdagC2ptr) const;
+	
 	//! Wannierize and dump a Bloch-space matrix to file, optionally zeroing out the real parts
 	void dumpWannierized(const matrix& Htilde, const std::map<vector3<int>,matrix>& iCellMap,
 		const matrix& phase, int nMatrices, string varName, bool realPartOnly, int iSpin) const;
@@ -18,6 +18,7 @@ along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
 -------------------------------------------------------------------*/
 
 #include <wannier/WannierMinimizerFD.h>
+#include <list>
 
 //Find a finite difference formula given a list of relative neighbour positions (in cartesian coords)
 //[Appendix B of Phys Rev B 56, 12847]
@@ -203,6 +204,37 @@ void WannierMinimizerFD::initialize(int iSpin)
 		return; //read overlaps successfully rom file, so no need to recalculate below
 	}
 	
+	//Cache of wavefunctions in the common basis (LRU eviction), since many edges share the same neighbour:
+	struct CacheEntry
+	{	ColumnBundle C;
+		std::vector<matrix> VdagC;
+		std::list<Kpoint>::iterator lruPos;
+	};
+	std::map<Kpoint,CacheEntry> wfnsCache;
+	std::list<Kpoint> lru; //cached k-points, most recently used first
+	double cacheBytesPerEntry = nBands * basis.nbasis*nSpinor * sizeof(complex);
+	size_t nCacheMax = std::max(edges[0].size()+1, size_t(wannier.wfnsCacheMB*1024*1024/cacheBytesPerEntry)); //must hold all wavefunctions for one k
+	size_t nCacheHits = 0, nCacheMisses = 0;
+	auto getWfnsCached = [&](const Kpoint& kpoint) -> const CacheEntry&
+	{	auto iter = wfnsCache.find(kpoint);
+		if(iter != wfnsCache.end())
+		{	lru.splice(lru.begin(), lru, iter->second.lruPos); //mark most recently used
+			nCacheHits++;
+			return iter->second;
+		}
+		nCacheMisses++;
+		if(wfnsCache.size() >= nCacheMax) //evict least recently used
+		{	wfnsCache.erase(lru.back());
+			lru.pop_back();
+		}
+		iter = wfnsCache.insert(std::make_pair(kpoint, CacheEntry())).first;
+		lru.push_front(kpoint);
+		CacheEntry& entry = iter->second;
+		entry.C = getWfns(iter->first, iSpin, &entry.VdagC); //note that map key persists for lifetime of C
+		entry.lruPos = lru.begin();
+		return entry;
+	};
+	
 	//Compute the overlap matrices for current spin:
 	for(int jProcess=0; jProcess<mpiWorld->nProcesses(); jProcess++)
 	{	//Send/recv wavefunctions to other processes:
@@ -232,35 +264,67 @@ void WannierMinimizerFD::initialize(int iSpin)
 		}
 		
 		for(size_t ik=0; ik<kMesh.size(); ik++) if(isMine_q(ik,iSpin))
-		{	KmeshEntry& ke = kMesh[ik];
-			std::vector<matrix> VdagCi, VdagCj;
-			ColumnBundle Ci = getWfns(ke.point, iSpin, &VdagCi); //Bloch functions at ik
-			//Overlap with neighbours:
+		{	//Collect neighbours whose source wavefunctions are currently available:
+			std::vector<Edge*> edgesCur;
+			std::vector<const ColumnBundle*> Cj;
+			std::vector<const std::vector<matrix>*> VdagCj;
 			for(Edge& edge: edges[ik])
 				if(whose_q(edge.ik,iSpin)==jProcess)
-					edge.M0 = overlap(Ci, getWfns(edge.point, iSpin, &VdagCj), &VdagCi, &VdagCj);
+				{	const CacheEntry& entry = getWfnsCached(edge.point);
+					edgesCur.push_back(&edge);
+					Cj.push_back(&entry.C);
+					VdagCj.push_back(&entry.VdagC);
+				}
+			if(!edgesCur.size()) continue;
+			//Overlap with all these neighbours together:
+			const CacheEntry& entryI = getWfnsCached(kMesh[ik].point); //Bloch functions at ik
+			std::vector<matrix> M0 = overlap(entryI.C, Cj, &entryI.VdagC, VdagCj);
+			for(size_t iEdge=0; iEdge<edgesCur.size(); iEdge++)
+				edgesCur[iEdge]->M0 = M0[iEdge];
 		}
 	}
 	Cother.clear();
+	wfnsCache.clear(); lru.clear();
+	mpiWorld->allReduce(nCacheHits, MPIUtil::ReduceSum);
+	mpiWorld->allReduce(nCacheMisses, MPIUtil::ReduceSum);
+	logPrintf("Wavefunction cache for overlaps: %lu hits, %lu misses (capacity %lu per process).\n",
+		nCacheHits, nCacheMisses, nCacheMax);
 	
-	//Broadcast and dump the overlap matrices:
-	FILE* fp = 0;
-	if(mpiWorld->isHead())
-	{	logPrintf("Dumping '%s' ... ", fname.c_str()); logFlush();
-		fp = fopen(fname.c_str(), "w");
-		if(!fp) die_alone("failed to open file for writing.\n");
-	}
+	//Move the overlap matrices from the process owning the state to the process owning the k-point:
+	std::vector<MPIUtil::Request> requests;
 	for(size_t ik=0; ik<edges.size(); ik++)
-		for(Edge& edge: edges[ik])
-		{	if(!isMine_q(ik,iSpin)) edge.M0 = zeroes(nBands, nBands);
-			mpiWorld->bcastData(edge.M0, whose_q(ik,iSpin));
-			if(mpiWorld->isHead()) edge.M0.write(fp);
-			if(!isMine(ik)) edge.M0 = matrix(); //not needed any more on this process
+	{	int src = whose_q(ik,iSpin), dest = whose(ik);
+		if(src == dest) continue;
+		for(size_t iEdge=0; iEdge<edges[ik].size(); iEdge++)
+		{	Edge& edge = edges[ik][iEdge];
+			if(src == mpiWorld->iProcess())
+			{	requests.push_back(MPIUtil::Request());
+				mpiWorld->sendData(edge.M0, dest, iEdge, &requests.back());
+			}
+			if(dest == mpiWorld->iProcess())
+			{	edge.M0 = zeroes(nBands, nBands);
+				requests.push_back(MPIUtil::Request());
+				mpiWorld->recvData(edge.M0, src, iEdge, &requests.back());
+			}
 		}
-	if(mpiWorld->isHead())
-	{	fclose(fp);
-		logPrintf("done.\n"); logFlush();
 	}
+	mpiWorld->waitAll(requests);
+	for(size_t ik=0; ik<edges.size(); ik++)
+		if(!isMine(ik))
+			for(Edge& edge: edges[ik])
+				edge.M0 = matrix(); //not needed any more on this process
+	
+	//Dump the overlap matrices (each process writes its own k-points):
+	logPrintf("Dumping '%s' ... ", fname.c_str()); logFlush();
+	size_t sizePerK = edges[0].size() * nBands*nBands * sizeof(complex);
+	MPIUtil::File fp;
+	mpiWorld->fopenWrite(fp, fname.c_str());
+	mpiWorld->fseek(fp, ikStart*sizePerK, SEEK_SET);
+	for(size_t ik=ikStart; ik<ikStop; ik++)
+		for(Edge& edge: edges[ik])
+			mpiWorld->fwriteData(edge.M0, fp);
+	mpiWorld->fclose(fp);
+	logPrintf("done.\n"); logFlush();
 }
 
 
@@ -40,6 +40,7 @@ enum WannierMember
 	WM_phononSup,
 	WM_rSmooth,
 	WM_wrapWignerSeitz,
+	WM_wfnsCacheMB,
 	WM_spinMode,
 	WM_delim
 };
@@ -63,6 +64,7 @@ EnumStringMap<WannierMember> wannierMemberMap
 	WM_phononSup, "phononSupercell",
 	WM_rSmooth, "rSmooth",
 	WM_wrapWignerSeitz, "wrapWignerSeitz",
+	WM_wfnsCacheMB, "wfnsCacheMB",
 	WM_spinMode, "spinMode"
 );
 
@@ -164,6 +166,12 @@ struct CommandWannier : public Command
 			"   so as to minimize the number of cells in the Wannier-basis output.  As a consequence,\n"
 			"   however, minimized Wannier centers may differ from the guesses by some lattice vector.\n"
 			"   Default: no.\n"
+			"\n+ wfnsCacheMB <size>\n\n"
+			"   Memory budget in MB (per process) for caching symmetry-transformed wavefunctions\n"
+			"   of neighbouring k-points while computing the initial overlaps (mlwfM0) for the\n"
+			"   FiniteDifference localizationMeasure. The cache always holds at least the\n"
+			"   wavefunctions of one k-point and its neighbours, which is all it holds by default.\n"
+			"   Default: 0.\n"
 			"\n+ spinMode" + spinModeMap.optionList() + "\n\n"
 			"   If Up or Dn, only generate Wannier functions for that spin channel, allowing\n"
 			"   different input files for each channel (independent centers, windows etc.).\n"
@@ -247,6 +255,10 @@ struct CommandWannier : public Command
 				case WM_wrapWignerSeitz:
 					pl.get(wannier.wrapWS, false, boolMap, "wrapWignerSeitz", true);
 					break;
+				case WM_wfnsCacheMB:
+					pl.get(wannier.wfnsCacheMB, 0., "wfnsCacheMB", true);
+					if(wannier.wfnsCacheMB < 0.) throw string("<wfnsCacheMB> must be non-negative");
+					break;
 				case WM_spinMode:
 					pl.get(wannier.spinMode, Wannier::SpinAll,  spinModeMap, "spinMode", true);
 					if(e.eInfo.spinType!=SpinZ && wannier.spinMode!=Wannier::SpinAll)
@@ -290,6 +302,7 @@ struct CommandWannier : public Command
 			logPrintf(" \\\n\tphononSupercell %d %d %d", wannier.phononSup[0], wannier.phononSup[1], wannier.phononSup[2]);
 		logPrintf(" \\\n\trSmooth %lg", wannier.rSmooth);
 		logPrintf(" \\\n\twrapWignerSeitz %s", boolMap.getString(wannier.wrapWS));
+		logPrintf(" \\\n\twfnsCacheMB %lg", wannier.wfnsCacheMB);
 		logPrintf(" \\\n\tspinMode %s", spinModeMap.getString(wannier.spinMode));
 	}
 }
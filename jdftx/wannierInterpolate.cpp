@@ -0,0 +1,173 @@
+/*-------------------------------------------------------------------
+Copyright 2024 Ravishankar Sundararaman
+
+This file is part of JDFTx.
+
+JDFTx is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+JDFTx is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with JDFTx.  If not, see <http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------*/
+
+#include <wannier/WannierInterpolator.h>
+#include <core/MPIUtil.h>
+#include <core/Util.h>
+#include <getopt.h>
+
+void printUsage(const char* name)
+{	logPrintf(
+		"Usage: %s [options]\n"
+		"\n"
+		"Interpolate Wannierized outputs of wannier to k-points in batches, writing\n"
+		"band energies, velocities and band-diagonal operator values to a binary file.\n"
+		"\n"
+		"Options:\n"
+		"\t-c, --cellMap <file>      mlwfCellMap file (required)\n"
+		"\t-H, --hamiltonian <file>  mlwfH file (required)\n"
+		"\t-P, --momentum <file>     mlwfP file (band-diagonal momentum matrix elements)\n"
+		"\t-S, --spin <file>         mlwfS file (spin expectation values)\n"
+		"\t-I, --ImSigma <file>      mlwfImSigma_ee file (e-e linewidths)\n"
+		"\t-k, --kMesh <N0>x<N1>x<N2> uniform Gamma-centered k-mesh to interpolate to\n"
+		"\t-f, --kFile <file>        text file with k-points (reciprocal lattice coordinates, one per line)\n"
+		"\t-v, --velocity            output band velocities from Hamiltonian derivatives\n"
+		"\t-b, --batchSize <n>       number of k-points per batch (default: 4096)\n"
+		"\t-o, --output <file>       output file (default: wannierInterpolate.out)\n"
+		"\t-h, --help                print this message\n"
+		"\n", name);
+}
+
+int main(int argc, char** argv)
+{	initSystem(argc, argv);
+	
+	//Parse command line:
+	string cellMapFile, Hfile, Pfile, Sfile, ImSigmaFile, kFile, outFile("wannierInterpolate.out");
+	vector3<int> kMesh; bool needVelocity = false; int batchSize = 4096;
+	option long_options[] =
+		{	{"cellMap", required_argument, 0, 'c'},
+			{"hamiltonian", required_argument, 0, 'H'},
+			{"momentum", required_argument, 0, 'P'},
+			{"spin", required_argument, 0, 'S'},
+			{"ImSigma", required_argument, 0, 'I'},
+			{"kMesh", required_argument, 0, 'k'},
+			{"kFile", required_argument, 0, 'f'},
+			{"velocity", no_argument, 0, 'v'},
+			{"batchSize", required_argument, 0, 'b'},
+			{"output", required_argument, 0, 'o'},
+			{"help", no_argument, 0, 'h'},
+			{0, 0, 0, 0}
+		};
+	while(true)
+	{	int c = getopt_long(argc, argv, "c:H:P:S:I:k:f:vb:o:h", long_options, 0);
+		if(c == -1) break; //end of options
+		switch(c)
+		{	case 'c': cellMapFile.assign(optarg); break;
+			case 'H': Hfile.assign(optarg); break;
+			case 'P': Pfile.assign(optarg); break;
+			case 'S': Sfile.assign(optarg); break;
+			case 'I': ImSigmaFile.assign(optarg); break;
+			case 'k':
+				if(sscanf(optarg, "%dx%dx%d", &kMesh[0], &kMesh[1], &kMesh[2]) != 3
+					|| kMesh[0]<=0 || kMesh[1]<=0 || kMesh[2]<=0)
+					die("Could not parse k-mesh '%s': expected <N0>x<N1>x<N2> with positive entries.\n", optarg);
+				break;
+			case 'f': kFile.assign(optarg); break;
+			case 'v': needVelocity = true; break;
+			case 'b':
+				if(sscanf(optarg, "%d", &batchSize) != 1 || batchSize <= 0)
+					die("Could not parse batch size '%s' as a positive integer.\n", optarg);
+				break;
+			case 'o': outFile.assign(optarg); break;
+			case 'h': printUsage(argv[0]); finalizeSystem(); return 0;
+			default: printUsage(argv[0]); finalizeSystem(false); return 1;
+		}
+	}
+	if(!cellMapFile.length() || !Hfile.length())
+		die("Both --cellMap and --hamiltonian must be specified (run with -h for usage).\n");
+	if((kMesh[0]>0) == (kFile.length()>0))
+		die("Exactly one of --kMesh or --kFile must be specified (run with -h for usage).\n");
+	
+	//Load Wannierized matrices:
+	WannierInterpolator wi(cellMapFile, Hfile);
+	if(Pfile.length()) wi.addOperator(Pfile, 3, complex(0,-1)); //mlwfP stores i*P so that it is real for real wavefunctions
+	if(Sfile.length()) wi.addOperator(Sfile, 3);
+	if(ImSigmaFile.length()) wi.addOperator(ImSigmaFile, 1);
+	
+	//Get list of k-points:
+	std::vector<vector3<>> kAll;
+	if(kFile.length())
+	{	FILE* fp = fopen(kFile.c_str(), "r");
+		if(!fp) die("Could not open '%s' for reading.\n", kFile.c_str());
+		char line[256];
+		while(fgets(line, sizeof(line), fp))
+		{	if(line[0]=='#') continue;
+			vector3<> k;
+			if(sscanf(line, "%lg %lg %lg", &k[0], &k[1], &k[2]) == 3)
+				kAll.push_back(k);
+		}
+		fclose(fp);
+	}
+	size_t nkTot = kFile.length() ? kAll.size() : size_t(kMesh[0])*kMesh[1]*kMesh[2];
+	if(!nkTot) die("No k-points to interpolate to.\n");
+	auto getK = [&](size_t ik)
+	{	if(kFile.length()) return kAll[ik];
+		vector3<> k; size_t iRem = ik;
+		for(int iDir=2; iDir>=0; iDir--)
+		{	k[iDir] = double(iRem % kMesh[iDir]) / kMesh[iDir];
+			iRem /= kMesh[iDir];
+		}
+		return k;
+	};
+	
+	//Output layout:
+	int nBands = wi.nCenters;
+	int nOpMatrices = wi.nOperatorMatrices();
+	size_t recordLen = 3 + nBands * (1 + (needVelocity ? 3 : 0) + nOpMatrices); //in doubles
+	logPrintf("\nOutput '%s' will contain %lu records of %lu doubles each, with:\n", outFile.c_str(), nkTot, recordLen);
+	logPrintf("\tk-point (3, reciprocal lattice coordinates)\n");
+	logPrintf("\tenergies (%d)\n", nBands);
+	if(needVelocity) logPrintf("\tvelocities (3 x %d, Cartesian, band-major)\n", nBands);
+	if(nOpMatrices) logPrintf("\toperator diagonals (%d x %d, in order: %s%s%s)\n", nOpMatrices, nBands,
+		Pfile.length() ? "P(3) " : "", Sfile.length() ? "S(3) " : "", ImSigmaFile.length() ? "ImSigma(1)" : "");
+	
+	//Interpolate in batches, each process handling a contiguous range of k-points:
+	TaskDivision kDivision(nkTot, mpiWorld);
+	MPIUtil::File fp; mpiWorld->fopenWrite(fp, outFile.c_str());
+	mpiWorld->fseek(fp, kDivision.start() * recordLen * sizeof(double), SEEK_SET);
+	logPrintf("Interpolating to %lu k-points in batches of %d ... ", nkTot, batchSize); logFlush();
+	WannierInterpolator::Result result;
+	std::vector<double> buf;
+	for(size_t ikStart=kDivision.start(); ikStart<kDivision.stop(); ikStart+=batchSize)
+	{	size_t ikStop = std::min(ikStart+batchSize, kDivision.stop());
+		std::vector<vector3<>> k;
+		for(size_t ik=ikStart; ik<ikStop; ik++) k.push_back(getK(ik));
+		wi.compute(k, result, needVelocity);
+		//Pack records and write contiguously:
+		buf.resize(k.size() * recordLen);
+		double* bufPtr = buf.data();
+		for(size_t ik=0; ik<k.size(); ik++)
+		{	for(int iDir=0; iDir<3; iDir++) *(bufPtr++) = k[ik][iDir];
+			for(int b=0; b<nBands; b++) *(bufPtr++) = result.E[ik][b];
+			if(needVelocity)
+				for(int b=0; b<nBands; b++)
+					for(int iDir=0; iDir<3; iDir++)
+						*(bufPtr++) = result.v[ik][b][iDir];
+			for(const diagMatrix& op: result.ops[ik])
+				for(int b=0; b<nBands; b++)
+					*(bufPtr++) = op[b];
+		}
+		mpiWorld->fwrite(buf.data(), sizeof(double), buf.size(), fp);
+	}
+	mpiWorld->fclose(fp);
+	logPrintf("done.\n");
+	
+	finalizeSystem();
+	return 0;
+}